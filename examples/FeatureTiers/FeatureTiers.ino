@@ -0,0 +1,125 @@
+/*!
+ * @file FeatureTiers.ino
+ * 
+ * @brief Feature tier example for DYP-R01CW laser ranging sensor
+ * 
+ * This sketch uses every feature of the library's feature tier it is built
+ * with (see DYP_R01CW_Config.h):
+ * 
+ * - DYP_R01CW_TIER_MINIMAL (0): blocking readDistance()
+ * - DYP_R01CW_TIER_STANDARD (1, default): + retries, filter pipeline
+ * - DYP_R01CW_TIER_FULL (2): + statistics, non-blocking measurement
+ * 
+ * Select the tier for the sketch and the library, e.g. with arduino-cli:
+ *   arduino-cli compile --build-property "compiler.cpp.extra_flags=-DDYP_R01CW_TIER=0" ...
+ * 
+ * The CI size report builds this sketch in all tiers.
+ * 
+ * @section hardware Hardware Requirements
+ * 
+ * - Arduino board (Uno, Mega, ESP32, etc.)
+ * - DYP-R01CW / DFRobot SEN0590 laser ranging sensor
+ * - I2C connection:
+ *   - SDA to Arduino SDA pin
+ *   - SCL to Arduino SCL pin
+ *   - VCC to supply voltage (3.3...5.0V)
+ *   - GND to GND
+ * 
+ * @section author Author
+ * 
+ * Written by Matthias Prinke
+ * 
+ * @section license License
+ * 
+ * MIT License
+ */
+
+#include <Wire.h>
+#include <DYP_R01CW.h>
+#include <DYP_R01CW_Processing.h>
+
+// Create sensor object with default I2C address (0xE8 in 8-bit format)
+DYP_R01CW sensor;
+
+#if DYP_R01CW_HAS_FILTERS
+DYP_R01CW_Pipeline pipeline;
+#endif
+
+void setup() {
+  // Initialize serial communication
+  Serial.begin(115200);
+  while (!Serial) {
+    ; // Wait for serial port to connect (needed for native USB)
+  }
+  
+  Serial.println("DYP-R01CW Laser Ranging Sensor - Feature Tiers Example");
+  Serial.println("======================================================");
+  Serial.print("Feature tier: ");
+  Serial.println(DYP_R01CW_Config::tier);
+  
+  // Initialize the sensor
+  if (!sensor.begin()) {
+    Serial.println("ERROR: Could not find DYP-R01CW sensor!");
+    Serial.println("Please check wiring and I2C address.");
+    while (1) {
+      delay(1000);
+    }
+  }
+  
+#if DYP_R01CW_HAS_RETRIES
+  // Repeat failed bus transactions up to 2 times
+  sensor.setRetries(2);
+#endif
+
+#if DYP_R01CW_HAS_FILTERS
+  pipeline.setMedianWindow(3);
+  pipeline.setEmaShift(2);
+#endif
+  
+  Serial.println();
+}
+
+void loop() {
+  int16_t distance = -1;
+  
+#if DYP_R01CW_HAS_ASYNC
+  // Start the measurement and do something else during the conversion
+  if (sensor.startMeasurement()) {
+    while (!sensor.isMeasurementReady()) {
+      yield();
+    }
+    DYP_R01CW_Sample sample;
+    if (sensor.readMeasurement(sample)) {
+      pipeline.process(sample, distance);
+    }
+  }
+#elif DYP_R01CW_HAS_FILTERS
+  DYP_R01CW_Sample sample;
+  if (sensor.readSample(sample)) {
+    pipeline.process(sample, distance);
+  }
+#else
+  distance = sensor.readDistance();
+#endif
+  
+  if (distance >= 0) {
+    Serial.print("Distance: ");
+    Serial.print(distance);
+    Serial.println(" mm");
+  } else {
+    Serial.println("ERROR: Failed to read distance");
+  }
+  
+#if DYP_R01CW_HAS_INSTRUMENTATION
+  const DYP_R01CW_Stats &stats = sensor.getStats();
+  Serial.print("Samples: ");
+  Serial.print(stats.samples);
+  Serial.print(", valid: ");
+  Serial.print(stats.valid);
+  Serial.print(", retries: ");
+  Serial.println(stats.retries);
+#endif
+  
+  // Wait before next reading
+  delay(500);
+}
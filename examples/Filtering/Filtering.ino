@@ -0,0 +1,95 @@
+/*!
+ * @file Filtering.ino
+ *
+ * @brief Example demonstrating the sample processing chain for DYP-R01CW sensor
+ *
+ * This sketch feeds raw samples through DYP_R01CW_Pipeline (offset, median
+ * filter, EMA filter and threshold events). The same processing code is used
+ * by the host-side replay tool in extras/Replay, so parameters can be tuned
+ * offline on recorded logs and then used here unchanged.
+ *
+ * @section hardware Hardware Requirements
+ *
+ * - Arduino board (Uno, Mega, ESP32, etc.)
+ * - DYP-R01CW / DFRobot SEN0590 laser ranging sensor
+ * - I2C connection:
+ *   - SDA to Arduino SDA pin
+ *   - SCL to Arduino SCL pin
+ *   - VCC to supply voltage (3.3...5.0V)
+ *   - GND to GND
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <Wire.h>
+#include <DYP_R01CW.h>
+#include <DYP_R01CW_Processing.h>
+
+#if !DYP_R01CW_HAS_FILTERS
+#error "Filtering example requires DYP_R01CW_TIER_STANDARD or higher (-DDYP_R01CW_TIER=1)"
+#endif
+
+// Create sensor object with default I2C address (0xE8 in 8-bit format)
+DYP_R01CW sensor;
+
+// Processing chain
+DYP_R01CW_Pipeline pipeline;
+
+void setup() {
+  // Initialize serial communication
+  Serial.begin(115200);
+  while (!Serial) {
+    ; // Wait for serial port to connect (needed for native USB)
+  }
+
+  Serial.println("DYP-R01CW Laser Ranging Sensor - Filtering Example");
+  Serial.println("===================================================");
+
+  // Initialize the sensor
+  if (!sensor.begin()) {
+    Serial.println("ERROR: Could not find DYP-R01CW sensor!");
+    Serial.println("Please check wiring and I2C address.");
+    while (1) {
+      delay(1000);
+    }
+  }
+
+  // Configure processing chain
+  pipeline.setDistanceOffset(0);   // Offset in mm
+  pipeline.setMedianWindow(5);     // Median of 5 samples
+  pipeline.setEmaShift(2);         // EMA with alpha = 1/4
+  pipeline.setThreshold(300, 20);  // Event below 300 mm, cleared above 320 mm
+
+  Serial.println("DYP-R01CW sensor initialized successfully!");
+  Serial.println();
+}
+
+void loop() {
+  DYP_R01CW_Sample sample;
+
+  if (!sensor.readSample(sample)) {
+    Serial.println("ERROR: Failed to read distance");
+    return;
+  }
+
+  int16_t distance;
+  uint8_t event = pipeline.process(sample, distance);
+
+  Serial.print("Raw: ");
+  Serial.print(sample.raw);
+  Serial.print(" mm, filtered: ");
+  Serial.print(distance);
+  Serial.println(" mm");
+
+  if (event == DYP_R01CW_EVENT_ENTER) {
+    Serial.println("EVENT: Object closer than threshold");
+  } else if (event == DYP_R01CW_EVENT_LEAVE) {
+    Serial.println("EVENT: Object gone");
+  }
+}
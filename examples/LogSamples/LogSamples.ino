@@ -0,0 +1,67 @@
+/*!
+ * @file LogSamples.ino
+ *
+ * @brief Example demonstrating binary sample logging for DYP-R01CW sensor
+ *
+ * This sketch reads raw samples with readSample() and writes them to the serial
+ * port in the binary log format defined in DYP_R01CW_Log.h. Capture the serial
+ * output to a file and process it on the host with the log analyzer in
+ * extras/LogAnalyzer.
+ *
+ * @section hardware Hardware Requirements
+ *
+ * - Arduino board (Uno, Mega, ESP32, etc.)
+ * - DYP-R01CW / DFRobot SEN0590 laser ranging sensor
+ * - I2C connection:
+ *   - SDA to Arduino SDA pin
+ *   - SCL to Arduino SCL pin
+ *   - VCC to supply voltage (3.3...5.0V)
+ *   - GND to GND
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <Wire.h>
+#include <DYP_R01CW.h>
+#include <DYP_R01CW_Log.h>
+
+// Create sensor object with default I2C address (0xE8 in 8-bit format)
+DYP_R01CW sensor;
+
+void setup() {
+  // Initialize serial communication
+  Serial.begin(115200);
+  while (!Serial) {
+    ; // Wait for serial port to connect (needed for native USB)
+  }
+
+  // Initialize the sensor
+  if (!sensor.begin()) {
+    // Text output would corrupt the binary log - just stop
+    while (1) {
+      delay(1000);
+    }
+  }
+
+  // Write log file header
+  uint8_t header[DYP_R01CW_LOG_HEADER_SIZE];
+  DYP_R01CW_Log::encodeHeader(header);
+  Serial.write(header, sizeof(header));
+}
+
+void loop() {
+  // Read sample; failed reads are logged as well (see sample.status)
+  DYP_R01CW_Sample sample;
+  sensor.readSample(sample);
+
+  // Write sample record
+  uint8_t record[DYP_R01CW_LOG_RECORD_SIZE];
+  DYP_R01CW_Log::encode(sample, record);
+  Serial.write(record, sizeof(record));
+}
@@ -0,0 +1,95 @@
+/*!
+ * @file SensorSet.ino
+ * 
+ * @brief Sensor set with structure-of-arrays state for DYP-R01CW laser ranging sensors
+ * 
+ * This sketch demonstrates how to use DYP_R01CW_SensorSet to sweep several
+ * sensors on one bus: all sensors are triggered, read and filtered in one
+ * pass each. Sensors with repeated failures are reported as unhealthy.
+ * 
+ * @section hardware Hardware Requirements
+ * 
+ * - Arduino board (Uno, Mega, ESP32, etc.)
+ * - Up to 4 DYP-R01CW / DFRobot SEN0590 laser ranging sensors
+ *   (configured to addresses 0xE8, 0xEA, 0xEC and 0xEE, see ChangeAddress example)
+ * - I2C connection:
+ *   - SDA to Arduino SDA pin
+ *   - SCL to Arduino SCL pin
+ *   - VCC to supply voltage (3.3...5.0V)
+ *   - GND to GND
+ * 
+ * @section author Author
+ * 
+ * Written by Matthias Prinke
+ * 
+ * @section license License
+ * 
+ * MIT License
+ */
+
+#include <Wire.h>
+#include <DYP_R01CW_SensorSet.h>
+#include <DYP_R01CW_WireBus.h>
+
+// Sensor set with up to 4 channels
+DYP_R01CW_SensorSet<4> sensors;
+
+// Bus transport for the set
+DYP_R01CW_WireBus bus(Wire);
+
+void setup() {
+  // Initialize serial communication
+  Serial.begin(115200);
+  while (!Serial) {
+    ; // Wait for serial port to connect (needed for native USB)
+  }
+  
+  Serial.println("DYP-R01CW Laser Ranging Sensor - Sensor Set Example");
+  Serial.println("===================================================");
+  
+  Wire.begin();
+  
+  // Add sensors: address (8-bit format), distance offset in millimeters
+  sensors.add(0xE8);
+  sensors.add(0xEA);
+  sensors.add(0xEC, -10);
+  sensors.add(0xEE, -10);
+#if DYP_R01CW_HAS_FILTERS
+  sensors.setEmaShift(2);
+#endif
+  
+  Serial.println();
+}
+
+void loop() {
+  // Sweep: trigger all sensors, wait for the conversion, read all sensors
+  sensors.trigger(bus);
+  delay(DYP_R01CW_CONVERSION_TIME_MS);
+  sensors.read(bus, millis());
+#if DYP_R01CW_HAS_FILTERS
+  sensors.filter();
+#endif
+  
+  // Report
+  for (uint8_t i = 0; i < sensors.size(); i++) {
+    Serial.print("0x");
+    Serial.print(sensors.address(i), HEX);
+    Serial.print(": ");
+    if (!sensors.healthy(i)) {
+      Serial.println("FAILED");
+    } else if (sensors.status(i) != DYP_R01CW_STATUS_OK) {
+      Serial.println("---");
+    } else {
+#if DYP_R01CW_HAS_FILTERS
+      Serial.print(sensors.distances()[i]);
+#else
+      Serial.print(DYP_R01CW_applyOffset(sensors.raws()[i], sensors.offset(i)));
+#endif
+      Serial.println(" mm");
+    }
+  }
+  Serial.println();
+  
+  // Wait before next sweep
+  delay(500);
+}
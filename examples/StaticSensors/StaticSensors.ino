@@ -0,0 +1,79 @@
+/*!
+ * @file StaticSensors.ino
+ * 
+ * @brief Compile-time addressed sensors for DYP-R01CW laser ranging sensor
+ * 
+ * This sketch demonstrates how to use DYP_R01CW_Static, where the I2C
+ * address, the bus and the distance offset are template parameters.
+ * The sensor types carry no state, so additional sensors do not use any
+ * RAM, and invalid addresses are rejected by the compiler.
+ * 
+ * @section hardware Hardware Requirements
+ * 
+ * - Arduino board (Uno, Mega, ESP32, etc.)
+ * - Two DYP-R01CW / DFRobot SEN0590 laser ranging sensors
+ *   (the second one configured to address 0xEA, see ChangeAddress example)
+ * - I2C connection:
+ *   - SDA to Arduino SDA pin
+ *   - SCL to Arduino SCL pin
+ *   - VCC to supply voltage (3.3...5.0V)
+ *   - GND to GND
+ * 
+ * @section author Author
+ * 
+ * Written by Matthias Prinke
+ * 
+ * @section license License
+ * 
+ * MIT License
+ */
+
+#include <Wire.h>
+#include <DYP_R01CW_Static.h>
+
+// Sensor types: address (8-bit format), bus, distance offset in millimeters
+typedef DYP_R01CW_Static<0xE8, Wire, 0> Front;
+typedef DYP_R01CW_Static<0xEA, Wire, -15> Rear;
+
+// Does not compile - 0xF2 is not supported by the sensor:
+// typedef DYP_R01CW_Static<0xF2> Invalid;
+// Invalid::begin();
+
+void printDistance(const char *name, int16_t distance) {
+  Serial.print(name);
+  if (distance >= 0) {
+    Serial.print(distance);
+    Serial.println(" mm");
+  } else {
+    Serial.println("ERROR");
+  }
+}
+
+void setup() {
+  // Initialize serial communication
+  Serial.begin(115200);
+  while (!Serial) {
+    ; // Wait for serial port to connect (needed for native USB)
+  }
+  
+  Serial.println("DYP-R01CW Laser Ranging Sensor - Static Sensors Example");
+  Serial.println("=======================================================");
+  
+  // Initialize the sensors
+  if (!Front::begin()) {
+    Serial.println("ERROR: Could not find front sensor (0xE8)!");
+  }
+  if (!Rear::begin()) {
+    Serial.println("ERROR: Could not find rear sensor (0xEA)!");
+  }
+  
+  Serial.println();
+}
+
+void loop() {
+  printDistance("Front: ", Front::readDistance());
+  printDistance("Rear:  ", Rear::readDistance());
+  
+  // Wait before next reading
+  delay(500);
+}
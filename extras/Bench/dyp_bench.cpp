@@ -0,0 +1,617 @@
+/*!
+ * @file dyp_bench.cpp
+ *
+ * @brief Host micro-benchmarks of the DYP-R01CW per-sample processing kernels
+ *
+ * Times every per-sample kernel of the library over a large synthetic
+ * sample stream (random walk with occasional invalid 0xFFFF samples). Each
+ * kernel is swept over its parameter (window size, shift, ...) and over the
+ * number of sensors: the stream is split round-robin across one kernel
+ * instance per sensor, as on a multi-sensor bus, so the working set grows
+ * with the sensor count.
+ *
+ * Before timing, every kernel is run on a short reference stream (4 sensors)
+ * and the checksum of its outputs is compared with the value recorded in the
+ * benches[] table for each parameter value; the benchmark exits with status 1
+ * on a mismatch, so an optimized kernel cannot silently change the results.
+ *
+ * Each configuration is run several times; the fastest run is reported as
+ * nanoseconds per sample and, on x86, as TSC ticks per sample. The checksum
+ * of the kernel outputs is printed as well.
+ *
+ * To add a kernel, write a run function with the RunFn signature and add a
+ * line to the benches[] table; run the benchmark once to get the reference
+ * checksums to record.
+ *
+ * Usage:
+ *   dyp_bench [-n samples] [-r repeats] [-s sensor_counts] [-k kernel] [-f csv|json]
+ *
+ *   -s comma-separated list of sensor counts (default: 1,4,16,64)
+ *   -k runs only kernels whose name contains the given string
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I../../src dyp_bench.cpp ../../src/DYP_R01CW_FilterBank.cpp \
+ *       ../../src/DYP_R01CW_Kinematics.cpp ../../src/DYP_R01CW_Log.cpp ../../src/DYP_R01CW_Processing.cpp \
+ *       ../../src/DYP_R01CW_Counter.cpp ../../src/DYP_R01CW_Decimator.cpp ../../src/DYP_R01CW_Edge.cpp \
+ *       ../../src/DYP_R01CW_Fusion.cpp ../../src/DYP_R01CW_Occupancy.cpp ../../src/DYP_R01CW_Rate.cpp ../../src/DYP_R01CW_Tank.cpp -o dyp_bench
+ *
+ * Add -mavx2 or -msse4.1 (or -march=native) to use the vectorised filter bank.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "DYP_R01CW_Capture.h"
+#include "DYP_R01CW_Counter.h"
+#include "DYP_R01CW_Decimator.h"
+#include "DYP_R01CW_Edge.h"
+#include "DYP_R01CW_FilterBank.h"
+#include "DYP_R01CW_Fusion.h"
+#include "DYP_R01CW_Kinematics.h"
+#include "DYP_R01CW_Log.h"
+#include "DYP_R01CW_Occupancy.h"
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_Rate.h"
+#include "DYP_R01CW_SensorSet.h"
+#include "DYP_R01CW_Tank.h"
+
+typedef std::vector<DYP_R01CW_Sample> Stream;
+
+// Kernel run: process the stream with one instance per sensor, return a checksum of the outputs
+typedef uint64_t (*RunFn)(const Stream &stream, unsigned param, unsigned sensors);
+
+/*!
+ * @brief Benchmark table entry
+ */
+struct Bench {
+    const char *kernel;           ///< Kernel name
+    const char *param;            ///< Parameter name ("-" if none)
+    std::vector<unsigned> values; ///< Parameter values to sweep
+    RunFn run;                    ///< Run function
+    std::vector<uint64_t> expect; ///< Reference checksum per parameter value
+};
+
+// Reference run: stream length and number of sensors
+#define REF_SAMPLES 20000
+#define REF_SENSORS 4
+
+// Mix a kernel output into a checksum
+static inline uint64_t mix(uint64_t h, uint32_t v) {
+    return (h ^ v) * 0x100000001B3ull;
+}
+
+static Stream makeStream(size_t n) {
+    Stream s(n);
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    int32_t d = 1500;
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        d += (int32_t)(x % 41) - 20;
+        if (d < 50) {
+            d = 50;
+        } else if (d > 4000) {
+            d = 4000;
+        }
+        s[i].timestamp = (uint32_t)(i * 55);
+        s[i].addr = 0xE8;
+        if ((x >> 32) % 1000 == 0) {
+            s[i].raw = DYP_R01CW_RAW_INVALID;
+            s[i].status = DYP_R01CW_STATUS_INVALID;
+        } else {
+            s[i].raw = (uint16_t)d;
+            s[i].status = DYP_R01CW_STATUS_OK;
+        }
+    }
+    return s;
+}
+
+static uint64_t runOffset(const Stream &stream, unsigned param, unsigned sensors) {
+    (void)sensors;
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (const DYP_R01CW_Sample &s : stream) {
+        h = mix(h, (uint16_t)DYP_R01CW_applyOffset(s.raw, (int16_t)param));
+    }
+    return h;
+}
+
+static uint64_t runMedian(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_MedianFilter> f(sensors);
+    for (DYP_R01CW_MedianFilter &m : f) {
+        m.setWindow((uint8_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        h = mix(h, (uint16_t)f[k].update((int16_t)s.raw));
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runEma(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_EmaFilter> f(sensors);
+    for (DYP_R01CW_EmaFilter &e : f) {
+        e.setShift((uint8_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        h = mix(h, (uint16_t)f[k].update((int16_t)s.raw));
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runThreshold(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_Threshold> f(sensors);
+    for (DYP_R01CW_Threshold &t : f) {
+        t.begin(1500, (uint16_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        h = mix(h, f[k].update((int16_t)s.raw));
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runPipeline(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_Pipeline> f(sensors);
+    for (DYP_R01CW_Pipeline &p : f) {
+        p.setDistanceOffset(-20);
+        p.setMedianWindow((uint8_t)param);
+        p.setEmaShift(2);
+        p.setThreshold(1500, 50);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        int16_t d = -1;
+        uint8_t ev = f[k].process(s, d);
+        h = mix(h, ((uint32_t)ev << 16) | (uint16_t)d);
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runSensorSet(const Stream &stream, unsigned param, unsigned sensors) {
+    DYP_R01CW_SensorSet<127> set;
+    for (unsigned i = 0; i < sensors && i < set.capacity; i++) {
+        set.add(DYP_R01CW_DEFAULT_ADDR, -20);
+    }
+    set.setEmaShift((uint8_t)param);
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        set.store((uint8_t)k, s);
+        if (++k == set.size()) {
+            // One sweep complete: filter pass over all channels
+            k = 0;
+            set.filter();
+            for (uint8_t i = 0; i < set.size(); i++) {
+                h = mix(h, (uint16_t)set.distances()[i]);
+            }
+        }
+    }
+    return h;
+}
+
+static uint64_t runFilterBank(const Stream &stream, unsigned param, unsigned sensors) {
+    typedef DYP_R01CW_FilterBank<64> Bank;
+    Bank bank;
+    uint8_t channels = (sensors < Bank::capacity) ? (uint8_t)sensors : Bank::capacity;
+    bank.begin(channels);
+    for (uint8_t i = 0; i < channels; i++) {
+        bank.setOffset(i, -20);
+        bank.setGain(i, DYP_R01CW_GAIN_ONE + 41);
+    }
+    bank.setMedianWindow((uint8_t)param);
+    bank.setEmaShift(2);
+    uint16_t frame[Bank::capacity];
+    int16_t distance[Bank::capacity];
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        frame[k] = s.raw;
+        if (++k == channels) {
+            k = 0;
+            bank.process(frame, distance);
+            for (uint8_t i = 0; i < channels; i++) {
+                h = mix(h, (uint16_t)distance[i]);
+            }
+        }
+    }
+    return h;
+}
+
+static uint64_t runKinematics(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_Kinematics> f(sensors);
+    for (DYP_R01CW_Kinematics &k : f) {
+        k.setWindow((uint8_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        if (s.status == DYP_R01CW_STATUS_OK) {
+            f[k].update((int16_t)s.raw, s.timestamp - 50, s.timestamp);
+        }
+        h = mix(h, (uint32_t)f[k].velocity() ^ (uint32_t)f[k].acceleration());
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runRate(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_Rate> f(sensors);
+    for (DYP_R01CW_Rate &r : f) {
+        r.setDecay((uint8_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        DYP_R01CW_Rate &r = f[k];
+        if (s.status == DYP_R01CW_STATUS_OK) {
+            r.update((int16_t)s.raw, s.timestamp);
+        } else {
+            r.skip(s.timestamp);
+        }
+        h = mix(h, r.period() ^ r.due(s.timestamp + 100));
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runTank(const Stream &stream, unsigned param, unsigned sensors) {
+    (void)sensors;
+    std::vector<DYP_R01CW_TankPoint> table(param);
+    DYP_R01CW_tankHorizontalCylinder(table.data(), (uint8_t)param, 4000, 10000);
+    DYP_R01CW_Tank tank;
+    tank.begin(table.data(), (uint8_t)param);
+    tank.setMountDistance(4100);
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (const DYP_R01CW_Sample &s : stream) {
+        if (s.status == DYP_R01CW_STATUS_OK) {
+            h = mix(h, tank.volumeFromDistance((int16_t)s.raw));
+        }
+    }
+    return h;
+}
+
+static uint64_t runCapture(const Stream &stream, unsigned param, unsigned sensors) {
+    // 2 s at 20 Hz before and after the trigger
+    std::vector<DYP_R01CW_Capture<80>> f(sensors);
+    for (DYP_R01CW_Capture<80> &c : f) {
+        c.setPostTrigger((uint16_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        DYP_R01CW_Capture<80> &c = f[k];
+        if (c.add(s)) {
+            h = mix(h, c.sample(c.triggerIndex()).timestamp);
+            c.rearm();
+        }
+        // Capture the context of each invalid sample
+        if (s.status != DYP_R01CW_STATUS_OK) {
+            c.trigger();
+        }
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runCounter(const Stream &stream, unsigned param, unsigned sensors) {
+    // Sensor pairs; samples alternate between sensor A and B of each pair
+    std::vector<DYP_R01CW_Counter> f((sensors + 1) / 2);
+    for (DYP_R01CW_Counter &c : f) {
+        c.begin(1500, (uint16_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        if (s.status == DYP_R01CW_STATUS_OK) {
+            DYP_R01CW_Counter &c = f[k / 2];
+            h = mix(h, c.update((uint8_t)(k & 1), (int16_t)s.raw, s.timestamp) ^ c.transitTime());
+        }
+        if (++k >= sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runDecimator(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_Decimator> f(sensors);
+    for (DYP_R01CW_Decimator &d : f) {
+        d.setFactor((uint16_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        if (f[k].update(s)) {
+            const DYP_R01CW_Aggregate &r = f[k].record();
+            h = mix(h, (uint16_t)r.mean ^ ((uint32_t)(uint16_t)r.min << 16));
+            h = mix(h, (uint16_t)r.max ^ ((uint32_t)r.valid << 16));
+        }
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runEdge(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_Edge> f(sensors);
+    for (DYP_R01CW_Edge &e : f) {
+        e.begin(1500, (uint16_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        if (s.status == DYP_R01CW_STATUS_OK && f[k].update((int16_t)s.raw, s.timestamp - 50, s.timestamp)) {
+            h = mix(h, f[k].time() ^ f[k].uncertainty());
+        }
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runFusion(const Stream &stream, unsigned param, unsigned sensors) {
+    // One group of up to DYP_R01CW_FUSION_MAX sensors; consecutive samples form a frame
+    uint8_t group = (uint8_t)((sensors > DYP_R01CW_FUSION_MAX) ? DYP_R01CW_FUSION_MAX : sensors);
+    DYP_R01CW_Fusion fusion;
+    fusion.begin(group);
+    fusion.setMode((uint8_t)param);
+    for (uint8_t i = 0; i < group; i++) {
+        fusion.setVariance(i, (uint16_t)(4 << i));
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    int16_t frame[DYP_R01CW_FUSION_MAX];
+    uint8_t valid = 0;
+    uint8_t k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        frame[k] = (int16_t)s.raw;
+        if (s.status == DYP_R01CW_STATUS_OK) {
+            valid |= 1 << k;
+        }
+        if (++k == group) {
+            k = 0;
+            fusion.process(frame, valid);
+            h = mix(h, (uint16_t)fusion.distance() ^ ((uint32_t)fusion.disagreeing() << 16));
+            valid = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runOccupancy(const Stream &stream, unsigned param, unsigned sensors) {
+    std::vector<DYP_R01CW_Occupancy> f(sensors);
+    for (DYP_R01CW_Occupancy &o : f) {
+        o.setAdaptation((uint8_t)param);
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    unsigned k = 0;
+    for (const DYP_R01CW_Sample &s : stream) {
+        if (s.status == DYP_R01CW_STATUS_OK) {
+            h = mix(h, f[k].update((int16_t)s.raw));
+        }
+        if (++k == sensors) {
+            k = 0;
+        }
+    }
+    return h;
+}
+
+static uint64_t runLogEncode(const Stream &stream, unsigned param, unsigned sensors) {
+    (void)param;
+    (void)sensors;
+    uint64_t h = 0xCBF29CE484222325ull;
+    uint8_t rec[DYP_R01CW_LOG_RECORD_SIZE];
+    for (const DYP_R01CW_Sample &s : stream) {
+        DYP_R01CW_Log::encode(s, rec);
+        DYP_R01CW_Sample d;
+        DYP_R01CW_Log::decode(rec, d);
+        h = mix(h, d.raw);
+    }
+    return h;
+}
+
+static const Bench benches[] = {
+    {"offset", "offset", {0, 25}, runOffset,
+     {0x2ddb2efe4f88a9c3ull, 0xc523de333c7e1ee3ull}},
+    {"median", "window", {1, 3, 5, 7}, runMedian,
+     {0x2ddb2efe4f88a9c3ull, 0x842a74640d98a809ull, 0x24a181ed43770f6full, 0x72d15cbe1eb50c6dull}},
+    {"ema", "shift", {1, 2, 4, 8}, runEma,
+     {0xcf4dc3a207c132deull, 0x1051d946448f72edull, 0x09a8110166f88606ull, 0x39576e0ce390fe8dull}},
+    {"threshold", "hysteresis", {0, 50}, runThreshold,
+     {0x2ef84e89a629881eull, 0xbf6daaddd22542a6ull}},
+    {"pipeline", "window", {1, 5}, runPipeline,
+     {0xbd2990a1a9ba195bull, 0xd8acd9ac9322c8faull}},
+    {"sensorset_ema", "shift", {2}, runSensorSet,
+     {0xc63820952ae98b7cull}},
+    {"filterbank", "window", {1, 5}, runFilterBank,
+     {0x2daf860d2f10d1aeull, 0xfe9bd9d410538652ull}},
+    {"kinematics", "window", {1, 4, 8}, runKinematics,
+     {0x0099afbf60f38416ull, 0x011937fc21a21c61ull, 0x20f2d6803aa7cdb6ull}},
+    {"occupancy", "shift", {4, 8}, runOccupancy,
+     {0x3cd18af03c097c81ull, 0x3e29bd7cd0c3e9b7ull}},
+    {"capture", "post", {1, 40}, runCapture,
+     {0xcbe47baae69357a2ull, 0x4bd4acd4533688d5ull}},
+    {"counter", "hysteresis", {0, 50}, runCounter,
+     {0x02d3645868b4ebbcull, 0xfc56aee07187e04full}},
+    {"decimator", "factor", {4, 64}, runDecimator,
+     {0xd965b4a098c6416aull, 0xb89bc60cb2cfffbaull}},
+    {"edge", "hysteresis", {0, 50}, runEdge,
+     {0x64930991182c6b06ull, 0x0a28d651f560c3d2ull}},
+    {"fusion", "mode", {DYP_R01CW_FUSION_MEDIAN, DYP_R01CW_FUSION_WEIGHTED}, runFusion,
+     {0x28ca3b90a0d8071full, 0xe4577d3c532c5eafull}},
+    {"rate", "decay", {1, 3}, runRate,
+     {0xae2b61449f787ec4ull, 0xd67727d9d5bf7e8bull}},
+    {"tank", "points", {17, 65, 255}, runTank,
+     {0x2406e3f797e26112ull, 0xdcf3c3acacd73a88ull, 0xad1e0966ae81b454ull}},
+    {"log_codec", "-", {0}, runLogEncode,
+     {0x2ddb2efe4f88a9c3ull}},
+};
+
+static std::vector<unsigned> parseList(const char *arg) {
+    std::vector<unsigned> v;
+    const char *p = arg;
+    while (*p != '\0') {
+        char *end;
+        unsigned long x = strtoul(p, &end, 0);
+        if (end == p || x == 0) {
+            return std::vector<unsigned>();
+        }
+        v.push_back((unsigned)x);
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return v;
+}
+
+int main(int argc, char **argv) {
+    size_t samples = 4000000;
+    unsigned repeats = 5;
+    std::vector<unsigned> sensorCounts = {1, 4, 16, 64};
+    const char *only = nullptr;
+    bool json = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:s:k:f:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            samples = strtoull(optarg, nullptr, 0);
+            break;
+        case 'r':
+            repeats = (unsigned)atoi(optarg);
+            break;
+        case 's':
+            sensorCounts = parseList(optarg);
+            break;
+        case 'k':
+            only = optarg;
+            break;
+        case 'f':
+            json = (strcmp(optarg, "json") == 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: dyp_bench [-n samples] [-r repeats] [-s sensor_counts] [-k kernel] [-f csv|json]\n");
+            return 2;
+        }
+    }
+    if (samples == 0 || repeats == 0 || sensorCounts.empty()) {
+        fprintf(stderr, "Usage: dyp_bench [-n samples] [-r repeats] [-s sensor_counts] [-k kernel] [-f csv|json]\n");
+        return 2;
+    }
+
+    // Check the kernel results before timing them
+    Stream ref = makeStream(REF_SAMPLES);
+    bool ok = true;
+    for (const Bench &b : benches) {
+        for (size_t i = 0; i < b.values.size(); i++) {
+            uint64_t checksum = b.run(ref, b.values[i], REF_SENSORS);
+            uint64_t expect = (i < b.expect.size()) ? b.expect[i] : 0;
+            if (checksum != expect) {
+                fprintf(stderr, "%s %s=%u: checksum %016" PRIx64 ", expected %016" PRIx64 "\n", b.kernel, b.param,
+                        b.values[i], checksum, expect);
+                ok = false;
+            }
+        }
+    }
+    if (!ok) {
+        return 1;
+    }
+
+    Stream stream = makeStream(samples);
+
+    if (json) {
+        printf("[\n");
+    } else {
+        printf("kernel,param,value,sensors,samples,ns_per_sample,ticks_per_sample,checksum\n");
+    }
+    bool first = true;
+    for (const Bench &b : benches) {
+        if (only != nullptr && strstr(b.kernel, only) == nullptr) {
+            continue;
+        }
+        for (unsigned value : b.values) {
+            for (unsigned sensors : sensorCounts) {
+                double bestNs = 1e300;
+                double bestTicks = 0;
+                uint64_t checksum = 0;
+                for (unsigned r = 0; r < repeats; r++) {
+#ifdef HAVE_TSC
+                    uint64_t c0 = __rdtsc();
+#endif
+                    auto t0 = std::chrono::steady_clock::now();
+                    checksum = b.run(stream, value, sensors);
+                    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+#ifdef HAVE_TSC
+                    double ticks = (double)(__rdtsc() - c0);
+#else
+                    double ticks = 0;
+#endif
+                    if (ns < bestNs) {
+                        bestNs = ns;
+                        bestTicks = ticks;
+                    }
+                }
+                double nsPer = bestNs / samples;
+                double ticksPer = bestTicks / samples;
+                if (json) {
+                    printf("%s  {\"kernel\": \"%s\", \"param\": \"%s\", \"value\": %u, \"sensors\": %u, \"samples\": %zu, "
+                           "\"ns_per_sample\": %.3f, \"ticks_per_sample\": %.3f, \"checksum\": \"%016" PRIx64 "\"}",
+                           first ? "" : ",\n", b.kernel, b.param, value, sensors, samples, nsPer, ticksPer, checksum);
+                } else {
+                    printf("%s,%s,%u,%u,%zu,%.3f,%.3f,%016" PRIx64 "\n", b.kernel, b.param, value, sensors, samples,
+                           nsPer, ticksPer, checksum);
+                }
+                first = false;
+                fflush(stdout);
+            }
+        }
+    }
+    if (json) {
+        printf("\n]\n");
+    }
+
+    return 0;
+}
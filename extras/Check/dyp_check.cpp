@@ -0,0 +1,704 @@
+/*!
+ * @file dyp_check.cpp
+ *
+ * @brief Host-side check of the DYP-R01CW processing stages
+ *
+ * Runs the processing stages of the library on hand-made inputs and compares
+ * their outputs with hand-computed values. Checks
+ *
+ * - DYP_R01CW_FilterBank: offset, rounding and saturation of the calibration,
+ *   median start-up, EMA and invalid values; and the SIMD implementation
+ *   selected at compile time (process()) against the scalar reference
+ *   implementation (processScalar()) on random frames for every channel
+ *   count, median window and EMA shift, with saturating gains, negative
+ *   offsets and invalid values
+ * - DYP_R01CW_Kinematics: velocity and acceleration of hand-computed
+ *   motions, dating of a distance between trigger and read time, window
+ *   of two samples
+ * - DYP_R01CW_Tank: generated tables of a horizontal cylinder and a cone,
+ *   clamping below and above the table, interpolation, volume from the
+ *   measured distance
+ * - DYP_R01CW_Occupancy: learning, background adaptation, margin, enter
+ *   and leave, absorption of a staying object
+ * - DYP_R01CW_Counter: objects longer and shorter than the sensor spacing in
+ *   both directions, objects turning back, timeout
+ * - DYP_R01CW_Edge: interpolated crossing times of both edges and their
+ *   uncertainty from distance noise and time jitter, limit to half the
+ *   sample interval
+ * - DYP_R01CW_Fusion: inverse-variance weighted mean over the whole variance
+ *   range, rounding
+ * - DYP_R01CW_Capture: block layout around the trigger, chronological
+ *   order, blocks shorter than the capacity, dropped samples, post-trigger
+ *   count 0 and its limit
+ * - DYP_R01CW_Rate: period growth in a quiet scene and its limit, reset
+ *   on motion and in the event band, invalid samples, effective rate,
+ *   millis() wrap-around
+ * - DYP_R01CW_Decimator: mean, minimum, maximum and counts with invalid
+ *   samples, rounding of the mean, offset, partial windows, windows
+ *   without a valid sample
+ * - DYP_R01CW_Pool: exhaustion, reuse, statistics, and rejection of double
+ *   releases and foreign pointers
+ *
+ * Prints each failed check and exits with status 1 if any check failed.
+ * Build it with and without -msse4.1 / -mavx2 (or -march=native) to check
+ * each filter bank implementation.
+ *
+ * Usage:
+ *   dyp_check
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I../../src dyp_check.cpp ../../src/DYP_R01CW_Counter.cpp \
+ *       ../../src/DYP_R01CW_Decimator.cpp ../../src/DYP_R01CW_Edge.cpp ../../src/DYP_R01CW_FilterBank.cpp \
+ *       ../../src/DYP_R01CW_Fusion.cpp ../../src/DYP_R01CW_Kinematics.cpp ../../src/DYP_R01CW_Occupancy.cpp \
+ *       ../../src/DYP_R01CW_Processing.cpp ../../src/DYP_R01CW_Rate.cpp ../../src/DYP_R01CW_Tank.cpp \
+ *       -o dyp_check
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "DYP_R01CW_Capture.h"
+#include "DYP_R01CW_Counter.h"
+#include "DYP_R01CW_Decimator.h"
+#include "DYP_R01CW_Edge.h"
+#include "DYP_R01CW_FilterBank.h"
+#include "DYP_R01CW_Fusion.h"
+#include "DYP_R01CW_Kinematics.h"
+#include "DYP_R01CW_Occupancy.h"
+#include "DYP_R01CW_Pool.h"
+#include "DYP_R01CW_Rate.h"
+#include "DYP_R01CW_Tank.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+// Pseudo-random numbers (xorshift)
+static uint32_t rnd() {
+    static uint32_t x = 0x12345678;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+typedef DYP_R01CW_FilterBank<40> Bank;
+
+// Feed one value to a single-channel bank, return the distance
+static int16_t feed(Bank &bank, uint16_t raw) {
+    int16_t d = -1;
+    bank.process(&raw, &d);
+    return d;
+}
+
+static void checkFilterBankValues() {
+    Bank bank;
+    CHECK(!bank.begin(0));
+    CHECK(!bank.begin(Bank::capacity + 1));
+
+    // Offset and calibration, rounded to the nearest millimeter
+    CHECK(bank.begin(1));
+    bank.setOffset(0, -20);
+    CHECK(feed(bank, 1020) == 1000);
+    CHECK(feed(bank, 10) == -10);
+    bank.setGain(0, 2 * DYP_R01CW_GAIN_ONE);
+    CHECK(feed(bank, 1020) == 2000);
+    bank.setOffset(0, 0);
+    bank.setGain(0, DYP_R01CW_GAIN_ONE + DYP_R01CW_GAIN_ONE / 2);
+    CHECK(feed(bank, 3) == 5);  // 4.5 rounds up
+    CHECK(feed(bank, 1) == 2);  // 1.5 rounds up
+
+    // Saturation to the int16_t range
+    bank.setGain(0, 32767);
+    CHECK(feed(bank, 30000) == 32767);
+    bank.setGain(0, -32768);
+    CHECK(feed(bank, 30000) == -32768);
+
+    // Invalid values: the previous distance is output again, initially 0
+    CHECK(bank.begin(1));
+    uint16_t raw = DYP_R01CW_RAW_INVALID;
+    int16_t d = -1;
+    CHECK(bank.process(&raw, &d) == 0);
+    CHECK(d == 0);
+    CHECK(feed(bank, 1500) == 1500);
+    CHECK(bank.process(&raw, &d) == 0);
+    CHECK(d == 1500);
+
+    // Median: the history is filled with the first valid value
+    CHECK(bank.begin(1));
+    bank.setMedianWindow(3);
+    CHECK(feed(bank, 100) == 100);
+    CHECK(feed(bank, 300) == 100);
+    CHECK(feed(bank, 200) == 200);
+    CHECK(feed(bank, DYP_R01CW_RAW_INVALID) == 200);
+    CHECK(feed(bank, 50) == 200);
+
+    // EMA: starts from the first value
+    CHECK(bank.begin(1));
+    bank.setMedianWindow(1);
+    bank.setEmaShift(1);
+    CHECK(feed(bank, 100) == 100);
+    CHECK(feed(bank, 200) == 150);
+    CHECK(feed(bank, 200) == 175);
+    CHECK(feed(bank, DYP_R01CW_RAW_INVALID) == 175);
+    CHECK(feed(bank, 200) == 187);
+
+    // Channels are independent
+    CHECK(bank.begin(2));
+    bank.setEmaShift(0);
+    bank.setOffset(1, 5);
+    uint16_t frame[2] = {100, DYP_R01CW_RAW_INVALID};
+    int16_t out[2] = {-1, -1};
+    CHECK(bank.process(frame, out) == 1);
+    CHECK(out[0] == 100 && out[1] == 0);
+    frame[1] = 200;
+    CHECK(bank.process(frame, out) == 2);
+    CHECK(out[0] == 100 && out[1] == 205);
+}
+
+static void checkFilterBankVector() {
+    static const int16_t gains[] = {DYP_R01CW_GAIN_ONE, 32767, -32768, 0, -DYP_R01CW_GAIN_ONE, 4137};
+
+    Bank vec;
+    Bank ref;
+    uint16_t frame[Bank::capacity];
+    int16_t outVec[Bank::capacity];
+    int16_t outRef[Bank::capacity];
+    for (uint8_t channels = 1; channels <= Bank::capacity; channels++) {
+        for (uint8_t window = 1; window <= DYP_R01CW_MEDIAN_MAX; window += 2) {
+            for (uint8_t shift = 0; shift <= 15; shift++) {
+                CHECK(vec.begin(channels));
+                CHECK(ref.begin(channels));
+                vec.setMedianWindow(window);
+                ref.setMedianWindow(window);
+                vec.setEmaShift(shift);
+                ref.setEmaShift(shift);
+                for (uint8_t i = 0; i < channels; i++) {
+                    int16_t offset = (int16_t)(rnd() % 2001) - 1000;
+                    int16_t gain = gains[rnd() % (sizeof(gains) / sizeof(gains[0]))];
+                    vec.setOffset(i, offset);
+                    ref.setOffset(i, offset);
+                    vec.setGain(i, gain);
+                    ref.setGain(i, gain);
+                }
+                bool same = true;
+                for (int n = 0; n < 40; n++) {
+                    for (uint8_t i = 0; i < channels; i++) {
+                        uint32_t r = rnd();
+                        if (r % 8 == 0) {
+                            frame[i] = DYP_R01CW_RAW_INVALID;
+                        } else if (r % 8 == 1) {
+                            frame[i] = (uint16_t)(r >> 16);
+                        } else {
+                            frame[i] = (uint16_t)((r >> 8) % 4000);
+                        }
+                    }
+                    memset(outVec, 0x55, sizeof(outVec));
+                    memset(outRef, 0x55, sizeof(outRef));
+                    same &= vec.process(frame, outVec) == ref.processScalar(frame, outRef);
+                    same &= memcmp(outVec, outRef, channels * sizeof(int16_t)) == 0;
+                }
+                if (!same) {
+                    fprintf(stderr, "filter bank %s: channels %u, window %u, shift %u differ from scalar\n",
+                            Bank::isa(), channels, window, shift);
+                }
+                CHECK(same);
+            }
+        }
+    }
+}
+
+// Counter sensor states (threshold 800 mm, hysteresis 50 mm)
+#define NEAR 500
+#define FAR 2000
+
+/*!
+ * @brief Counter event: sensor channel sees the distance at a time
+ */
+struct CounterStep {
+    uint8_t channel;
+    int16_t distance;
+    uint32_t time;
+};
+
+// Run a sequence of counter events, return the direction reported by the last one
+static uint8_t runCounter(DYP_R01CW_Counter &counter, const CounterStep *steps, size_t n) {
+    uint8_t direction = DYP_R01CW_DIRECTION_NONE;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t d = counter.update(steps[i].channel, steps[i].distance, steps[i].time);
+        CHECK(i + 1 == n || d == DYP_R01CW_DIRECTION_NONE);
+        direction = d;
+    }
+    return direction;
+}
+
+static void checkKinematics() {
+    DYP_R01CW_Kinematics kin;
+
+    // 50 mm per 100 ms away from the sensor: 500 mm/s, no acceleration
+    for (int k = 0; k < 3; k++) {
+        CHECK(kin.update((int16_t)(1000 + 50 * k), (uint32_t)(100 * k)) == (k > 0));
+    }
+    CHECK(kin.velocity() == 500 * 256);
+    CHECK(kin.hasAcceleration());
+    CHECK(kin.acceleration() == 0);
+
+    // d = 1000 mm + a/2 * t^2 with a = 2000 mm/s^2, every 100 ms: 1000, 1010, 1040 mm;
+    // velocities 100 and 300 mm/s at 50 and 150 ms
+    kin.reset();
+    const int16_t accel[] = {1000, 1010, 1040};
+    for (int k = 0; k < 3; k++) {
+        kin.update(accel[k], (uint32_t)(100 * k));
+    }
+    CHECK(kin.velocity() == 300 * 256);
+    CHECK(kin.acceleration() == 2000 * 256);
+
+    // Approaching; each distance is dated to the middle of its conversion (20 and 220 ms)
+    kin.reset();
+    kin.update(1100, 0, 40);
+    CHECK(kin.update(1000, 200, 240));
+    CHECK(kin.velocity() == -500 * 256);
+
+    // Window 2: the difference spans two samples, irregular intervals
+    kin.setWindow(2);
+    CHECK(!kin.update(1000, 0));
+    CHECK(!kin.update(1030, 50));
+    CHECK(kin.update(1100, 250));
+    CHECK(kin.velocity() == 400 * 256);  // 100 mm in 250 ms
+}
+
+static void checkTank() {
+    DYP_R01CW_TankPoint table[11];
+    DYP_R01CW_Tank tank;
+
+    // Horizontal cylinder 1000 mm x 2000 mm: pi * 500^2 * 2000 / 1000 mL = 1570796.3 mL,
+    // half of it at half the diameter
+    CHECK(DYP_R01CW_tankHorizontalCylinder(table, 11, 1000, 2000));
+    CHECK(tank.begin(table, 11));
+    CHECK(tank.capacity() == 1570796);
+    CHECK(tank.volume(500) == 785398);
+    CHECK(tank.volume(0) == 0);
+
+    // Clamped below and above the table
+    CHECK(tank.volume(-100) == 0);
+    CHECK(tank.volume(1500) == 1570796);
+
+    // Cone 1000 mm high, 600 mm top diameter: pi * h * r^2 / 3, r = 300 mm at 1000 mm
+    // and 150 mm at 500 mm: 94247.8 mL and 11781.0 mL
+    CHECK(DYP_R01CW_tankCone(table, 11, 1000, 0, 600));
+    CHECK(tank.begin(table, 11));
+    CHECK(tank.capacity() == 94248);
+    CHECK(tank.volume(500) == 11781);
+
+    // Linear interpolation, rounded; level from the mount distance
+    static const DYP_R01CW_TankPoint steps[] = {{0, 0}, {100, 1000}, {200, 3000}};
+    CHECK(tank.begin(steps, 3));
+    CHECK(tank.volume(50) == 500);
+    CHECK(tank.volume(133) == 1660);
+    tank.setMountDistance(250);
+    CHECK(tank.volumeFromDistance(100) == 2000);  // level 150 mm
+    CHECK(tank.volumeFromDistance(300) == 0);     // level -50 mm
+    CHECK(tank.volumeFromDistance(0) == 3000);    // level 250 mm
+
+    // Levels must increase strictly
+    static const DYP_R01CW_TankPoint bad[] = {{0, 0}, {100, 1000}, {100, 2000}};
+    CHECK(!tank.begin(bad, 3));
+    CHECK(tank.volume(100) == 0);
+}
+
+static void checkOccupancy() {
+    DYP_R01CW_Occupancy occ;
+
+    // Learning: 16 samples of a constant background
+    for (int i = 0; i < DYP_R01CW_OCCUPANCY_LEARN_SAMPLES; i++) {
+        CHECK(occ.isLearning());
+        CHECK(occ.update(2000) == DYP_R01CW_EVENT_NONE);
+    }
+    CHECK(!occ.isLearning());
+    CHECK(occ.background() == 2000);
+    CHECK(occ.deviation() == 0);
+
+    // 40 mm closer is within the 50 mm margin: background sample with alpha = 1/16,
+    // 2000 - 40 / 16 = 1997.5 mm, deviation 40 / 16 = 2.5 mm
+    CHECK(occ.update(1960) == DYP_R01CW_EVENT_NONE);
+    CHECK(occ.background() == 1997);
+    CHECK(occ.deviation() == 2);
+
+    // 97.5 mm closer enters; the background does not adapt while occupied
+    CHECK(occ.update(1900) == DYP_R01CW_EVENT_ENTER);
+    CHECK(occ.isOccupied());
+    CHECK(occ.update(1920) == DYP_R01CW_EVENT_NONE);
+    CHECK(occ.background() == 1997);
+    CHECK(occ.update(1990) == DYP_R01CW_EVENT_LEAVE);
+    CHECK(!occ.isOccupied());
+
+    // An object staying for 3 samples becomes background
+    occ.setAbsorb(3);
+    CHECK(occ.update(1500) == DYP_R01CW_EVENT_ENTER);
+    CHECK(occ.update(1500) == DYP_R01CW_EVENT_NONE);
+    CHECK(occ.update(1500) == DYP_R01CW_EVENT_NONE);
+    CHECK(occ.update(1500) == DYP_R01CW_EVENT_LEAVE);
+    CHECK(occ.background() == 1500);
+    CHECK(occ.update(1500) == DYP_R01CW_EVENT_NONE);
+}
+
+static void checkCounter() {
+    static const uint8_t A = DYP_R01CW_COUNTER_A;
+    static const uint8_t B = DYP_R01CW_COUNTER_B;
+    DYP_R01CW_Counter counter;
+    counter.begin(800, 50);
+
+    // Long object (longer than the sensor spacing), A to B
+    const CounterStep longAB[] = {{A, NEAR, 100}, {B, NEAR, 250}, {A, FAR, 900}, {B, FAR, 1050}};
+    CHECK(runCounter(counter, longAB, 4) == DYP_R01CW_DIRECTION_AB);
+    CHECK(counter.transitTime() == 150);
+
+    // Long object, B to A
+    const CounterStep longBA[] = {{B, NEAR, 2100}, {A, NEAR, 2300}, {B, FAR, 2900}, {A, FAR, 3100}};
+    CHECK(runCounter(counter, longBA, 4) == DYP_R01CW_DIRECTION_BA);
+    CHECK(counter.transitTime() == 200);
+
+    // Short object (shorter than the sensor spacing), A to B
+    const CounterStep shortAB[] = {{A, NEAR, 4000}, {A, FAR, 4100}, {B, NEAR, 4400}, {B, FAR, 4500}};
+    CHECK(runCounter(counter, shortAB, 4) == DYP_R01CW_DIRECTION_AB);
+    CHECK(counter.transitTime() == 400);
+
+    // Short object, B to A
+    const CounterStep shortBA[] = {{B, NEAR, 5000}, {B, FAR, 5050}, {A, NEAR, 5350}, {A, FAR, 5400}};
+    CHECK(runCounter(counter, shortBA, 4) == DYP_R01CW_DIRECTION_BA);
+    CHECK(counter.transitTime() == 350);
+
+    CHECK(counter.count(DYP_R01CW_DIRECTION_AB) == 2);
+    CHECK(counter.count(DYP_R01CW_DIRECTION_BA) == 2);
+    CHECK(counter.discarded() == 0);
+    CHECK(counter.lastDirection() == DYP_R01CW_DIRECTION_BA);
+
+    // Turns back after interrupting both sensors
+    const CounterStep back[] = {{A, NEAR, 6000}, {B, NEAR, 6200}, {B, FAR, 6400}, {A, FAR, 6600}};
+    CHECK(runCounter(counter, back, 4) == DYP_R01CW_DIRECTION_NONE);
+    CHECK(counter.discarded() == 1);
+
+    // Turns back before reaching the second sensor: discarded when the next object arrives
+    const CounterStep backShort[] = {{A, NEAR, 7000}, {A, FAR, 7100}, {A, NEAR, 8000}, {B, NEAR, 8200},
+                                     {A, FAR, 8600}, {B, FAR, 8800}};
+    CHECK(runCounter(counter, backShort, 6) == DYP_R01CW_DIRECTION_AB);
+    CHECK(counter.discarded() == 2);
+    CHECK(counter.transitTime() == 200);
+
+    // Timeout
+    counter.setTimeout(1000);
+    const CounterStep slow[] = {{A, NEAR, 10000}, {A, FAR, 10100}, {B, NEAR, 11200}, {B, FAR, 11300}};
+    CHECK(runCounter(counter, slow, 4) == DYP_R01CW_DIRECTION_NONE);
+    CHECK(counter.discarded() == 3);
+    CHECK(counter.count(DYP_R01CW_DIRECTION_AB) == 3);
+    CHECK(counter.count(DYP_R01CW_DIRECTION_BA) == 2);
+}
+
+static void checkEdge() {
+    DYP_R01CW_Edge edge;
+    edge.begin(1000, 100);
+
+    // Distances dated to the middle of their conversion (10 and 110 ms); 1200 -> 900 mm
+    // crosses 1000 mm at 10 + 100 * 200 / 300 = 76.7 ms. Noise 5 mm of both samples:
+    // 100 * 5 * sqrt(200^2 + 100^2) / 300^2 = 1.24 ms, rounded up
+    CHECK(edge.update(1200, 0, 20) == DYP_R01CW_EVENT_NONE);
+    CHECK(edge.update(900, 100, 120) == DYP_R01CW_EVENT_ENTER);
+    CHECK(edge.edge() == DYP_R01CW_EVENT_ENTER);
+    CHECK(edge.time() == 77);
+    CHECK(edge.uncertainty() == 2);
+
+    // 1050 -> 1250 mm crosses 1100 mm (threshold + hysteresis) at 210 + 100 * 50 / 200 = 235 ms,
+    // 100 * 5 * sqrt(50^2 + 150^2) / 200^2 = 1.98 ms
+    CHECK(edge.update(1050, 200, 220) == DYP_R01CW_EVENT_NONE);
+    CHECK(edge.update(1250, 300, 320) == DYP_R01CW_EVENT_LEAVE);
+    CHECK(edge.time() == 235);
+    CHECK(edge.uncertainty() == 2);
+
+    // Jitter 8 ms of both sample times: 8 * sqrt((1/6)^2 + (5/6)^2) = 6.80 ms, with the
+    // noise term 1.42 ms 6.95 ms; crossing at 310 + 100 * 250 / 300 = 393.3 ms
+    edge.setJitter(8);
+    CHECK(edge.update(950, 400, 420) == DYP_R01CW_EVENT_ENTER);
+    CHECK(edge.time() == 393);
+    CHECK(edge.uncertainty() == 7);
+
+    // Noise 1000 mm: 204 ms, limited to half the sample interval
+    edge.setJitter(0);
+    edge.setNoise(1000);
+    CHECK(edge.update(1300, 500, 520) == DYP_R01CW_EVENT_LEAVE);
+    CHECK(edge.time() == 453);  // 410 + 100 * 150 / 350 = 452.9 ms
+    CHECK(edge.uncertainty() == 50);
+}
+
+static void checkFusion() {
+    DYP_R01CW_Fusion fusion;
+    CHECK(fusion.begin(3));
+    fusion.setMode(DYP_R01CW_FUSION_WEIGHTED);
+    fusion.setTolerance(2000);
+
+    // Equal (default) variances: mean, rounded to the nearest millimeter
+    int16_t d[3] = {1000, 1001, 1003};
+    CHECK(fusion.process(d, 0x07));
+    CHECK(fusion.distance() == 1001);
+    int16_t n[3] = {-1000, -1001, 0};
+    CHECK(fusion.process(n, 0x03));
+    CHECK(fusion.distance() == -1001);  // -1000.5 rounds away from 0
+
+    // Variances 1 and 4: weights 4:1
+    CHECK(fusion.begin(2));
+    fusion.setVariance(0, 1);
+    fusion.setVariance(1, 4);
+    int16_t a[2] = {1000, 1010};
+    CHECK(fusion.process(a, 0x03));
+    CHECK(fusion.distance() == 1002);
+
+    // Large variances are still resolved: 32768 and 65535 weigh 2:1
+    fusion.setVariance(0, 32768);
+    fusion.setVariance(1, 65535);
+    int16_t b[2] = {1000, 2000};
+    CHECK(fusion.process(b, 0x03));
+    CHECK(fusion.distance() == 1333);
+
+    // Extreme ratio
+    fusion.setVariance(0, 65535);
+    fusion.setVariance(1, 1);
+    int16_t c[2] = {32767, -32768};
+    CHECK(fusion.process(c, 0x03) == false);  // beyond the tolerance of the median
+    fusion.setTolerance(65535);
+    CHECK(fusion.process(c, 0x03));
+    CHECK(fusion.distance() == -32767);  // -32767.00003
+}
+
+// Sample with the given raw value
+static DYP_R01CW_Sample rawSample(uint16_t raw) {
+    DYP_R01CW_Sample s = {};
+    s.raw = raw;
+    s.timestamp = raw;
+    return s;
+}
+
+static void checkCapture() {
+    DYP_R01CW_Capture<8> cap;
+    cap.setPostTrigger(3);
+    CHECK(!cap.trigger());  // no sample yet
+
+    // 13 samples (raw 100...112), trigger at 112, 3 post-trigger samples:
+    // block 108...115, 4 pre-trigger samples, trigger sample at index 4
+    for (uint16_t raw = 100; raw <= 112; raw++) {
+        CHECK(!cap.add(rawSample(raw)));
+    }
+    CHECK(cap.trigger());
+    CHECK(!cap.trigger());
+    CHECK(cap.state() == DYP_R01CW_CAPTURE_TRIGGERED);
+    CHECK(!cap.add(rawSample(113)));
+    CHECK(!cap.add(rawSample(114)));
+    CHECK(cap.add(rawSample(115)));
+    CHECK(cap.ready());
+    CHECK(cap.size() == 8);
+    CHECK(cap.triggerIndex() == 4);
+    for (uint16_t i = 0; i < 8; i++) {
+        CHECK(cap.sample(i).raw == 108 + i);
+    }
+
+    // Frozen: further samples are dropped
+    CHECK(!cap.add(rawSample(116)));
+    CHECK(cap.dropped() == 1);
+    CHECK(cap.sample(7).raw == 115);
+
+    // Triggered before the ring is full: 200, 201 (trigger), 202...204
+    cap.rearm();
+    CHECK(cap.size() == 0);
+    cap.add(rawSample(200));
+    cap.add(rawSample(201));
+    CHECK(cap.trigger());
+    cap.add(rawSample(202));
+    cap.add(rawSample(203));
+    CHECK(cap.add(rawSample(204)));
+    CHECK(cap.size() == 5);
+    CHECK(cap.triggerIndex() == 1);
+    CHECK(cap.sample(0).raw == 200 && cap.sample(4).raw == 204);
+
+    // No post-trigger samples: frozen at the trigger; post-trigger count limited to 7
+    cap.setPostTrigger(0);
+    cap.add(rawSample(300));
+    cap.add(rawSample(301));
+    CHECK(cap.trigger());
+    CHECK(cap.ready());
+    CHECK(cap.triggerIndex() == 1);
+    cap.setPostTrigger(100);
+    cap.add(rawSample(400));
+    CHECK(cap.trigger());
+    for (uint16_t raw = 401; raw < 407; raw++) {
+        CHECK(!cap.add(rawSample(raw)));
+    }
+    CHECK(cap.add(rawSample(407)));
+    CHECK(cap.triggerIndex() == 0);
+}
+
+static void checkRate() {
+    DYP_R01CW_Rate rate;
+    rate.setBounds(100, 200);
+    CHECK(rate.due(0));  // no sample yet
+
+    // Quiet scene: period += period / 8 + 1 per sample: 113, 128, 145, 164, 185, 200 (limit)
+    static const uint16_t periods[] = {113, 128, 145, 164, 185, 200, 200};
+    uint32_t t = 0;
+    for (int i = 0; i < 7; i++) {
+        rate.update(1000, t);
+        CHECK(rate.period() == periods[i]);
+        CHECK(!rate.due(t + periods[i] - 1));
+        CHECK(rate.due(t + periods[i]));
+        t += periods[i];
+    }
+
+    // Motion (more than 20 mm between samples): back to the minimum; an invalid sample
+    // keeps the period
+    rate.update(1030, t);
+    CHECK(rate.period() == 100);
+    rate.skip(t + 100);
+    CHECK(rate.period() == 100);
+    rate.update(1030, t + 200);
+    CHECK(rate.period() == 113);
+
+    // Within the event band 800 +/- 50 mm: minimum period
+    rate.setNear(800, 50);
+    rate.update(840, t + 300);
+    rate.update(840, t + 400);
+    CHECK(rate.period() == 100);
+
+    // Effective rate: 100 ms intervals, 10 Hz; one interval of 60 ms moves the
+    // average interval by (60 - 100) / 8 to 95 ms, 10.526 Hz
+    rate.reset();
+    rate.update(840, 0);
+    CHECK(rate.rate() == 0);
+    rate.update(840, 100);
+    rate.update(840, 200);
+    CHECK(rate.rate() == 10000);
+    rate.update(840, 260);
+    CHECK(rate.rate() == 10526);
+
+    // The next sample time wraps around with millis()
+    rate.update(840, 0xFFFFFFC0UL);
+    CHECK(!rate.due(0xFFFFFFF0UL));
+    CHECK(!rate.due(35));
+    CHECK(rate.due(36));
+}
+
+// Sample at a time with the given raw value and status
+static DYP_R01CW_Sample timedSample(uint32_t time, uint16_t raw, uint8_t status) {
+    DYP_R01CW_Sample s = {};
+    s.timestamp = time;
+    s.raw = raw;
+    s.status = status;
+    return s;
+}
+
+static void checkDecimator() {
+    DYP_R01CW_Decimator dec;
+    dec.setFactor(4);
+
+    // 1000, 1002, 1003 mm and an invalid sample: mean 1001.67 -> 1002
+    CHECK(!dec.update(timedSample(500, 1000, DYP_R01CW_STATUS_OK)));
+    CHECK(!dec.update(timedSample(600, 1002, DYP_R01CW_STATUS_OK)));
+    CHECK(!dec.update(timedSample(700, DYP_R01CW_RAW_INVALID, DYP_R01CW_STATUS_INVALID)));
+    CHECK(dec.update(timedSample(800, 1003, DYP_R01CW_STATUS_OK)));
+    const DYP_R01CW_Aggregate &r = dec.record();
+    CHECK(r.timestamp == 500);
+    CHECK(r.samples == 4 && r.valid == 3);
+    CHECK(r.mean == 1002 && r.min == 1000 && r.max == 1003);
+
+    // Halves round away from zero: 1000.5 -> 1001, with offset -1100 mm -99.5 -> -100
+    dec.update(timedSample(900, 1000, DYP_R01CW_STATUS_OK));
+    dec.update(timedSample(1000, 1001, DYP_R01CW_STATUS_OK));
+    CHECK(dec.flush());
+    CHECK(r.mean == 1001 && r.samples == 2 && r.timestamp == 900);
+    CHECK(!dec.flush());
+    dec.setDistanceOffset(-1100);
+    dec.update(timedSample(1100, 1000, DYP_R01CW_STATUS_OK));
+    dec.update(timedSample(1200, 1001, DYP_R01CW_STATUS_OK));
+    CHECK(dec.flush());
+    CHECK(r.mean == -100 && r.min == -100 && r.max == -99);
+
+    // No valid sample
+    for (uint32_t i = 0; i < 4; i++) {
+        dec.update(timedSample(1300 + 100 * i, DYP_R01CW_RAW_INVALID, DYP_R01CW_STATUS_BUS_ERROR));
+    }
+    CHECK(r.samples == 4 && r.valid == 0);
+    CHECK(r.mean == 0 && r.min == 0 && r.max == 0);
+}
+
+static void checkPool() {
+    DYP_R01CW_Pool<DYP_R01CW_Sample, 3> pool;
+    CHECK(pool.available() == 3 && pool.used() == 0 && pool.highWater() == 0);
+
+    // Exhaustion
+    DYP_R01CW_Sample *a = pool.allocate();
+    DYP_R01CW_Sample *b = pool.allocate();
+    DYP_R01CW_Sample *c = pool.allocate();
+    CHECK(a != nullptr && b != nullptr && c != nullptr);
+    CHECK(a != b && b != c && a != c);
+    CHECK(pool.allocate() == nullptr);
+    CHECK(pool.failures() == 1);
+    CHECK(pool.used() == 3 && pool.available() == 0 && pool.highWater() == 3);
+
+    // Release and reuse
+    CHECK(pool.release(b));
+    CHECK(pool.used() == 2);
+    CHECK(pool.allocate() == b);
+
+    // Double release
+    CHECK(pool.release(a));
+    CHECK(!pool.release(a));
+    CHECK(pool.used() == 2 && pool.available() == 1);
+
+    // Foreign pointers: other pool, stack object, nullptr
+    DYP_R01CW_Pool<DYP_R01CW_Sample, 3> other;
+    DYP_R01CW_Sample *o = other.allocate();
+    DYP_R01CW_Sample local;
+    CHECK(!pool.release(o));
+    CHECK(!pool.release(&local));
+    CHECK(!pool.release(nullptr));
+    CHECK(pool.used() == 2 && other.used() == 1);
+
+    // Statistics
+    pool.resetStats();
+    CHECK(pool.highWater() == 2 && pool.failures() == 0);
+    CHECK(pool.release(b));
+    CHECK(pool.release(c));
+    CHECK(pool.used() == 0 && pool.highWater() == 2);
+}
+
+int main() {
+    checkFilterBankValues();
+    checkFilterBankVector();
+    checkKinematics();
+    checkTank();
+    checkOccupancy();
+    checkCounter();
+    checkEdge();
+    checkFusion();
+    checkCapture();
+    checkRate();
+    checkDecimator();
+    checkPool();
+
+    if (failures != 0) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed (filter bank: %s)\n", Bank::isa());
+    return 0;
+}
@@ -0,0 +1,33 @@
+/*!
+ * @file Arduino.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - host environment
+ *
+ * @section intro_sec Introduction
+ *
+ * Minimal Arduino core replacement for compiling the library on a host.
+ * Time functions are backed by the virtual clock DYP_R01CW_HostClock.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_HOST_ARDUINO_H
+#define DYP_R01CW_HOST_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+#endif // DYP_R01CW_HOST_ARDUINO_H
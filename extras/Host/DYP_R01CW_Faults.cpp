@@ -0,0 +1,188 @@
+/*!
+ * @file DYP_R01CW_Faults.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - bus fault injection
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Faults.h"
+
+/*!
+ * @brief Constructor
+ * @param inner Bus to forward transfers to
+ * @param seed PRNG seed
+ */
+DYP_R01CW_FaultBus::DYP_R01CW_FaultBus(DYP_R01CW_HostBus &inner, uint64_t seed) : _inner(inner), _rng(seed) {
+    _stuckUntil = 0;
+    _transfers = 0;
+    for (uint8_t i = 0; i < DYP_R01CW_FAULT_COUNT; i++) {
+        _injected[i] = 0;
+    }
+}
+
+/*!
+ * @brief Get the name of a fault type
+ * @param fault Fault type
+ * @return Name
+ */
+const char *DYP_R01CW_FaultBus::name(uint8_t fault) {
+    static const char *names[DYP_R01CW_FAULT_COUNT] = {"addr_nack", "data_nack", "short_read",
+                                                       "stuck_sda", "clock_stretch", "sensor_reset"};
+    return (fault < DYP_R01CW_FAULT_COUNT) ? names[fault] : "none";
+}
+
+/*!
+ * @brief Schedule a fault
+ * @param atUs Virtual time in microseconds
+ * @param fault Fault type
+ */
+void DYP_R01CW_FaultBus::schedule(uint64_t atUs, uint8_t fault) {
+    Scheduled s = {atUs, fault};
+    _schedule.push_back(s);
+}
+
+/*!
+ * @brief Check if a fault type applies to a transfer
+ * @note Sensor resets are only injected right after a trigger command, i.e. mid-conversion
+ */
+bool DYP_R01CW_FaultBus::applicable(uint8_t fault, bool isRead, size_t len, bool trigger) const {
+    switch (fault) {
+    case DYP_R01CW_FAULT_DATA_NACK:
+        return !isRead && len > 1;
+    case DYP_R01CW_FAULT_SHORT_READ:
+        return isRead && len > 0;
+    case DYP_R01CW_FAULT_SENSOR_RESET:
+        return trigger && !_sims.empty();
+    default:
+        return true;
+    }
+}
+
+/*!
+ * @brief Select the fault for the next transfer
+ * @param isRead true for a read transfer
+ * @param len Transfer length
+ * @param trigger true if the transfer starts a conversion
+ * @return Fault type, or DYP_R01CW_FAULT_COUNT for none
+ */
+uint8_t DYP_R01CW_FaultBus::pick(bool isRead, size_t len, bool trigger) {
+    // Scheduled faults take precedence; they wait for a transfer they apply to
+    uint64_t now = DYP_R01CW_HostClock::now();
+    for (size_t i = 0; i < _schedule.size(); i++) {
+        if (_schedule[i].at <= now && applicable(_schedule[i].fault, isRead, len, trigger)) {
+            uint8_t fault = _schedule[i].fault;
+            _schedule.erase(_schedule.begin() + i);
+            return fault;
+        }
+    }
+
+    // Draw for every enabled type, so the PRNG sequence does not depend on earlier outcomes
+    uint8_t fault = DYP_R01CW_FAULT_COUNT;
+    for (uint8_t i = 0; i < DYP_R01CW_FAULT_COUNT; i++) {
+        if (_cfg.ppm[i] > 0 && _rng.chance(_cfg.ppm[i]) && fault == DYP_R01CW_FAULT_COUNT &&
+            applicable(i, isRead, len, trigger)) {
+            fault = i;
+        }
+    }
+    return fault;
+}
+
+/*!
+ * @brief Reset the registered sensor at an address if its conversion is running
+ * @param addr 7-bit I2C address
+ * @return true if a sensor was reset
+ */
+bool DYP_R01CW_FaultBus::resetSensor(uint8_t addr) {
+    for (size_t i = 0; i < _sims.size(); i++) {
+        if (_sims[i]->address() == addr && _sims[i]->converting()) {
+            _sims[i]->brownout(_cfg.bootUs);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+ * @brief Begin a transfer: handle stuck-low SDA and select a fault
+ * @param isRead true for a read transfer
+ * @param len Transfer length
+ * @param trigger true if the transfer starts a conversion
+ * @return Fault type, DYP_R01CW_FAULT_STUCK_SDA if the transfer times out,
+ *         or DYP_R01CW_FAULT_COUNT for none
+ */
+uint8_t DYP_R01CW_FaultBus::start(bool isRead, size_t len, bool trigger) {
+    _transfers++;
+
+    if (DYP_R01CW_HostClock::now() < _stuckUntil) {
+        DYP_R01CW_HostClock::advance(_cfg.timeoutUs);
+        return DYP_R01CW_FAULT_STUCK_SDA;
+    }
+
+    uint8_t fault = pick(isRead, len, trigger);
+    switch (fault) {
+    case DYP_R01CW_FAULT_STUCK_SDA:
+        _injected[fault]++;
+        _stuckUntil = DYP_R01CW_HostClock::now() + _cfg.stuckUs;
+        DYP_R01CW_HostClock::advance(_cfg.timeoutUs);
+        break;
+    case DYP_R01CW_FAULT_CLOCK_STRETCH:
+        _injected[fault]++;
+        DYP_R01CW_HostClock::advance(_cfg.stretchUs);
+        break;
+    case DYP_R01CW_FAULT_ADDR_NACK:
+    case DYP_R01CW_FAULT_DATA_NACK:
+    case DYP_R01CW_FAULT_SHORT_READ:
+        _injected[fault]++;
+        break;
+    default:
+        break;
+    }
+    return fault;
+}
+
+uint8_t DYP_R01CW_FaultBus::write(uint8_t addr, const uint8_t *data, size_t len, bool stop) {
+    bool trigger = len >= 2 && data[0] == DYP_R01CW_COMMAND_REG && data[1] == DYP_R01CW_MEASURE_COMMAND;
+    switch (start(false, len, trigger)) {
+    case DYP_R01CW_FAULT_STUCK_SDA:
+        return DYP_R01CW_HOST_I2C_TIMEOUT;
+    case DYP_R01CW_FAULT_ADDR_NACK:
+        DYP_R01CW_HostClock::advance(_cfg.nackUs);
+        return DYP_R01CW_HOST_I2C_ADDR_NACK;
+    case DYP_R01CW_FAULT_DATA_NACK: {
+        // Only the register pointer reaches the device
+        uint8_t rc = _inner.write(addr, data, 1, stop);
+        return (rc == DYP_R01CW_HOST_I2C_OK) ? DYP_R01CW_HOST_I2C_DATA_NACK : rc;
+    }
+    case DYP_R01CW_FAULT_SENSOR_RESET: {
+        // The conversion starts, then the triggered sensor resets
+        uint8_t rc = _inner.write(addr, data, len, stop);
+        if (resetSensor(addr)) {
+            _injected[DYP_R01CW_FAULT_SENSOR_RESET]++;
+        }
+        return rc;
+    }
+    default:
+        return _inner.write(addr, data, len, stop);
+    }
+}
+
+size_t DYP_R01CW_FaultBus::read(uint8_t addr, uint8_t *buf, size_t len, bool stop) {
+    switch (start(true, len, false)) {
+    case DYP_R01CW_FAULT_STUCK_SDA:
+        return 0;
+    case DYP_R01CW_FAULT_ADDR_NACK:
+        DYP_R01CW_HostClock::advance(_cfg.nackUs);
+        return 0;
+    case DYP_R01CW_FAULT_SHORT_READ:
+        return _inner.read(addr, buf, _rng.below((uint32_t)len), stop);
+    default:
+        return _inner.read(addr, buf, len, stop);
+    }
+}
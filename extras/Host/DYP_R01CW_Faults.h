@@ -0,0 +1,157 @@
+/*!
+ * @file DYP_R01CW_Faults.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - bus fault injection
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_FaultBus wraps another DYP_R01CW_HostBus and injects faults
+ * into its transfers, either randomly at configured rates (per transfer) or
+ * at scheduled virtual times:
+ *
+ * - Address NACK: the transfer is not forwarded, endTransmission() returns 2
+ * - Data NACK: only the register pointer byte reaches the device, endTransmission() returns 3
+ * - Short read: fewer bytes than requested are returned
+ * - Stuck-low SDA: every transfer times out (endTransmission() returns 5) for a configured duration
+ * - Clock stretching: the transfer succeeds, but takes longer
+ * - Sensor reset mid-conversion: the triggered sensor (if registered) resets
+ *   right after its conversion started (conversion aborted, no ACK during
+ *   boot time); other sensors on the bus are not affected
+ *
+ * All randomness comes from a seeded PRNG, so fault sequences are reproducible.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_FAULTS_H
+#define DYP_R01CW_FAULTS_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "DYP_R01CW_Host.h"
+#include "DYP_R01CW_Sim.h"
+
+// Fault types
+#define DYP_R01CW_FAULT_ADDR_NACK 0      ///< Address not acknowledged
+#define DYP_R01CW_FAULT_DATA_NACK 1      ///< Data byte not acknowledged
+#define DYP_R01CW_FAULT_SHORT_READ 2     ///< Read returns fewer bytes
+#define DYP_R01CW_FAULT_STUCK_SDA 3      ///< SDA stuck low, transfers time out
+#define DYP_R01CW_FAULT_CLOCK_STRETCH 4  ///< Slave stretches the clock
+#define DYP_R01CW_FAULT_SENSOR_RESET 5   ///< Sensor resets during a conversion
+#define DYP_R01CW_FAULT_COUNT 6          ///< Number of fault types
+
+/*!
+ * @brief Fault injection parameters
+ */
+struct DYP_R01CW_FaultConfig {
+    uint32_t ppm[DYP_R01CW_FAULT_COUNT] = {};  ///< Fault probability per transfer (parts per million)
+    uint32_t nackUs = 100;                     ///< Duration of a NACKed transfer
+    uint32_t timeoutUs = 25000;                ///< Duration of a timed-out transfer
+    uint32_t stuckUs = 200000;                 ///< Duration of a stuck-low SDA condition
+    uint32_t stretchUs = 2000;                 ///< Additional duration of a stretched transfer
+    uint32_t bootUs = 1000000;                 ///< Sensor boot time after a reset
+};
+
+/*!
+ * @brief Fault-injecting bus wrapper
+ */
+class DYP_R01CW_FaultBus : public DYP_R01CW_HostBus {
+public:
+    /*!
+     * @brief Constructor
+     * @param inner Bus to forward transfers to (not owned)
+     * @param seed PRNG seed
+     */
+    DYP_R01CW_FaultBus(DYP_R01CW_HostBus &inner, uint64_t seed = 1);
+
+    /*!
+     * @brief Access fault parameters
+     * @return Parameters
+     */
+    DYP_R01CW_FaultConfig &config() { return _cfg; }
+
+    /*!
+     * @brief Reseed the fault PRNG
+     * @param seed Seed
+     */
+    void seed(uint64_t seed) { _rng.seed(seed); }
+
+    /*!
+     * @brief Register a simulated sensor for DYP_R01CW_FAULT_SENSOR_RESET
+     * @param sim Sensor (not owned)
+     */
+    void addSensor(DYP_R01CW_Sim *sim) { _sims.push_back(sim); }
+
+    /*!
+     * @brief Schedule a fault for the first suitable transfer at or after a virtual time
+     * @param atUs Virtual time in microseconds
+     * @param fault Fault type (DYP_R01CW_FAULT_*)
+     */
+    void schedule(uint64_t atUs, uint8_t fault);
+
+    /*!
+     * @brief Get the number of injected faults
+     * @param fault Fault type (DYP_R01CW_FAULT_*)
+     * @return Number of injected faults
+     */
+    uint64_t injected(uint8_t fault) const { return _injected[fault]; }
+
+    /*!
+     * @brief Get the number of transfers
+     * @return Number of transfers (including failed ones)
+     */
+    uint64_t transfers() const { return _transfers; }
+
+    /*!
+     * @brief Get the name of a fault type
+     * @param fault Fault type (DYP_R01CW_FAULT_*)
+     * @return Name
+     */
+    static const char *name(uint8_t fault);
+
+    uint8_t write(uint8_t addr, const uint8_t *data, size_t len, bool stop) override;
+    size_t read(uint8_t addr, uint8_t *buf, size_t len, bool stop) override;
+    void setClock(uint32_t hz) override { _inner.setClock(hz); }
+
+private:
+    /*!
+     * @brief Select the fault for the next transfer
+     * @param isRead true for a read transfer
+     * @param len Transfer length
+     * @param trigger true if the transfer starts a conversion
+     * @return Fault type, or DYP_R01CW_FAULT_COUNT for none
+     */
+    uint8_t pick(bool isRead, size_t len, bool trigger);
+
+    // Count the transfer, handle stuck-low SDA and apply timing faults
+    uint8_t start(bool isRead, size_t len, bool trigger);
+
+    // Check if a fault type applies to a transfer
+    bool applicable(uint8_t fault, bool isRead, size_t len, bool trigger) const;
+
+    // Reset the registered sensor at a 7-bit address if its conversion is running
+    bool resetSensor(uint8_t addr);
+
+    struct Scheduled {
+        uint64_t at;
+        uint8_t fault;
+    };
+
+    DYP_R01CW_HostBus &_inner;                   ///< Wrapped bus
+    DYP_R01CW_FaultConfig _cfg;                  ///< Parameters
+    DYP_R01CW_SimRandom _rng;                    ///< PRNG
+    std::vector<DYP_R01CW_Sim *> _sims;          ///< Sensors for reset faults
+    std::vector<Scheduled> _schedule;            ///< Pending scheduled faults
+    uint64_t _stuckUntil;                        ///< End of stuck-low SDA condition
+    uint64_t _injected[DYP_R01CW_FAULT_COUNT];   ///< Injected faults per type
+    uint64_t _transfers;                         ///< Transfers
+};
+
+#endif // DYP_R01CW_FAULTS_H
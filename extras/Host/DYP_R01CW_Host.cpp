@@ -0,0 +1,241 @@
+/*!
+ * @file DYP_R01CW_Host.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - host environment
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Host.h"
+
+#include "Arduino.h"
+#include "Wire.h"
+
+uint64_t DYP_R01CW_HostClock::_now = 0;
+
+TwoWire Wire;
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(DYP_R01CW_HostClock::now() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)DYP_R01CW_HostClock::now();
+}
+
+void delay(unsigned long ms) {
+    DYP_R01CW_HostClock::advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    DYP_R01CW_HostClock::advance(us);
+}
+
+void yield() {
+}
+
+/*!
+ * @brief Constructor
+ */
+TwoWire::TwoWire() {
+    _bus = nullptr;
+    _txAddr = 0;
+    _txLen = 0;
+    _txOverflow = false;
+    _rxLen = 0;
+    _rxPos = 0;
+}
+
+/*!
+ * @brief Begin transmission to a device
+ * @param address 7-bit address
+ */
+void TwoWire::beginTransmission(uint8_t address) {
+    _txAddr = address;
+    _txLen = 0;
+    _txOverflow = false;
+}
+
+/*!
+ * @brief Queue a byte for transmission
+ * @param data Byte
+ * @return 1 if queued, 0 if the buffer is full
+ */
+size_t TwoWire::write(uint8_t data) {
+    if (_txLen >= BUFFER_LENGTH) {
+        _txOverflow = true;
+        return 0;
+    }
+    _txBuf[_txLen++] = data;
+    return 1;
+}
+
+/*!
+ * @brief Queue bytes for transmission
+ * @param data Bytes
+ * @param quantity Number of bytes
+ * @return Number of bytes queued
+ */
+size_t TwoWire::write(const uint8_t *data, size_t quantity) {
+    size_t n = 0;
+    while (n < quantity && write(data[n])) {
+        n++;
+    }
+    return n;
+}
+
+/*!
+ * @brief Transmit queued bytes
+ * @param sendStop Send stop condition
+ * @return 0: success, 1: data too long, 2: address NACK, 3: data NACK, 4: other, 5: timeout
+ */
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    if (_txOverflow) {
+        return DYP_R01CW_HOST_I2C_TOO_LONG;
+    }
+    if (_bus == nullptr) {
+        return DYP_R01CW_HOST_I2C_OTHER;
+    }
+    return _bus->write(_txAddr, _txBuf, _txLen, sendStop);
+}
+
+/*!
+ * @brief Read bytes from a device
+ * @param address 7-bit address
+ * @param quantity Number of bytes
+ * @param sendStop Send stop condition
+ * @return Number of bytes received
+ */
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+    _rxLen = 0;
+    _rxPos = 0;
+    if (_bus == nullptr) {
+        return 0;
+    }
+    if (quantity > BUFFER_LENGTH) {
+        quantity = BUFFER_LENGTH;
+    }
+    _rxLen = _bus->read(address, _rxBuf, quantity, sendStop != 0);
+    return (uint8_t)_rxLen;
+}
+
+/*!
+ * @brief Get number of received bytes not read yet
+ * @return Number of bytes
+ */
+int TwoWire::available() {
+    return (int)(_rxLen - _rxPos);
+}
+
+/*!
+ * @brief Read a received byte
+ * @return Byte, or -1 if none is available
+ */
+int TwoWire::read() {
+    if (_rxPos >= _rxLen) {
+        return -1;
+    }
+    return _rxBuf[_rxPos++];
+}
+
+/*!
+ * @brief Set the bus clock frequency
+ * @param clock Clock frequency in Hz
+ */
+void TwoWire::setClock(uint32_t clock) {
+    if (_bus != nullptr) {
+        _bus->setClock(clock);
+    }
+}
+
+/*!
+ * @brief Constructor
+ * @param hz Bus clock frequency in Hz
+ */
+DYP_R01CW_SimBus::DYP_R01CW_SimBus(uint32_t hz) {
+    _count = 0;
+    _hz = hz;
+}
+
+/*!
+ * @brief Attach a device
+ * @param device Device (not owned)
+ * @return true if attached, false if the device table is full
+ */
+bool DYP_R01CW_SimBus::attach(DYP_R01CW_HostDevice *device) {
+    if (_count >= maxDevices) {
+        return false;
+    }
+    _devices[_count++] = device;
+    return true;
+}
+
+/*!
+ * @brief Find present device by 7-bit address
+ */
+DYP_R01CW_HostDevice *DYP_R01CW_SimBus::find(uint8_t addr) {
+    for (size_t i = 0; i < _count; i++) {
+        if (_devices[i]->address() == addr && _devices[i]->present()) {
+            return _devices[i];
+        }
+    }
+    return nullptr;
+}
+
+/*!
+ * @brief Get the duration of a transfer on the wire
+ * @param len Number of data bytes (without address byte)
+ * @return Duration in microseconds
+ */
+uint32_t DYP_R01CW_SimBus::transferTime(size_t len) const {
+    // Start + stop ~ 2 clock cycles, 9 cycles per byte (8 bits + ACK)
+    uint64_t cycles = 2 + 9 * (uint64_t)(len + 1);
+    return (uint32_t)((cycles * 1000000u + _hz - 1) / _hz);
+}
+
+/*!
+ * @brief Write transfer
+ * @param addr 7-bit address
+ * @param data Data bytes
+ * @param len Number of data bytes
+ * @param stop Send stop condition
+ * @return DYP_R01CW_HOST_I2C_* result code
+ */
+uint8_t DYP_R01CW_SimBus::write(uint8_t addr, const uint8_t *data, size_t len, bool stop) {
+    (void)stop;
+    DYP_R01CW_HostDevice *dev = find(addr);
+    if (dev == nullptr) {
+        DYP_R01CW_HostClock::advance(transferTime(0));
+        return DYP_R01CW_HOST_I2C_ADDR_NACK;
+    }
+    size_t acked = dev->write(data, len);
+    // Transfer ends after the first NACKed byte
+    DYP_R01CW_HostClock::advance(transferTime(acked < len ? acked + 1 : len));
+    return (acked < len) ? DYP_R01CW_HOST_I2C_DATA_NACK : DYP_R01CW_HOST_I2C_OK;
+}
+
+/*!
+ * @brief Read transfer
+ * @param addr 7-bit address
+ * @param buf Destination
+ * @param len Number of bytes requested
+ * @param stop Send stop condition
+ * @return Number of bytes received
+ */
+size_t DYP_R01CW_SimBus::read(uint8_t addr, uint8_t *buf, size_t len, bool stop) {
+    (void)stop;
+    DYP_R01CW_HostDevice *dev = find(addr);
+    if (dev == nullptr) {
+        DYP_R01CW_HostClock::advance(transferTime(0));
+        return 0;
+    }
+    size_t n = dev->read(buf, len);
+    DYP_R01CW_HostClock::advance(transferTime(len));
+    return n;
+}
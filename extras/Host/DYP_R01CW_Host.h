@@ -0,0 +1,177 @@
+/*!
+ * @file DYP_R01CW_Host.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - host environment
+ *
+ * @section intro_sec Introduction
+ *
+ * Minimal host environment for running the Arduino library code on Linux:
+ * a virtual clock behind millis()/micros()/delay() and a simulated I2C bus
+ * behind TwoWire (see Arduino.h and Wire.h in this directory).
+ *
+ * Time only advances when the code under test waits (delay()) or transfers
+ * data on the bus, so runs are deterministic and faster than real time.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_HOST_H
+#define DYP_R01CW_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// TwoWire::endTransmission() result codes
+#define DYP_R01CW_HOST_I2C_OK 0          ///< Success
+#define DYP_R01CW_HOST_I2C_TOO_LONG 1    ///< Data too long for transmit buffer
+#define DYP_R01CW_HOST_I2C_ADDR_NACK 2   ///< NACK on transmit of address
+#define DYP_R01CW_HOST_I2C_DATA_NACK 3   ///< NACK on transmit of data
+#define DYP_R01CW_HOST_I2C_OTHER 4       ///< Other error
+#define DYP_R01CW_HOST_I2C_TIMEOUT 5     ///< Timeout
+
+/*!
+ * @brief Virtual clock (microseconds, 64 bit)
+ */
+class DYP_R01CW_HostClock {
+public:
+    /*!
+     * @brief Get current time
+     * @return Time in microseconds
+     */
+    static uint64_t now() { return _now; }
+
+    /*!
+     * @brief Set current time
+     * @param us Time in microseconds
+     */
+    static void set(uint64_t us) { _now = us; }
+
+    /*!
+     * @brief Advance time
+     * @param us Duration in microseconds
+     */
+    static void advance(uint64_t us) { _now += us; }
+
+private:
+    static uint64_t _now;  ///< Current time in microseconds
+};
+
+/*!
+ * @brief Simulated I2C slave device
+ */
+class DYP_R01CW_HostDevice {
+public:
+    virtual ~DYP_R01CW_HostDevice() {}
+
+    /*!
+     * @brief Get the current I2C address
+     * @return 7-bit address
+     */
+    virtual uint8_t address() const = 0;
+
+    /*!
+     * @brief Check if the device acknowledges its address
+     * @return true if the address is acknowledged
+     */
+    virtual bool present() { return true; }
+
+    /*!
+     * @brief Receive a write transfer
+     * @param data Bytes after the address byte
+     * @param len Number of bytes
+     * @return Number of bytes acknowledged (len if all)
+     */
+    virtual size_t write(const uint8_t *data, size_t len) = 0;
+
+    /*!
+     * @brief Serve a read transfer
+     * @param buf Destination
+     * @param len Number of bytes requested
+     * @return Number of bytes supplied
+     */
+    virtual size_t read(uint8_t *buf, size_t len) = 0;
+};
+
+/*!
+ * @brief I2C bus as seen by TwoWire
+ */
+class DYP_R01CW_HostBus {
+public:
+    virtual ~DYP_R01CW_HostBus() {}
+
+    /*!
+     * @brief Write transfer (address + data)
+     * @param addr 7-bit address
+     * @param data Data bytes
+     * @param len Number of data bytes
+     * @param stop Send stop condition
+     * @return DYP_R01CW_HOST_I2C_* result code
+     */
+    virtual uint8_t write(uint8_t addr, const uint8_t *data, size_t len, bool stop) = 0;
+
+    /*!
+     * @brief Read transfer
+     * @param addr 7-bit address
+     * @param buf Destination
+     * @param len Number of bytes requested
+     * @param stop Send stop condition
+     * @return Number of bytes received
+     */
+    virtual size_t read(uint8_t addr, uint8_t *buf, size_t len, bool stop) = 0;
+
+    /*!
+     * @brief Set the bus clock frequency
+     * @param hz Clock frequency in Hz
+     */
+    virtual void setClock(uint32_t hz) { (void)hz; }
+};
+
+/*!
+ * @brief Simulated I2C bus routing transfers to attached devices
+ *
+ * Each transfer advances the virtual clock by its duration on the wire
+ * (9 clock cycles per byte including the address byte, plus start and stop).
+ */
+class DYP_R01CW_SimBus : public DYP_R01CW_HostBus {
+public:
+    /*!
+     * @brief Constructor
+     * @param hz Bus clock frequency in Hz (default: 100 kHz)
+     */
+    DYP_R01CW_SimBus(uint32_t hz = 100000);
+
+    /*!
+     * @brief Attach a device
+     * @param device Device (not owned)
+     * @return true if attached, false if the device table is full
+     */
+    bool attach(DYP_R01CW_HostDevice *device);
+
+    uint8_t write(uint8_t addr, const uint8_t *data, size_t len, bool stop) override;
+    size_t read(uint8_t addr, uint8_t *buf, size_t len, bool stop) override;
+    void setClock(uint32_t hz) override { _hz = hz; }
+
+    /*!
+     * @brief Get the duration of a transfer on the wire
+     * @param len Number of data bytes (without address byte)
+     * @return Duration in microseconds
+     */
+    uint32_t transferTime(size_t len) const;
+
+private:
+    // Find present device by 7-bit address
+    DYP_R01CW_HostDevice *find(uint8_t addr);
+
+    static const size_t maxDevices = 32;
+    DYP_R01CW_HostDevice *_devices[maxDevices];  ///< Attached devices
+    size_t _count;                               ///< Number of attached devices
+    uint32_t _hz;                                ///< Bus clock frequency
+};
+
+#endif // DYP_R01CW_HOST_H
@@ -0,0 +1,280 @@
+/*!
+ * @file DYP_R01CW_Sim.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - sensor simulator
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Sim.h"
+
+/*!
+ * @brief Get next 64-bit value
+ * @return Random value
+ */
+uint64_t DYP_R01CW_SimRandom::next() {
+    uint64_t z = (_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/*!
+ * @brief Get uniformly distributed value in [0, n)
+ * @param n Upper bound
+ * @return Random value
+ */
+uint32_t DYP_R01CW_SimRandom::below(uint32_t n) {
+    return (uint32_t)(((next() >> 32) * n) >> 32);
+}
+
+/*!
+ * @brief Random event
+ * @param ppm Probability in parts per million
+ * @return true with probability ppm / 1000000
+ */
+bool DYP_R01CW_SimRandom::chance(uint32_t ppm) {
+    if (ppm == 0) {
+        return false;
+    }
+    return below(1000000) < ppm;
+}
+
+/*!
+ * @brief Approximately normally distributed value
+ * @param sigma Standard deviation
+ * @return Random value with mean 0
+ */
+int32_t DYP_R01CW_SimRandom::normal(uint32_t sigma) {
+    if (sigma == 0) {
+        return 0;
+    }
+    // Sum of 12 uniform 16-bit values: mean 12 * 32768, standard deviation 65536
+    int64_t sum = 0;
+    for (int i = 0; i < 3; i++) {
+        uint64_t r = next();
+        for (int j = 0; j < 4; j++) {
+            sum += (r >> (16 * j)) & 0xFFFF;
+        }
+    }
+    return (int32_t)((sum - 12 * 32768) * (int64_t)sigma / 65536);
+}
+
+/*!
+ * @brief Constructor
+ */
+DYP_R01CW_SimTarget::DYP_R01CW_SimTarget() {
+    _periodMs = 0;
+}
+
+/*!
+ * @brief Add a keyframe
+ * @param timeMs Time in milliseconds
+ * @param distance Distance in millimeters, or DYP_R01CW_SIM_ABSENT
+ */
+void DYP_R01CW_SimTarget::addKey(uint32_t timeMs, int32_t distance) {
+    Key key = {timeMs, distance};
+    _keys.push_back(key);
+}
+
+/*!
+ * @brief Evaluate the trajectory
+ * @param timeMs Time in milliseconds
+ * @param distance Distance in millimeters
+ * @return true if the target is present, false otherwise
+ */
+bool DYP_R01CW_SimTarget::distanceAt(uint64_t timeMs, int32_t &distance) const {
+    if (_keys.empty()) {
+        return false;
+    }
+    uint64_t t = (_periodMs != 0) ? timeMs % _periodMs : timeMs;
+
+    if (t <= _keys.front().time) {
+        distance = _keys.front().distance;
+        return distance != DYP_R01CW_SIM_ABSENT;
+    }
+    if (t >= _keys.back().time) {
+        distance = _keys.back().distance;
+        return distance != DYP_R01CW_SIM_ABSENT;
+    }
+
+    size_t i = 0;
+    while (_keys[i + 1].time <= t) {
+        i++;
+    }
+    const Key &a = _keys[i];
+    const Key &b = _keys[i + 1];
+    if (a.distance == DYP_R01CW_SIM_ABSENT) {
+        return false;
+    }
+    if (b.distance == DYP_R01CW_SIM_ABSENT) {
+        // Target stays until it disappears
+        distance = a.distance;
+        return true;
+    }
+    distance = a.distance + (int32_t)((int64_t)(b.distance - a.distance) * (int64_t)(t - a.time) / (b.time - a.time));
+    return true;
+}
+
+/*!
+ * @brief Constructor
+ * @param addr I2C address in 8-bit format
+ * @param seed PRNG seed
+ */
+DYP_R01CW_Sim::DYP_R01CW_Sim(uint8_t addr, uint64_t seed) {
+    _addr = addr >> 1;
+    _conversions = 0;
+    _restarts = 0;
+    reset(seed);
+}
+
+/*!
+ * @brief Power-cycle the sensor
+ * @param seed PRNG seed
+ */
+void DYP_R01CW_Sim::reset(uint64_t seed) {
+    _rng.seed(seed);
+    _pointer = 0;
+    _data = 0xFFFF;
+    _pending = 0xFFFF;
+    _converting = false;
+    _doneAt = 0;
+    _offlineUntil = 0;
+}
+
+/*!
+ * @brief Reset the sensor without power cycle
+ * @param bootUs Time without ACK after the reset in microseconds
+ */
+void DYP_R01CW_Sim::brownout(uint32_t bootUs) {
+    _pointer = 0;
+    _data = 0xFFFF;
+    _converting = false;
+    _offlineUntil = DYP_R01CW_HostClock::now() + bootUs;
+    _restarts++;
+}
+
+/*!
+ * @brief Get the true distance at a time
+ * @param timeMs Time in milliseconds
+ * @return Distance in millimeters, or DYP_R01CW_SIM_ABSENT
+ */
+int32_t DYP_R01CW_Sim::trueDistance(uint64_t timeMs) const {
+    int32_t nearest = _cfg.background;
+    for (size_t i = 0; i < _targets.size(); i++) {
+        int32_t d;
+        if (_targets[i].distanceAt(timeMs, d) && (nearest == DYP_R01CW_SIM_ABSENT || d < nearest)) {
+            nearest = d;
+        }
+    }
+    return nearest;
+}
+
+/*!
+ * @brief Check if the device acknowledges its address
+ * @return false while restarting
+ */
+bool DYP_R01CW_Sim::present() {
+    return DYP_R01CW_HostClock::now() >= _offlineUntil;
+}
+
+/*!
+ * @brief Start a conversion
+ */
+void DYP_R01CW_Sim::startConversion() {
+    uint64_t now = DYP_R01CW_HostClock::now();
+    uint32_t latency = _cfg.latencyMinUs;
+    if (_cfg.latencyMaxUs > _cfg.latencyMinUs) {
+        latency += _rng.below(_cfg.latencyMaxUs - _cfg.latencyMinUs + 1);
+    }
+    if (_rng.chance(_cfg.stallPpm)) {
+        latency += _cfg.stallUs;
+    }
+
+    // Target position at the middle of the conversion
+    int32_t d = trueDistance((now + latency / 2) / 1000);
+    int32_t noise = 0;
+    if (d != DYP_R01CW_SIM_ABSENT) {
+        noise = _rng.normal(_cfg.noiseSigma + (uint32_t)((uint64_t)_cfg.noisePerMeter * d / 1000));
+    }
+    bool dropout = _rng.chance(_cfg.dropoutPpm);
+
+    if (d == DYP_R01CW_SIM_ABSENT || d > _cfg.maxRange || dropout) {
+        _pending = 0xFFFF;
+    } else {
+        int32_t v = d + noise;
+        _pending = (uint16_t)((v < 0) ? 0 : (v > 0xFFFE) ? 0xFFFE : v);
+    }
+    _converting = true;
+    _doneAt = now + latency;
+    _conversions++;
+}
+
+/*!
+ * @brief Latch a completed conversion into the data register
+ */
+void DYP_R01CW_Sim::update() {
+    if (_converting && DYP_R01CW_HostClock::now() >= _doneAt) {
+        _data = _pending;
+        _converting = false;
+    }
+}
+
+/*!
+ * @brief Receive a write transfer
+ * @param data Bytes after the address byte
+ * @param len Number of bytes
+ * @return Number of bytes acknowledged
+ */
+size_t DYP_R01CW_Sim::write(const uint8_t *data, size_t len) {
+    update();
+    if (len == 0) {
+        return 0;
+    }
+    _pointer = data[0];
+    if (len < 2) {
+        return len;
+    }
+
+    if (_pointer == DYP_R01CW_COMMAND_REG) {
+        if (data[1] == DYP_R01CW_MEASURE_COMMAND) {
+            startConversion();
+        } else if (len >= 3 && data[1] == DYP_R01CW_RESTART_COMMAND_1 && data[2] == DYP_R01CW_RESTART_COMMAND_2) {
+            brownout(_cfg.restartUs);
+        }
+    } else if (_pointer == DYP_R01CW_SLAVE_ADDR_REG) {
+        if (DYP_R01CW_isValidAddress(data[1])) {
+            _addr = data[1] >> 1;
+        }
+    }
+
+    return len;
+}
+
+/*!
+ * @brief Serve a read transfer
+ * @param buf Destination
+ * @param len Number of bytes requested
+ * @return Number of bytes supplied
+ */
+size_t DYP_R01CW_Sim::read(uint8_t *buf, size_t len) {
+    update();
+
+    uint16_t value = 0xFFFF;
+    if (_pointer == DYP_R01CW_VERSION_REG) {
+        value = _cfg.version;
+    } else if (_pointer == DYP_R01CW_DATA_REG) {
+        value = _data;
+    }
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (i == 0) ? (value >> 8) : (i == 1) ? (value & 0xFF) : 0xFF;
+    }
+
+    return len;
+}
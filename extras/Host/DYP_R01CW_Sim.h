@@ -0,0 +1,237 @@
+/*!
+ * @file DYP_R01CW_Sim.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - sensor simulator
+ *
+ * @section intro_sec Introduction
+ *
+ * Simulated DYP-R01CW sensor for DYP_R01CW_SimBus. The device answers the
+ * register protocol of the real sensor:
+ *
+ * - VERSION_REG: 16-bit software version (big-endian)
+ * - COMMAND_REG: MEASURE_COMMAND starts a conversion; RESTART_COMMAND_1,
+ *   RESTART_COMMAND_2 restarts the sensor (no ACK until the restart time has
+ *   elapsed, measurement data reset to 0xFFFF)
+ * - DATA_REG: 16-bit distance of the last completed conversion (big-endian);
+ *   reading before the current conversion has completed returns the previous value
+ * - SLAVE_ADDR_REG: changes the I2C address (supported addresses only)
+ *
+ * Distances are taken from scripted target trajectories (piecewise linear
+ * keyframes; the nearest present target wins) at the middle of the
+ * conversion, with configurable Gaussian noise, dropouts to 0xFFFF and a
+ * conversion latency distribution (uniform range plus rare stalls).
+ * All randomness comes from a seeded integer PRNG and all arithmetic is
+ * integer, so runs on the virtual clock are bit-for-bit reproducible.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_SIM_H
+#define DYP_R01CW_SIM_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "DYP_R01CW_Host.h"
+#include "DYP_R01CW_Registers.h"
+
+// Keyframe distance marking an absent target
+#define DYP_R01CW_SIM_ABSENT (-1)
+
+/*!
+ * @brief Deterministic pseudo random number generator (SplitMix64)
+ */
+class DYP_R01CW_SimRandom {
+public:
+    /*!
+     * @brief Constructor
+     * @param seed Seed
+     */
+    DYP_R01CW_SimRandom(uint64_t seed = 1) : _state(seed) {}
+
+    /*!
+     * @brief Reseed
+     * @param seed Seed
+     */
+    void seed(uint64_t seed) { _state = seed; }
+
+    /*!
+     * @brief Get next 64-bit value
+     * @return Random value
+     */
+    uint64_t next();
+
+    /*!
+     * @brief Get uniformly distributed value in [0, n)
+     * @param n Upper bound (> 0)
+     * @return Random value
+     */
+    uint32_t below(uint32_t n);
+
+    /*!
+     * @brief Random event
+     * @param ppm Probability in parts per million
+     * @return true with probability ppm / 1000000
+     */
+    bool chance(uint32_t ppm);
+
+    /*!
+     * @brief Approximately normally distributed value (Irwin-Hall, 12 uniforms)
+     * @param sigma Standard deviation
+     * @return Random value with mean 0
+     */
+    int32_t normal(uint32_t sigma);
+
+private:
+    uint64_t _state;  ///< Generator state
+};
+
+/*!
+ * @brief Scripted target trajectory
+ */
+class DYP_R01CW_SimTarget {
+public:
+    DYP_R01CW_SimTarget();
+
+    /*!
+     * @brief Add a keyframe (keyframes must be added in time order)
+     * @param timeMs Time in milliseconds
+     * @param distance Distance in millimeters, or DYP_R01CW_SIM_ABSENT
+     */
+    void addKey(uint32_t timeMs, int32_t distance);
+
+    /*!
+     * @brief Repeat the trajectory
+     * @param periodMs Repeat period in milliseconds (0: no repetition)
+     */
+    void setLoop(uint32_t periodMs) { _periodMs = periodMs; }
+
+    /*!
+     * @brief Evaluate the trajectory
+     * @param timeMs Time in milliseconds
+     * @param distance Distance in millimeters (linear interpolation between keyframes)
+     * @return true if the target is present, false otherwise
+     */
+    bool distanceAt(uint64_t timeMs, int32_t &distance) const;
+
+private:
+    struct Key {
+        uint32_t time;
+        int32_t distance;
+    };
+    std::vector<Key> _keys;  ///< Keyframes
+    uint32_t _periodMs;      ///< Repeat period
+};
+
+/*!
+ * @brief Simulation parameters
+ */
+struct DYP_R01CW_SimConfig {
+    uint16_t version = 0x0102;          ///< Software version reported in VERSION_REG
+    int32_t background = DYP_R01CW_SIM_ABSENT; ///< Distance if no target is present
+    int32_t maxRange = 4000;            ///< Maximum range in millimeters (beyond: 0xFFFF)
+    uint32_t noiseSigma = 0;            ///< Noise standard deviation in millimeters
+    uint32_t noisePerMeter = 0;         ///< Additional noise standard deviation per meter of distance
+    uint32_t dropoutPpm = 0;            ///< Probability of a 0xFFFF result
+    uint32_t latencyMinUs = 30000;      ///< Minimum conversion time
+    uint32_t latencyMaxUs = 45000;      ///< Maximum conversion time (uniform distribution)
+    uint32_t stallPpm = 0;              ///< Probability of a stalled conversion
+    uint32_t stallUs = 0;               ///< Additional conversion time of a stall
+    uint32_t restartUs = 1000000;       ///< Time without ACK after restart
+};
+
+/*!
+ * @brief Simulated DYP-R01CW sensor
+ */
+class DYP_R01CW_Sim : public DYP_R01CW_HostDevice {
+public:
+    /*!
+     * @brief Constructor
+     * @param addr I2C address in 8-bit format (default: 0xE8)
+     * @param seed PRNG seed
+     */
+    DYP_R01CW_Sim(uint8_t addr = DYP_R01CW_DEFAULT_ADDR, uint64_t seed = 1);
+
+    /*!
+     * @brief Access simulation parameters
+     * @return Parameters
+     */
+    DYP_R01CW_SimConfig &config() { return _cfg; }
+
+    /*!
+     * @brief Add a target
+     * @param target Target trajectory (copied)
+     */
+    void addTarget(const DYP_R01CW_SimTarget &target) { _targets.push_back(target); }
+
+    /*!
+     * @brief Power-cycle the sensor: clear data and pending conversion, reseed PRNG
+     * @param seed PRNG seed
+     */
+    void reset(uint64_t seed);
+
+    /*!
+     * @brief Reset the sensor without power cycle (e.g. brown-out or watchdog)
+     * @param bootUs Time without ACK after the reset in microseconds
+     * @note Aborts a running conversion and clears the data register; the PRNG state is kept
+     */
+    void brownout(uint32_t bootUs);
+
+    /*!
+     * @brief Check if a conversion is running
+     * @return true if a conversion is running
+     */
+    bool converting() const { return _converting && DYP_R01CW_HostClock::now() < _doneAt; }
+
+    /*!
+     * @brief Get the true (noise-free) distance at a time
+     * @param timeMs Time in milliseconds
+     * @return Distance in millimeters, or DYP_R01CW_SIM_ABSENT
+     */
+    int32_t trueDistance(uint64_t timeMs) const;
+
+    /*!
+     * @brief Get the number of started conversions
+     * @return Number of conversions
+     */
+    uint32_t conversions() const { return _conversions; }
+
+    /*!
+     * @brief Get the number of restarts
+     * @return Number of restarts
+     */
+    uint32_t restarts() const { return _restarts; }
+
+    uint8_t address() const override { return _addr; }
+    bool present() override;
+    size_t write(const uint8_t *data, size_t len) override;
+    size_t read(uint8_t *buf, size_t len) override;
+
+private:
+    // Start a conversion
+    void startConversion();
+
+    // Latch a completed conversion into the data register
+    void update();
+
+    DYP_R01CW_SimConfig _cfg;                 ///< Parameters
+    std::vector<DYP_R01CW_SimTarget> _targets; ///< Scene
+    DYP_R01CW_SimRandom _rng;                 ///< PRNG
+    uint8_t _addr;                            ///< 7-bit address
+    uint8_t _pointer;                         ///< Register pointer
+    uint16_t _data;                           ///< DATA_REG contents
+    uint16_t _pending;                        ///< Result of running conversion
+    bool _converting;                         ///< Conversion running
+    uint64_t _doneAt;                         ///< Conversion completion time (us)
+    uint64_t _offlineUntil;                   ///< End of restart (us)
+    uint32_t _conversions;                    ///< Started conversions
+    uint32_t _restarts;                       ///< Restarts
+};
+
+#endif // DYP_R01CW_SIM_H
@@ -0,0 +1,60 @@
+/*!
+ * @file DYP_R01CW_Trace.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - bus transaction recorder
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Trace.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+/*!
+ * @brief Clear the trace and set the time origin
+ */
+void DYP_R01CW_TraceBus::mark() {
+    _origin = DYP_R01CW_HostClock::now();
+    _transfers = 0;
+    _text.clear();
+}
+
+uint8_t DYP_R01CW_TraceBus::write(uint8_t addr, const uint8_t *data, size_t len, bool stop) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "+%" PRIu64 " W %02X", elapsed(), addr);
+    _text += buf;
+    for (size_t i = 0; i < len; i++) {
+        snprintf(buf, sizeof(buf), " %02X", data[i]);
+        _text += buf;
+    }
+
+    uint8_t rc = _inner.write(addr, data, len, stop);
+
+    snprintf(buf, sizeof(buf), " %s -> %u\n", stop ? "stop" : "rs", rc);
+    _text += buf;
+    _transfers++;
+    return rc;
+}
+
+size_t DYP_R01CW_TraceBus::read(uint8_t addr, uint8_t *buf, size_t len, bool stop) {
+    char line[48];
+    snprintf(line, sizeof(line), "+%" PRIu64 " R %02X %zu %s ->", elapsed(), addr, len, stop ? "stop" : "rs");
+    _text += line;
+
+    size_t n = _inner.read(addr, buf, len, stop);
+
+    for (size_t i = 0; i < n; i++) {
+        snprintf(line, sizeof(line), " %02X", buf[i]);
+        _text += line;
+    }
+    _text += '\n';
+    _transfers++;
+    return n;
+}
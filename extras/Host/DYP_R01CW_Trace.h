@@ -0,0 +1,81 @@
+/*!
+ * @file DYP_R01CW_Trace.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - bus transaction recorder
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_TraceBus wraps another DYP_R01CW_HostBus and records every
+ * transfer as one line of text:
+ *
+ *   +<us> W <addr> <bytes...> stop|rs -> <result>
+ *   +<us> R <addr> <len> stop|rs -> <bytes...>
+ *
+ * where <us> is the virtual time since mark() at the start of the transfer,
+ * <addr> the 7-bit address and "rs" a transfer ending without stop
+ * condition (repeated start follows). All numbers except <us> and <len> are
+ * hexadecimal.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_TRACE_H
+#define DYP_R01CW_TRACE_H
+
+#include <stdint.h>
+#include <string>
+
+#include "DYP_R01CW_Host.h"
+
+/*!
+ * @brief Recording bus wrapper
+ */
+class DYP_R01CW_TraceBus : public DYP_R01CW_HostBus {
+public:
+    /*!
+     * @brief Constructor
+     * @param inner Bus to forward transfers to (not owned)
+     */
+    DYP_R01CW_TraceBus(DYP_R01CW_HostBus &inner) : _inner(inner), _origin(0), _transfers(0) {}
+
+    /*!
+     * @brief Clear the trace and set the time origin to the current virtual time
+     */
+    void mark();
+
+    /*!
+     * @brief Get the recorded trace
+     * @return Trace, one line per transfer
+     */
+    const std::string &text() const { return _text; }
+
+    /*!
+     * @brief Get the number of recorded transfers
+     * @return Number of transfers since mark()
+     */
+    uint32_t transfers() const { return _transfers; }
+
+    /*!
+     * @brief Get the virtual time since mark()
+     * @return Elapsed time in microseconds
+     */
+    uint64_t elapsed() const { return DYP_R01CW_HostClock::now() - _origin; }
+
+    uint8_t write(uint8_t addr, const uint8_t *data, size_t len, bool stop) override;
+    size_t read(uint8_t addr, uint8_t *buf, size_t len, bool stop) override;
+    void setClock(uint32_t hz) override { _inner.setClock(hz); }
+
+private:
+    DYP_R01CW_HostBus &_inner;  ///< Wrapped bus
+    uint64_t _origin;           ///< Time origin
+    uint32_t _transfers;        ///< Transfers since mark()
+    std::string _text;          ///< Trace
+};
+
+#endif // DYP_R01CW_TRACE_H
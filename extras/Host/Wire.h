@@ -0,0 +1,72 @@
+/*!
+ * @file Wire.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - host environment
+ *
+ * @section intro_sec Introduction
+ *
+ * TwoWire replacement for compiling the library on a host. Transfers are
+ * forwarded to a DYP_R01CW_HostBus (e.g. DYP_R01CW_SimBus) set with setBus().
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_HOST_WIRE_H
+#define DYP_R01CW_HOST_WIRE_H
+
+#include "Arduino.h"
+#include "DYP_R01CW_Host.h"
+
+// Transmit/receive buffer size (as on AVR)
+#define BUFFER_LENGTH 32
+
+/*!
+ * @brief Host implementation of the Arduino TwoWire API
+ */
+class TwoWire {
+public:
+    TwoWire();
+
+    /*!
+     * @brief Connect to a bus
+     * @param bus Bus (not owned), nullptr to disconnect
+     */
+    void setBus(DYP_R01CW_HostBus *bus) { _bus = bus; }
+
+    /*!
+     * @brief Get the connected bus
+     * @return Bus, or nullptr
+     */
+    DYP_R01CW_HostBus *getBus() const { return _bus; }
+
+    void begin() {}
+    void end() {}
+    void setClock(uint32_t clock);
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t quantity);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = 1);
+    int available();
+    int read();
+
+private:
+    DYP_R01CW_HostBus *_bus;       ///< Connected bus
+    uint8_t _txAddr;               ///< Transmit address
+    uint8_t _txBuf[BUFFER_LENGTH]; ///< Transmit buffer
+    size_t _txLen;                 ///< Transmit buffer fill level
+    bool _txOverflow;              ///< Transmit buffer overflow
+    uint8_t _rxBuf[BUFFER_LENGTH]; ///< Receive buffer
+    size_t _rxLen;                 ///< Receive buffer fill level
+    size_t _rxPos;                 ///< Receive buffer read position
+};
+
+extern TwoWire Wire;
+
+#endif // DYP_R01CW_HOST_WIRE_H
@@ -0,0 +1,219 @@
+/*!
+ * @file dyp_fault_bench.cpp
+ *
+ * @brief Measure DYP-R01CW error recovery under injected bus faults
+ *
+ * Runs DYP_R01CW::readSample() in a loop against a simulated sensor behind a
+ * fault-injecting bus (DYP_R01CW_FaultBus) and reports:
+ *
+ * - throughput: valid samples per second of virtual time, and simulated
+ *   cycles per second of host time
+ * - error rate per sample status
+ * - recovery latency: virtual time from the start of the first failed cycle
+ *   to the end of the next successful one (mean, p99, max)
+ *
+ * Fault rates are given in parts per million per transfer. Faults can also
+ * be scheduled at fixed virtual times with -F <time_ms>:<type>, where type is
+ * one of addr_nack, data_nack, short_read, stuck_sda, clock_stretch,
+ * sensor_reset. With -k, the sensor is restarted after k consecutive failed
+ * cycles (restart() plus begin()).
+ *
+ * Usage:
+ *   dyp_fault_bench [-n cycles] [-s seed] [-p period_ms] [-A ppm] [-D ppm] [-S ppm]
+ *                   [-L ppm] [-l stuck_us] [-C ppm] [-c stretch_us] [-R ppm]
+ *                   [-F time_ms:type]... [-k failures]
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I. -I../../src dyp_fault_bench.cpp DYP_R01CW_Faults.cpp DYP_R01CW_Sim.cpp \
+ *       DYP_R01CW_Host.cpp ../../src/DYP_R01CW.cpp ../../src/DYP_R01CW_Processing.cpp -o dyp_fault_bench
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Arduino.h"
+#include "DYP_R01CW.h"
+#include "DYP_R01CW_Faults.h"
+#include "DYP_R01CW_Sim.h"
+#include "Wire.h"
+
+static const char *usage = "Usage: dyp_fault_bench [-n cycles] [-s seed] [-p period_ms] [-A ppm] [-D ppm] [-S ppm]\n"
+                           "                       [-L ppm] [-l stuck_us] [-C ppm] [-c stretch_us] [-R ppm]\n"
+                           "                       [-F time_ms:type]... [-k failures]\n";
+
+static bool parseSchedule(const char *arg, DYP_R01CW_FaultBus &faults) {
+    const char *colon = strchr(arg, ':');
+    if (colon == nullptr) {
+        return false;
+    }
+    uint64_t atMs = strtoull(arg, nullptr, 0);
+    for (uint8_t i = 0; i < DYP_R01CW_FAULT_COUNT; i++) {
+        if (strcmp(colon + 1, DYP_R01CW_FaultBus::name(i)) == 0) {
+            faults.schedule(atMs * 1000, i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    uint64_t cycles = 100000;
+    uint64_t seed = 1;
+    uint32_t periodMs = 0;
+    uint32_t restartAfter = 0;
+
+    DYP_R01CW_HostClock::set(0);
+    DYP_R01CW_SimBus bus;
+    DYP_R01CW_Sim sim(DYP_R01CW_DEFAULT_ADDR, seed);
+    sim.config().background = 1000;
+    bus.attach(&sim);
+    DYP_R01CW_FaultBus faults(bus, seed);
+    faults.addSensor(&sim);
+    DYP_R01CW_FaultConfig &fc = faults.config();
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:p:A:D:S:L:l:C:c:R:F:k:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            cycles = strtoull(optarg, nullptr, 0);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 0);
+            break;
+        case 'p':
+            periodMs = (uint32_t)atoi(optarg);
+            break;
+        case 'A':
+            fc.ppm[DYP_R01CW_FAULT_ADDR_NACK] = (uint32_t)atoi(optarg);
+            break;
+        case 'D':
+            fc.ppm[DYP_R01CW_FAULT_DATA_NACK] = (uint32_t)atoi(optarg);
+            break;
+        case 'S':
+            fc.ppm[DYP_R01CW_FAULT_SHORT_READ] = (uint32_t)atoi(optarg);
+            break;
+        case 'L':
+            fc.ppm[DYP_R01CW_FAULT_STUCK_SDA] = (uint32_t)atoi(optarg);
+            break;
+        case 'l':
+            fc.stuckUs = (uint32_t)atoi(optarg);
+            break;
+        case 'C':
+            fc.ppm[DYP_R01CW_FAULT_CLOCK_STRETCH] = (uint32_t)atoi(optarg);
+            break;
+        case 'c':
+            fc.stretchUs = (uint32_t)atoi(optarg);
+            break;
+        case 'R':
+            fc.ppm[DYP_R01CW_FAULT_SENSOR_RESET] = (uint32_t)atoi(optarg);
+            break;
+        case 'F':
+            if (!parseSchedule(optarg, faults)) {
+                fprintf(stderr, "invalid schedule entry %s\n", optarg);
+                return 2;
+            }
+            break;
+        case 'k':
+            restartAfter = (uint32_t)atoi(optarg);
+            break;
+        default:
+            fputs(usage, stderr);
+            return 2;
+        }
+    }
+
+    // Reseed after option parsing; the fault PRNG is independent of the sensor's
+    sim.reset(seed);
+    faults.seed(seed ^ 0x9E3779B97F4A7C15ull);
+    Wire.setBus(&faults);
+
+    DYP_R01CW sensor;
+    if (!sensor.begin()) {
+        fprintf(stderr, "begin() failed\n");
+        return 1;
+    }
+
+    uint64_t statusCount[4] = {};
+    uint64_t valid = 0;
+    uint64_t restarts = 0;
+    uint32_t failures = 0;
+    uint64_t failStart = 0;
+    std::vector<uint64_t> recovery;
+
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t v0 = DYP_R01CW_HostClock::now();
+    for (uint64_t n = 0; n < cycles; n++) {
+        uint64_t cycleStart = DYP_R01CW_HostClock::now();
+        DYP_R01CW_Sample s;
+        bool ok = sensor.readSample(s);
+        statusCount[s.status & 3]++;
+        if (ok) {
+            valid++;
+            if (failures > 0) {
+                recovery.push_back(DYP_R01CW_HostClock::now() - failStart);
+                failures = 0;
+            }
+        } else {
+            if (failures++ == 0) {
+                failStart = cycleStart;
+            }
+            if (restartAfter > 0 && failures % restartAfter == 0) {
+                sensor.restart();
+                restarts++;
+                delay(DYP_R01CW_CONVERSION_TIME_MS);
+            }
+        }
+        uint64_t elapsed = DYP_R01CW_HostClock::now() - cycleStart;
+        if ((uint64_t)periodMs * 1000 > elapsed) {
+            DYP_R01CW_HostClock::advance((uint64_t)periodMs * 1000 - elapsed);
+        }
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double virt = (DYP_R01CW_HostClock::now() - v0) / 1e6;
+
+    printf("cycles          %" PRIu64 "\n", cycles);
+    printf("virtual time    %.1f s\n", virt);
+    printf("host time       %.3f s (%.0f cycles/s)\n", wall, wall > 0 ? cycles / wall : 0.0);
+    printf("throughput      %.2f valid samples/s\n", virt > 0 ? valid / virt : 0.0);
+    printf("status          ok %" PRIu64 ", bus_error %" PRIu64 ", short_read %" PRIu64 ", invalid %" PRIu64 "\n",
+           statusCount[DYP_R01CW_STATUS_OK], statusCount[DYP_R01CW_STATUS_BUS_ERROR],
+           statusCount[DYP_R01CW_STATUS_SHORT_READ], statusCount[DYP_R01CW_STATUS_INVALID]);
+    printf("error rate      %.4f %%\n", cycles ? 100.0 * (cycles - valid) / cycles : 0.0);
+    printf("transfers       %" PRIu64 "\n", faults.transfers());
+    for (uint8_t i = 0; i < DYP_R01CW_FAULT_COUNT; i++) {
+        printf("  %-13s %" PRIu64 "\n", DYP_R01CW_FaultBus::name(i), faults.injected(i));
+    }
+    printf("sensor resets   %" PRIu32 " (restart() calls %" PRIu64 ")\n", sim.restarts(), restarts);
+    if (recovery.empty()) {
+        printf("recovery        -\n");
+    } else {
+        std::sort(recovery.begin(), recovery.end());
+        uint64_t sum = 0;
+        for (uint64_t r : recovery) {
+            sum += r;
+        }
+        size_t p99 = (recovery.size() * 99 + 99) / 100 - 1;
+        printf("recovery        %zu episodes, mean %.1f ms, p99 %.1f ms, max %.1f ms\n", recovery.size(),
+               sum / 1e3 / recovery.size(), recovery[p99] / 1e3, recovery.back() / 1e3);
+    }
+    if (failures > 0) {
+        printf("unrecovered     %" PRIu32 " failed cycles at end of run\n", failures);
+    }
+
+    return 0;
+}
@@ -0,0 +1,244 @@
+/*!
+ * @file dyp_sim.cpp
+ *
+ * @brief Generate DYP-R01CW sample logs from a simulated scene
+ *
+ * Runs the Arduino library (DYP_R01CW::readSample()) against simulated
+ * sensors (DYP_R01CW_Sim) on the virtual clock and writes the samples as a
+ * binary log (see DYP_R01CW_Log.h) or as CSV. Identical scene, seed and
+ * options always produce an identical output; the FNV-1a checksum printed
+ * to stderr can be used to verify this.
+ *
+ * Usage:
+ *   dyp_sim [-s seed] [-n samples] [-a addr]... [-p period_ms] [-o out.log] scene
+ *
+ * Scene file (one directive per line, '#' starts a comment):
+ *   version <value>              software version reported by the sensor
+ *   background <mm>|off          distance if no target is present
+ *   maxrange <mm>                beyond this range the sensor reports 0xFFFF
+ *   noise <sigma_mm> [per_m]     Gaussian noise, optionally growing per meter
+ *   dropout <ppm>                probability of a 0xFFFF result
+ *   latency <min_us> <max_us>    conversion time (uniform)
+ *   stall <ppm> <us>             probability and extra time of a stalled conversion
+ *   restart <us>                 time without ACK after restart
+ *   target [loop <period_ms>]    start a new target trajectory
+ *   <time_ms> <mm>|off           keyframe of the current target
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I. -I../../src dyp_sim.cpp DYP_R01CW_Sim.cpp DYP_R01CW_Host.cpp \
+ *       ../../src/DYP_R01CW.cpp ../../src/DYP_R01CW_Log.cpp ../../src/DYP_R01CW_Processing.cpp -o dyp_sim
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "DYP_R01CW.h"
+#include "DYP_R01CW_Log.h"
+#include "DYP_R01CW_Sim.h"
+#include "Wire.h"
+
+/*!
+ * @brief Parsed scene
+ */
+struct Scene {
+    DYP_R01CW_SimConfig cfg;
+    std::vector<DYP_R01CW_SimTarget> targets;
+};
+
+static bool parseDistance(const std::string &s, int32_t &d) {
+    if (s == "off") {
+        d = DYP_R01CW_SIM_ABSENT;
+        return true;
+    }
+    char *end;
+    d = (int32_t)strtol(s.c_str(), &end, 0);
+    return *end == '\0' && d >= 0;
+}
+
+static bool loadScene(const char *path, Scene &scene) {
+    FILE *f = fopen(path, "r");
+    if (f == nullptr) {
+        perror(path);
+        return false;
+    }
+    char buf[256];
+    int lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(buf, sizeof(buf), f) != nullptr) {
+        lineNo++;
+        std::string line(buf);
+        line = line.substr(0, line.find('#'));
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key)) {
+            continue;
+        }
+        std::string a, b;
+        in >> a >> b;
+        DYP_R01CW_SimConfig &c = scene.cfg;
+        if (key == "version") {
+            c.version = (uint16_t)strtoul(a.c_str(), nullptr, 0);
+        } else if (key == "background") {
+            ok = parseDistance(a, c.background);
+        } else if (key == "maxrange") {
+            c.maxRange = atoi(a.c_str());
+        } else if (key == "noise") {
+            c.noiseSigma = (uint32_t)atoi(a.c_str());
+            c.noisePerMeter = b.empty() ? 0 : (uint32_t)atoi(b.c_str());
+        } else if (key == "dropout") {
+            c.dropoutPpm = (uint32_t)atoi(a.c_str());
+        } else if (key == "latency") {
+            c.latencyMinUs = (uint32_t)atoi(a.c_str());
+            c.latencyMaxUs = b.empty() ? c.latencyMinUs : (uint32_t)atoi(b.c_str());
+        } else if (key == "stall") {
+            c.stallPpm = (uint32_t)atoi(a.c_str());
+            c.stallUs = (uint32_t)atoi(b.c_str());
+        } else if (key == "restart") {
+            c.restartUs = (uint32_t)atoi(a.c_str());
+        } else if (key == "target") {
+            scene.targets.emplace_back();
+            if (a == "loop") {
+                scene.targets.back().setLoop((uint32_t)atoi(b.c_str()));
+            }
+        } else if (isdigit((unsigned char)key[0]) && !scene.targets.empty()) {
+            int32_t d;
+            ok = parseDistance(a, d);
+            scene.targets.back().addKey((uint32_t)strtoul(key.c_str(), nullptr, 0), d);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "%s:%d: syntax error\n", path, lineNo);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    uint64_t seed = 1;
+    uint64_t samples = 1000;
+    uint32_t periodMs = 0;
+    std::vector<uint8_t> addrs;
+    const char *outPath = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:n:a:p:o:h")) != -1) {
+        switch (opt) {
+        case 's':
+            seed = strtoull(optarg, nullptr, 0);
+            break;
+        case 'n':
+            samples = strtoull(optarg, nullptr, 0);
+            break;
+        case 'a':
+            addrs.push_back((uint8_t)strtoul(optarg, nullptr, 0));
+            break;
+        case 'p':
+            periodMs = (uint32_t)atoi(optarg);
+            break;
+        case 'o':
+            outPath = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: dyp_sim [-s seed] [-n samples] [-a addr]... [-p period_ms] [-o out.log] scene\n");
+            return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Usage: dyp_sim [-s seed] [-n samples] [-a addr]... [-p period_ms] [-o out.log] scene\n");
+        return 2;
+    }
+    if (addrs.empty()) {
+        addrs.push_back(DYP_R01CW_DEFAULT_ADDR);
+    }
+
+    Scene scene;
+    if (!loadScene(argv[optind], scene)) {
+        return 1;
+    }
+
+    DYP_R01CW_HostClock::set(0);
+    DYP_R01CW_SimBus bus;
+    Wire.setBus(&bus);
+
+    std::vector<std::unique_ptr<DYP_R01CW_Sim>> sims;
+    std::vector<std::unique_ptr<DYP_R01CW>> sensors;
+    for (size_t i = 0; i < addrs.size(); i++) {
+        sims.emplace_back(new DYP_R01CW_Sim(addrs[i], seed + i));
+        sims.back()->config() = scene.cfg;
+        for (const DYP_R01CW_SimTarget &t : scene.targets) {
+            sims.back()->addTarget(t);
+        }
+        bus.attach(sims.back().get());
+        sensors.emplace_back(new DYP_R01CW(addrs[i]));
+        if (!sensors.back()->begin()) {
+            fprintf(stderr, "sensor 0x%02X: begin() failed\n", addrs[i]);
+            return 1;
+        }
+    }
+
+    FILE *out = stdout;
+    if (outPath != nullptr) {
+        out = fopen(outPath, "wb");
+        if (out == nullptr) {
+            perror(outPath);
+            return 1;
+        }
+        uint8_t header[DYP_R01CW_LOG_HEADER_SIZE];
+        DYP_R01CW_Log::encodeHeader(header);
+        fwrite(header, 1, sizeof(header), out);
+    } else {
+        fputs("timestamp_ms,addr,raw,status,true_mm\n", out);
+    }
+
+    uint64_t hash = 0xCBF29CE484222325ull;
+    uint8_t record[DYP_R01CW_LOG_RECORD_SIZE];
+    for (uint64_t n = 0; n < samples; n++) {
+        uint64_t cycleStart = DYP_R01CW_HostClock::now();
+        for (size_t i = 0; i < sensors.size(); i++) {
+            DYP_R01CW_Sample s;
+            sensors[i]->readSample(s);
+            DYP_R01CW_Log::encode(s, record);
+            for (uint8_t b : record) {
+                hash = (hash ^ b) * 0x100000001B3ull;
+            }
+            if (outPath != nullptr) {
+                fwrite(record, 1, sizeof(record), out);
+            } else {
+                fprintf(out, "%" PRIu32 ",0x%02X,%u,%u,%d\n", s.timestamp, s.addr, s.raw, s.status,
+                        sims[i]->trueDistance(DYP_R01CW_HostClock::now() / 1000));
+            }
+        }
+        // Idle until the next cycle
+        uint64_t elapsed = DYP_R01CW_HostClock::now() - cycleStart;
+        if ((uint64_t)periodMs * 1000 > elapsed) {
+            DYP_R01CW_HostClock::advance((uint64_t)periodMs * 1000 - elapsed);
+        }
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    fprintf(stderr, "%" PRIu64 " cycles, %.1f s virtual time, checksum %016" PRIx64 "\n", samples,
+            DYP_R01CW_HostClock::now() / 1e6, hash);
+
+    return 0;
+}
@@ -0,0 +1,453 @@
+/*!
+ * @file dyp_soak.cpp
+ *
+ * @brief Long-running soak test of the DYP-R01CW library under bus faults
+ *
+ * Runs hundreds of millions of measurement cycles through the public API of
+ * the Arduino library against a simulated sensor behind a fault-injecting
+ * bus, on the virtual clock. Each cycle calls readSample() or readDistance();
+ * isConnected(), readSoftwareVersion() and setAddress() are interleaved at
+ * lower rates, and restart() is called after repeated failures.
+ *
+ * Tracked per API call: number of calls, failures, and p50 / p99 / p99.99 /
+ * max blocking time (virtual microseconds, log-linear histogram with 1/16
+ * resolution; quantiles are bucket upper bounds).
+ *
+ * Tracked wraparound:
+ * - millis() and micros() rollovers; the virtual clock starts shortly before
+ *   the millis() rollover and micros() wraps every 71.6 minutes
+ * - blocking times measured with uint32_t micros() differences must match
+ *   the 64-bit virtual clock, and sample timestamp differences must stay
+ *   plausible across rollovers
+ *
+ * Tracked availability: the longest run of cycles without a valid sample
+ * (max_sample_gap).
+ *
+ * Tracked memory: heap bytes allocated while cycling (expected: none),
+ * peak heap usage and resident set size growth.
+ *
+ * Limits file (one "key value" per line, '#' starts a comment): every
+ * reported metric can be limited; -l checks the results against the file
+ * and the tool exits with status 1 if a limit is exceeded. -w writes the
+ * results of the run in the same format (to record new limits after a
+ * reviewed change). Virtual-time metrics are deterministic for a given
+ * seed and cycle count.
+ *
+ * Usage:
+ *   dyp_soak [-n cycles] [-s seed] [-l limits] [-w out_limits] [-q]
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I. -I../../src dyp_soak.cpp DYP_R01CW_Faults.cpp DYP_R01CW_Sim.cpp \
+ *       DYP_R01CW_Host.cpp ../../src/DYP_R01CW.cpp ../../src/DYP_R01CW_Processing.cpp -o dyp_soak
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <malloc.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <string>
+
+#include "Arduino.h"
+#include "DYP_R01CW.h"
+#include "DYP_R01CW_Faults.h"
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_Sim.h"
+#include "Wire.h"
+
+// Heap accounting (all allocations of the process); not inlined, so that the
+// compiler does not pair new with free()
+static size_t heapLive = 0;
+static size_t heapPeak = 0;
+static uint64_t heapAllocs = 0;
+
+__attribute__((noinline)) void *operator new(size_t size) {
+    void *p = malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    heapLive += malloc_usable_size(p);
+    if (heapLive > heapPeak) {
+        heapPeak = heapLive;
+    }
+    heapAllocs++;
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+    if (p != nullptr) {
+        heapLive -= malloc_usable_size(p);
+        free(p);
+    }
+}
+
+void operator delete(void *p, size_t) noexcept {
+    operator delete(p);
+}
+
+static long maxRssKb() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+/*!
+ * @brief Log-linear latency histogram (16 sub-buckets per power of two)
+ */
+class LatencyHistogram {
+public:
+    void add(uint64_t us) {
+        _count++;
+        if (us > _max) {
+            _max = us;
+        }
+        _buckets[bucket(us)]++;
+    }
+
+    uint64_t count() const { return _count; }
+    uint64_t max() const { return _max; }
+
+    // Upper bound of the bucket holding quantile q (parts per million)
+    uint64_t quantile(uint32_t ppm) const {
+        if (_count == 0) {
+            return 0;
+        }
+        uint64_t rank = (_count * ppm + 999999) / 1000000;
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < numBuckets; i++) {
+            seen += _buckets[i];
+            if (seen >= rank) {
+                uint64_t upper = upperBound(i);
+                return upper < _max ? upper : _max;
+            }
+        }
+        return _max;
+    }
+
+private:
+    static const unsigned subBits = 4;
+    static const unsigned numBuckets = (64 - subBits + 1) << subBits;
+
+    static unsigned bucket(uint64_t v) {
+        if (v < (1u << subBits)) {
+            return (unsigned)v;
+        }
+        unsigned e = 63 - __builtin_clzll(v);  // >= subBits
+        unsigned sub = (unsigned)(v >> (e - subBits)) & ((1u << subBits) - 1);
+        return ((e - subBits + 1) << subBits) + sub;
+    }
+
+    static uint64_t upperBound(unsigned i) {
+        if (i < (1u << subBits)) {
+            return i;
+        }
+        unsigned e = (i >> subBits) + subBits - 1;
+        uint64_t sub = i & ((1u << subBits) - 1);
+        return (((1ull << subBits) + sub + 1) << (e - subBits)) - 1;
+    }
+
+    uint64_t _count = 0;
+    uint64_t _max = 0;
+    uint64_t _buckets[numBuckets] = {};
+};
+
+/*!
+ * @brief Statistics of one API call
+ */
+struct CallStats {
+    const char *name;
+    uint64_t failures = 0;
+    LatencyHistogram hist;
+};
+
+enum { CALL_READ_SAMPLE, CALL_READ_DISTANCE, CALL_IS_CONNECTED, CALL_READ_VERSION, CALL_SET_ADDRESS, CALL_RESTART, CALL_COUNT };
+
+static CallStats calls[CALL_COUNT];
+static uint64_t clockErrors = 0;
+
+// Measure the blocking time of an API call with both the 64-bit virtual clock and micros()
+template <typename F> static bool measure(unsigned call, F f) {
+    uint64_t t0 = DYP_R01CW_HostClock::now();
+    uint32_t m0 = (uint32_t)micros();
+    bool ok = f();
+    uint64_t dt = DYP_R01CW_HostClock::now() - t0;
+    if ((uint32_t)((uint32_t)micros() - m0) != (uint32_t)dt) {
+        clockErrors++;
+    }
+    calls[call].hist.add(dt);
+    if (!ok) {
+        calls[call].failures++;
+    }
+    return ok;
+}
+
+static std::map<std::string, uint64_t> loadLimits(const char *path, bool &ok) {
+    std::map<std::string, uint64_t> limits;
+    FILE *f = fopen(path, "r");
+    ok = (f != nullptr);
+    if (!ok) {
+        perror(path);
+        return limits;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        char *hash = strchr(line, '#');
+        if (hash != nullptr) {
+            *hash = '\0';
+        }
+        char key[128];
+        unsigned long long value;
+        if (sscanf(line, "%127s %llu", key, &value) == 2) {
+            limits[key] = value;
+        }
+    }
+    fclose(f);
+    return limits;
+}
+
+int main(int argc, char **argv) {
+    uint64_t cycles = 1000000;
+    uint64_t seed = 1;
+    const char *limitsPath = nullptr;
+    const char *writePath = nullptr;
+    bool quiet = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:l:w:qh")) != -1) {
+        switch (opt) {
+        case 'n':
+            cycles = strtoull(optarg, nullptr, 0);
+            break;
+        case 's':
+            seed = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            limitsPath = optarg;
+            break;
+        case 'w':
+            writePath = optarg;
+            break;
+        case 'q':
+            quiet = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: dyp_soak [-n cycles] [-s seed] [-l limits] [-w out_limits] [-q]\n");
+            return 2;
+        }
+    }
+
+    std::map<std::string, uint64_t> limits;
+    if (limitsPath != nullptr) {
+        bool ok;
+        limits = loadLimits(limitsPath, ok);
+        if (!ok) {
+            return 2;
+        }
+    }
+
+    calls[CALL_READ_SAMPLE].name = "readSample";
+    calls[CALL_READ_DISTANCE].name = "readDistance";
+    calls[CALL_IS_CONNECTED].name = "isConnected";
+    calls[CALL_READ_VERSION].name = "readSoftwareVersion";
+    calls[CALL_SET_ADDRESS].name = "setAddress";
+    calls[CALL_RESTART].name = "restart";
+
+    // Start 10 s before the millis() rollover
+    DYP_R01CW_HostClock::set(0xFFFFFFFFull * 1000 - 10000000);
+
+    DYP_R01CW_SimBus bus;
+    DYP_R01CW_Sim sim(DYP_R01CW_DEFAULT_ADDR, seed);
+    DYP_R01CW_SimTarget target;
+    target.setLoop(60000);
+    target.addKey(0, DYP_R01CW_SIM_ABSENT);
+    target.addKey(20000, 1500);
+    target.addKey(40000, 300);
+    target.addKey(50000, DYP_R01CW_SIM_ABSENT);
+    sim.addTarget(target);
+    sim.config().background = 2500;
+    sim.config().noiseSigma = 3;
+    sim.config().dropoutPpm = 1000;
+    sim.config().stallPpm = 100;
+    sim.config().stallUs = 400000;
+    bus.attach(&sim);
+
+    DYP_R01CW_FaultBus faults(bus, seed ^ 0x9E3779B97F4A7C15ull);
+    faults.addSensor(&sim);
+    DYP_R01CW_FaultConfig &fc = faults.config();
+    fc.ppm[DYP_R01CW_FAULT_ADDR_NACK] = 1000;
+    fc.ppm[DYP_R01CW_FAULT_DATA_NACK] = 500;
+    fc.ppm[DYP_R01CW_FAULT_SHORT_READ] = 500;
+    fc.ppm[DYP_R01CW_FAULT_STUCK_SDA] = 10;
+    fc.ppm[DYP_R01CW_FAULT_CLOCK_STRETCH] = 2000;
+    fc.ppm[DYP_R01CW_FAULT_SENSOR_RESET] = 20;
+    Wire.setBus(&faults);
+
+    DYP_R01CW sensor;
+    if (!sensor.begin()) {
+        fprintf(stderr, "begin() failed\n");
+        return 1;
+    }
+    DYP_R01CW_Pipeline pipeline;
+    pipeline.setMedianWindow(5);
+    pipeline.setEmaShift(2);
+    pipeline.setThreshold(800, 50);
+
+    const uint8_t addrs[2] = {DYP_R01CW_DEFAULT_ADDR, 0xEA};
+    unsigned addrIndex = 0;
+
+    uint64_t heapAllocsStart = heapAllocs;
+    long rssStart = maxRssKb();
+
+    uint64_t lastValid = 0;
+    uint64_t maxGap = 0;
+    uint32_t lastMillis = (uint32_t)millis();
+    uint32_t lastMicros = (uint32_t)micros();
+    uint64_t millisWraps = 0;
+    uint64_t microsWraps = 0;
+    uint32_t lastTimestamp = 0;
+    bool haveTimestamp = false;
+    uint64_t timestampErrors = 0;
+    uint64_t events = 0;
+    uint32_t failures = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < cycles; n++) {
+        bool valid;
+        DYP_R01CW_Sample s;
+        if (n & 1) {
+            valid = measure(CALL_READ_DISTANCE, [&] { return sensor.readDistance() >= 0; });
+        } else {
+            valid = measure(CALL_READ_SAMPLE, [&] { return sensor.readSample(s); });
+            if (valid) {
+                // Consecutive timestamps are at most a few seconds apart, also across rollovers
+                if (haveTimestamp && (uint32_t)(s.timestamp - lastTimestamp) > 10000) {
+                    timestampErrors++;
+                }
+                lastTimestamp = s.timestamp;
+                haveTimestamp = true;
+                int16_t d;
+                if (pipeline.process(s, d) != DYP_R01CW_EVENT_NONE) {
+                    events++;
+                }
+            }
+        }
+
+        if (valid) {
+            if (n - lastValid > maxGap) {
+                maxGap = n - lastValid;
+            }
+            lastValid = n;
+            failures = 0;
+        } else if (++failures % 8 == 0) {
+            measure(CALL_RESTART, [&] { return sensor.restart(); });
+            delay(DYP_R01CW_CONVERSION_TIME_MS);
+        }
+
+        if ((n & 63) == 63) {
+            measure(CALL_IS_CONNECTED, [&] { return sensor.isConnected(); });
+        }
+        if ((n & 4095) == 4095) {
+            measure(CALL_READ_VERSION, [&] { return sensor.readSoftwareVersion() != 0; });
+        }
+        if ((n & 0xFFFFF) == 0xFFFFF) {
+            if (measure(CALL_SET_ADDRESS, [&] { return sensor.setAddress(addrs[addrIndex ^ 1]); })) {
+                addrIndex ^= 1;
+            }
+        }
+
+        uint32_t ms = (uint32_t)millis();
+        uint32_t us = (uint32_t)micros();
+        millisWraps += (ms < lastMillis);
+        microsWraps += (us < lastMicros);
+        lastMillis = ms;
+        lastMicros = us;
+
+        if (!quiet && (n + 1) % 10000000 == 0) {
+            double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            fprintf(stderr, "%" PRIu64 " cycles, %.1f s\n", n + 1, wall);
+        }
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t loopAllocs = heapAllocs - heapAllocsStart;
+    size_t loopHeapPeak = heapPeak;
+    long rssGrowth = maxRssKb() - rssStart;
+
+    std::map<std::string, uint64_t> results;
+    for (unsigned i = 0; i < CALL_COUNT; i++) {
+        const CallStats &c = calls[i];
+        std::string k(c.name);
+        results[k + ".calls"] = c.hist.count();
+        results[k + ".failures"] = c.failures;
+        results[k + ".p50_us"] = c.hist.quantile(500000);
+        results[k + ".p99_us"] = c.hist.quantile(990000);
+        results[k + ".p9999_us"] = c.hist.quantile(999900);
+        results[k + ".max_us"] = c.hist.max();
+    }
+    results["clock_errors"] = clockErrors;
+    results["timestamp_errors"] = timestampErrors;
+    results["max_sample_gap"] = maxGap;
+    results["heap_allocs_in_loop"] = loopAllocs;
+    results["heap_peak_bytes"] = loopHeapPeak;
+    results["rss_growth_kb"] = (uint64_t)rssGrowth;
+
+    printf("cycles %" PRIu64 ", %.1f days virtual time, %.1f s host time (%.0f cycles/s)\n", cycles,
+           (DYP_R01CW_HostClock::now() - (0xFFFFFFFFull * 1000 - 10000000)) / 86400e6, wall,
+           wall > 0 ? cycles / wall : 0.0);
+    printf("rollovers: millis %" PRIu64 ", micros %" PRIu64 "\n", millisWraps, microsWraps);
+    printf("threshold events %" PRIu64 ", sensor resets %" PRIu32 "\n", events, sim.restarts());
+    printf("%-20s %10s %9s %8s %8s %8s %8s\n", "call", "calls", "failures", "p50", "p99", "p99.99", "max");
+    for (unsigned i = 0; i < CALL_COUNT; i++) {
+        const CallStats &c = calls[i];
+        printf("%-20s %10" PRIu64 " %9" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 "\n", c.name,
+               c.hist.count(), c.failures, c.hist.quantile(500000), c.hist.quantile(990000),
+               c.hist.quantile(999900), c.hist.max());
+    }
+    printf("clock errors %" PRIu64 ", timestamp errors %" PRIu64 ", max sample gap %" PRIu64 "\n", clockErrors,
+           timestampErrors, maxGap);
+    printf("heap: %" PRIu64 " allocations while cycling, peak %zu bytes; rss growth %" PRIu64 " kB\n",
+           loopAllocs, loopHeapPeak, results["rss_growth_kb"]);
+
+    if (writePath != nullptr) {
+        FILE *f = fopen(writePath, "w");
+        if (f == nullptr) {
+            perror(writePath);
+            return 2;
+        }
+        fprintf(f, "# dyp_soak -n %" PRIu64 " -s %" PRIu64 "\n", cycles, seed);
+        for (const auto &r : results) {
+            fprintf(f, "%s %" PRIu64 "\n", r.first.c_str(), r.second);
+        }
+        fclose(f);
+    }
+
+    int rc = 0;
+    for (const auto &l : limits) {
+        auto r = results.find(l.first);
+        if (r == results.end()) {
+            fprintf(stderr, "unknown limit %s\n", l.first.c_str());
+            rc = 1;
+        } else if (r->second > l.second) {
+            fprintf(stderr, "REGRESSION %s: %" PRIu64 " > %" PRIu64 "\n", l.first.c_str(), r->second, l.second);
+            rc = 1;
+        }
+    }
+    if (limitsPath != nullptr && rc == 0) {
+        printf("all %zu limits met\n", limits.size());
+    }
+
+    return rc;
+}
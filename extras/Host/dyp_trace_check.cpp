@@ -0,0 +1,181 @@
+/*!
+ * @file dyp_trace_check.cpp
+ *
+ * @brief Check the I2C transactions and blocking time of each API call against a golden trace
+ *
+ * Calls each public API function of the Arduino library that accesses the
+ * bus - begin(), readDistance(), readSoftwareVersion(), isConnected(),
+ * setAddress() and restart() - against a fresh noise-free simulated sensor
+ * (and, for the error paths, against an empty bus) - as well as the
+ * corresponding calls of DYP_R01CW_Static - and records every
+ * transfer with DYP_R01CW_TraceBus: bytes, stop / repeated start, result and
+ * virtual start time, followed by the return value, the number of transfers
+ * and the total blocking time of the call.
+ *
+ * The trace is compared line by line with the golden file; any added,
+ * removed or changed transaction, byte or microsecond makes the tool exit
+ * with status 1. After a reviewed, intended change of the bus protocol,
+ * rewrite the golden file with -w.
+ *
+ * Usage:
+ *   dyp_trace_check [-w] golden_file
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I. -I../../src dyp_trace_check.cpp DYP_R01CW_Trace.cpp DYP_R01CW_Sim.cpp \
+ *       DYP_R01CW_Host.cpp ../../src/DYP_R01CW.cpp ../../src/DYP_R01CW_Processing.cpp -o dyp_trace_check
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "Arduino.h"
+#include "DYP_R01CW.h"
+#include "DYP_R01CW_Sim.h"
+#include "DYP_R01CW_Static.h"
+#include "DYP_R01CW_Trace.h"
+#include "Wire.h"
+
+/*!
+ * @brief Run one API call in a fresh environment and append its trace
+ * @param out Output
+ * @param title Section title
+ * @param present true if the sensor is attached to the bus
+ * @param call API call, returns its result formatted as text
+ */
+template <typename F> static void record(std::string &out, const char *title, bool present, F call) {
+    DYP_R01CW_HostClock::set(0);
+    DYP_R01CW_SimBus bus;
+    DYP_R01CW_Sim sim(DYP_R01CW_DEFAULT_ADDR, 1);
+    sim.config().background = 1234;
+    sim.config().noiseSigma = 0;
+    sim.config().latencyMinUs = 40000;
+    sim.config().latencyMaxUs = 40000;
+    if (present) {
+        bus.attach(&sim);
+    }
+    DYP_R01CW_TraceBus trace(bus);
+    Wire.setBus(&trace);
+
+    DYP_R01CW sensor;
+    if (strcmp(title, "begin") != 0) {
+        sensor.begin();
+    }
+
+    trace.mark();
+    std::string result = call(sensor);
+
+    char buf[96];
+    out += "[";
+    out += title;
+    out += "]\n";
+    out += trace.text();
+    snprintf(buf, sizeof(buf), "result %s\ntransfers %" PRIu32 ", blocking %" PRIu64 " us\n\n", result.c_str(),
+             trace.transfers(), trace.elapsed());
+    out += buf;
+}
+
+static std::string str(long v) {
+    return std::to_string(v);
+}
+
+int main(int argc, char **argv) {
+    bool writeGolden = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "wh")) != -1) {
+        switch (opt) {
+        case 'w':
+            writeGolden = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: dyp_trace_check [-w] golden_file\n");
+            return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Usage: dyp_trace_check [-w] golden_file\n");
+        return 2;
+    }
+    const char *path = argv[optind];
+
+    std::string trace;
+    record(trace, "begin", true, [](DYP_R01CW &s) { return str(s.begin()); });
+    record(trace, "readDistance", true, [](DYP_R01CW &s) { return str(s.readDistance()); });
+    record(trace, "readSoftwareVersion", true, [](DYP_R01CW &s) { return str(s.readSoftwareVersion()); });
+    record(trace, "isConnected", true, [](DYP_R01CW &s) { return str(s.isConnected()); });
+    record(trace, "setAddress", true, [](DYP_R01CW &s) { return str(s.setAddress(0xEA)); });
+    record(trace, "restart", true, [](DYP_R01CW &s) { return str(s.restart()); });
+    record(trace, "begin (no sensor)", false, [](DYP_R01CW &s) { return str(s.begin()); });
+    record(trace, "readDistance (no sensor)", false, [](DYP_R01CW &s) { return str(s.readDistance()); });
+    record(trace, "isConnected (no sensor)", false, [](DYP_R01CW &s) { return str(s.isConnected()); });
+
+    // Compile-time addressed variant: same transactions expected
+    typedef DYP_R01CW_Static<> Static;
+    record(trace, "Static::begin", true, [](DYP_R01CW &) { return str(Static::begin()); });
+    record(trace, "Static::readDistance", true, [](DYP_R01CW &) { return str(Static::readDistance()); });
+    record(trace, "Static::readSoftwareVersion", true, [](DYP_R01CW &) { return str(Static::readSoftwareVersion()); });
+    record(trace, "Static::isConnected", true, [](DYP_R01CW &) { return str(Static::isConnected()); });
+    record(trace, "Static::setAddress", true, [](DYP_R01CW &) { return str(Static::setAddress<0xEA>()); });
+    record(trace, "Static::restart", true, [](DYP_R01CW &) { return str(Static::restart()); });
+
+    if (writeGolden) {
+        FILE *f = fopen(path, "w");
+        if (f == nullptr) {
+            perror(path);
+            return 2;
+        }
+        fputs(trace.c_str(), f);
+        fclose(f);
+        return 0;
+    }
+
+    std::ifstream in(path);
+    if (!in) {
+        perror(path);
+        return 2;
+    }
+    std::stringstream golden;
+    golden << in.rdbuf();
+
+    std::istringstream expected(golden.str());
+    std::istringstream actual(trace);
+    std::string e, a, section;
+    int lineNo = 0;
+    int rc = 0;
+    for (;;) {
+        bool he = (bool)std::getline(expected, e);
+        bool ha = (bool)std::getline(actual, a);
+        if (!he && !ha) {
+            break;
+        }
+        lineNo++;
+        if (ha && !a.empty() && a[0] == '[') {
+            section = a;
+        }
+        if (he != ha || e != a) {
+            fprintf(stderr, "%s:%d: %s\n  expected: %s\n  actual:   %s\n", path, lineNo, section.c_str(),
+                    he ? e.c_str() : "(end of file)", ha ? a.c_str() : "(end of trace)");
+            rc = 1;
+            break;
+        }
+    }
+    if (rc == 0) {
+        printf("%d lines match %s\n", lineNo, path);
+    }
+
+    return rc;
+}
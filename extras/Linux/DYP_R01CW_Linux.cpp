@@ -0,0 +1,508 @@
+/*!
+ * @file DYP_R01CW_Linux.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - Linux i2c-dev backend
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Linux.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "DYP_R01CW_Processing.h"
+
+/*!
+ * @brief Open an i2c-dev device
+ * @param path Device path
+ * @return File descriptor, or -1 on error
+ */
+int DYP_R01CW_LinuxIo::open(const char *path) {
+    return ::open(path, O_RDWR | O_CLOEXEC);
+}
+
+/*!
+ * @brief Issue a combined I2C transfer (I2C_RDWR)
+ * @param fd File descriptor
+ * @param data Message set
+ * @return Number of messages transferred, or -1 on error
+ */
+int DYP_R01CW_LinuxIo::transfer(int fd, struct i2c_rdwr_ioctl_data *data) {
+    return ::ioctl(fd, I2C_RDWR, data);
+}
+
+/*!
+ * @brief Close an i2c-dev device
+ * @param fd File descriptor
+ */
+void DYP_R01CW_LinuxIo::close(int fd) {
+    ::close(fd);
+}
+
+/*!
+ * @brief Get monotonic time
+ * @return Time in microseconds
+ */
+uint64_t DYP_R01CW_LinuxIo::micros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
+
+/*!
+ * @brief Sleep
+ * @param us Duration in microseconds
+ */
+void DYP_R01CW_LinuxIo::sleep(uint32_t us) {
+    struct timespec ts;
+    ts.tv_sec = us / 1000000u;
+    ts.tv_nsec = (long)(us % 1000000u) * 1000;
+    while (nanosleep(&ts, &ts) != 0) {
+        // Resume after signal
+    }
+}
+
+/*!
+ * @brief Get the default instance (real system calls)
+ * @return Default instance
+ */
+DYP_R01CW_LinuxIo &DYP_R01CW_LinuxIo::system() {
+    static DYP_R01CW_LinuxIo io;
+    return io;
+}
+
+/*!
+ * @brief Constructor
+ * @param io System call layer
+ */
+DYP_R01CW_LinuxBus::DYP_R01CW_LinuxBus(DYP_R01CW_LinuxIo &io) : _io(io) {
+    _fd = -1;
+}
+
+DYP_R01CW_LinuxBus::~DYP_R01CW_LinuxBus() {
+    end();
+}
+
+/*!
+ * @brief Open the bus
+ * @param bus Bus number N of /dev/i2c-N
+ * @return true if the device was opened, false otherwise
+ */
+bool DYP_R01CW_LinuxBus::begin(int bus) {
+    char path[32];
+    snprintf(path, sizeof(path), "/dev/i2c-%d", bus);
+    return begin(path);
+}
+
+/*!
+ * @brief Open the bus
+ * @param path Device path
+ * @return true if the device was opened, false otherwise
+ */
+bool DYP_R01CW_LinuxBus::begin(const char *path) {
+    end();
+    _fd = _io.open(path);
+    return (_fd >= 0);
+}
+
+/*!
+ * @brief Close the bus
+ */
+void DYP_R01CW_LinuxBus::end() {
+    if (_fd >= 0) {
+        _io.close(_fd);
+        _fd = -1;
+    }
+}
+
+/*!
+ * @brief Issue messages as one combined transfer
+ * @param msgs Messages
+ * @param count Number of messages
+ * @return true if all messages were transferred, false otherwise
+ */
+bool DYP_R01CW_LinuxBus::transfer(struct i2c_msg *msgs, uint32_t count) {
+    return (transferCount(msgs, count) == (int)count);
+}
+
+/*!
+ * @brief Issue messages as one combined transfer
+ * @param msgs Messages
+ * @param count Number of messages
+ * @return Number of messages transferred, or -1 on error
+ */
+int DYP_R01CW_LinuxBus::transferCount(struct i2c_msg *msgs, uint32_t count) {
+    if (_fd < 0 || count == 0 || count > I2C_RDWR_IOCTL_MAX_MSGS) {
+        return -1;
+    }
+
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = msgs;
+    data.nmsgs = count;
+
+    return _io.transfer(_fd, &data);
+}
+
+/*!
+ * @brief Write transfer
+ * @param addr 7-bit I2C address
+ * @param data Data bytes
+ * @param len Number of data bytes
+ * @return 0 on success, 4 (other error) otherwise
+ */
+uint8_t DYP_R01CW_LinuxBus::write(uint8_t addr, const uint8_t *data, uint8_t len) {
+    struct i2c_msg msg;
+    msg.addr = addr;
+    msg.flags = 0;
+    msg.len = len;
+    msg.buf = const_cast<uint8_t *>(data);
+
+    return transfer(&msg, 1) ? 0 : 4;
+}
+
+/*!
+ * @brief Read transfer
+ * @param addr 7-bit I2C address
+ * @param buf Destination
+ * @param len Number of bytes requested
+ * @return Number of bytes received
+ */
+uint8_t DYP_R01CW_LinuxBus::read(uint8_t addr, uint8_t *buf, uint8_t len) {
+    struct i2c_msg msg;
+    msg.addr = addr;
+    msg.flags = I2C_M_RD;
+    msg.len = len;
+    msg.buf = buf;
+
+    return transfer(&msg, 1) ? len : 0;
+}
+
+/*!
+ * @brief Write and read with repeated start
+ * @param addr 7-bit I2C address
+ * @param data Data bytes
+ * @param len Number of data bytes
+ * @param buf Destination
+ * @param rlen Number of bytes requested
+ * @return DYP_R01CW_STATUS_OK or DYP_R01CW_STATUS_BUS_ERROR
+ */
+uint8_t DYP_R01CW_LinuxBus::writeRead(uint8_t addr, const uint8_t *data, uint8_t len, uint8_t *buf, uint8_t rlen) {
+    struct i2c_msg msgs[2];
+    msgs[0].addr = addr;
+    msgs[0].flags = 0;
+    msgs[0].len = len;
+    msgs[0].buf = const_cast<uint8_t *>(data);
+    msgs[1].addr = addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = rlen;
+    msgs[1].buf = buf;
+
+    return transfer(msgs, 2) ? DYP_R01CW_STATUS_OK : DYP_R01CW_STATUS_BUS_ERROR;
+}
+
+/*!
+ * @brief Trigger measurements of several sensors
+ * @param sensors Sensors on this bus
+ * @param count Number of sensors
+ * @return true if all triggers were acknowledged, false otherwise
+ */
+bool DYP_R01CW_LinuxBus::triggerAll(DYP_R01CW_Linux *const *sensors, size_t count) {
+    struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    uint8_t bufs[I2C_RDWR_IOCTL_MAX_MSGS][DYP_R01CW_MeasureCommand::reg::writeSize];
+    bool ok = true;
+
+    for (size_t base = 0; base < count; base += I2C_RDWR_IOCTL_MAX_MSGS) {
+        size_t n = count - base;
+        if (n > I2C_RDWR_IOCTL_MAX_MSGS) {
+            n = I2C_RDWR_IOCTL_MAX_MSGS;
+        }
+        for (size_t i = 0; i < n; i++) {
+            sensors[base + i]->triggerMsg(msgs[i], bufs[i]);
+            sensors[base + i]->_triggerLost = false;
+        }
+        size_t i = 0;
+        while (i < n) {
+            int done = transferCount(&msgs[i], n - i);
+            if (done == (int)(n - i)) {
+                break;
+            }
+            // The kernel aborts the transfer on the first NACK; the sensors
+            // before it have been triggered and must not be restarted
+            if (done >= 0 && (size_t)done < n - i) {
+                i += done;
+            } else {
+                // Position not reported - locate the NACKing sensor with
+                // address-only probes, which do not start a conversion
+                size_t f = i;
+                while (f < n && sensors[base + f]->isConnected()) {
+                    f++;
+                }
+                if (f == n) {
+                    // Transient error - it is unknown which of the remaining sensors
+                    // have started a conversion, and triggering them again would shift
+                    // their conversion past the readout: fail their samples of this cycle
+                    for (; i < n; i++) {
+                        sensors[base + i]->_triggerLost = true;
+                    }
+                    ok = false;
+                    break;
+                }
+                i = f;
+            }
+            // Retry the failing sensor once, then continue with the rest
+            ok &= sensors[base + i]->trigger();
+            i++;
+        }
+    }
+
+    return ok;
+}
+
+/*!
+ * @brief Read the results of several sensors with one ioctl
+ * @param sensors Sensors on this bus
+ * @param count Number of sensors
+ * @param samples Samples (one per sensor)
+ * @return Number of valid samples
+ */
+size_t DYP_R01CW_LinuxBus::readAll(DYP_R01CW_Linux *const *sensors, size_t count, DYP_R01CW_Sample *samples) {
+    const size_t perXfer = I2C_RDWR_IOCTL_MAX_MSGS / 2;
+    struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    uint8_t ptrs[perXfer];
+    uint8_t data[perXfer][DYP_R01CW_DataRegister::width];
+    size_t valid = 0;
+
+    for (size_t base = 0; base < count; base += perXfer) {
+        size_t n = count - base;
+        if (n > perXfer) {
+            n = perXfer;
+        }
+        for (size_t i = 0; i < n; i++) {
+            sensors[base + i]->readMsgs(&msgs[2 * i], &ptrs[i], data[i]);
+        }
+        if (transfer(msgs, 2 * n)) {
+            for (size_t i = 0; i < n; i++) {
+                valid += sensors[base + i]->decode(true, DYP_R01CW_DataRegister::decode(data[i]), samples[base + i]);
+            }
+        } else {
+            // Identify failing sensors
+            for (size_t i = 0; i < n; i++) {
+                valid += sensors[base + i]->readResult(samples[base + i]);
+            }
+        }
+    }
+
+    return valid;
+}
+
+/*!
+ * @brief Constructor
+ * @param addr I2C address of the sensor in 8-bit format
+ */
+DYP_R01CW_Linux::DYP_R01CW_Linux(uint8_t addr) {
+    // Convert 8-bit address to 7-bit format for i2c-dev
+    _addr = addr >> 1;
+    _bus = nullptr;
+    _distanceOffset = 0;
+    _triggerLost = false;
+}
+
+/*!
+ * @brief Initialize the sensor
+ * @param bus Opened I2C bus
+ * @return true if initialization successful, false otherwise
+ */
+bool DYP_R01CW_Linux::begin(DYP_R01CW_LinuxBus *bus) {
+    _bus = bus;
+
+    // Version of 0 indicates a communication error
+    return (readSoftwareVersion() != 0);
+}
+
+/*!
+ * @brief Fill trigger message
+ */
+void DYP_R01CW_Linux::triggerMsg(struct i2c_msg &msg, uint8_t *buf) {
+    msg.addr = _addr;
+    msg.flags = 0;
+    msg.len = DYP_R01CW_MeasureCommand::reg::encode(buf, DYP_R01CW_MeasureCommand::value);
+    msg.buf = buf;
+}
+
+/*!
+ * @brief Fill pointer write + data read messages
+ */
+void DYP_R01CW_Linux::readMsgs(struct i2c_msg *msgs, uint8_t *ptr, uint8_t *data) {
+    *ptr = DYP_R01CW_DataRegister::address;
+    msgs[0].addr = _addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = ptr;
+    msgs[1].addr = _addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = DYP_R01CW_DataRegister::width;
+    msgs[1].buf = data;
+}
+
+/*!
+ * @brief Fill sample with a data register value
+ */
+bool DYP_R01CW_Linux::decode(bool ok, uint16_t raw, DYP_R01CW_Sample &sample) {
+    sample.addr = _addr << 1;
+    sample.timestamp = (uint32_t)(_bus->io().micros() / 1000);
+
+    if (!ok || _triggerLost) {
+        sample.raw = DYP_R01CW_RAW_INVALID;
+        sample.status = DYP_R01CW_STATUS_BUS_ERROR;
+        return false;
+    }
+
+    sample.raw = raw;
+    if (sample.raw == DYP_R01CW_RAW_INVALID) {
+        sample.status = DYP_R01CW_STATUS_INVALID;
+        return false;
+    }
+    sample.status = DYP_R01CW_STATUS_OK;
+
+    return true;
+}
+
+/*!
+ * @brief Start a measurement
+ * @return true if the command was acknowledged, false otherwise
+ */
+bool DYP_R01CW_Linux::trigger() {
+    if (_bus == nullptr) {
+        return false;
+    }
+
+    _triggerLost = false;
+    return Protocol::command<DYP_R01CW_MeasureCommand>(*_bus, _addr) == 0;
+}
+
+/*!
+ * @brief Read the result of a measurement
+ * @param sample Sample to fill
+ * @return true if the sample is valid, false otherwise
+ */
+bool DYP_R01CW_Linux::readResult(DYP_R01CW_Sample &sample) {
+    if (_bus == nullptr) {
+        sample.addr = _addr << 1;
+        sample.timestamp = 0;
+        sample.raw = DYP_R01CW_RAW_INVALID;
+        sample.status = DYP_R01CW_STATUS_BUS_ERROR;
+        return false;
+    }
+
+    // Pointer write and data read with repeated start
+    uint16_t raw = DYP_R01CW_RAW_INVALID;
+    bool ok = (Protocol::read<DYP_R01CW_DataRegister>(*_bus, _addr, raw) == DYP_R01CW_STATUS_OK);
+
+    return decode(ok, raw, sample);
+}
+
+/*!
+ * @brief Read a raw distance sample
+ * @param sample Sample to fill
+ * @return true if the sample is valid, false otherwise
+ */
+bool DYP_R01CW_Linux::readSample(DYP_R01CW_Sample &sample) {
+    if (!trigger()) {
+        sample.addr = _addr << 1;
+        sample.timestamp = _bus ? (uint32_t)(_bus->io().micros() / 1000) : 0;
+        sample.raw = DYP_R01CW_RAW_INVALID;
+        sample.status = DYP_R01CW_STATUS_BUS_ERROR;
+        return false;
+    }
+
+    // Wait for measurement to complete
+    _bus->io().sleep(DYP_R01CW_CONVERSION_TIME_MS * 1000u);
+
+    return readResult(sample);
+}
+
+/*!
+ * @brief Read distance measurement
+ * @return Distance in millimeters, or -1 if read failed
+ */
+int16_t DYP_R01CW_Linux::readDistance() {
+    DYP_R01CW_Sample sample;
+
+    if (!readSample(sample)) {
+        return -1;
+    }
+
+    return DYP_R01CW_applyOffset(sample.raw, _distanceOffset);
+}
+
+/*!
+ * @brief Check if sensor is connected and responding
+ * @return true if sensor is connected, false otherwise
+ */
+bool DYP_R01CW_Linux::isConnected() {
+    if (_bus == nullptr) {
+        return false;
+    }
+
+    // Zero-length write (address only)
+    return Protocol::probe(*_bus, _addr) == 0;
+}
+
+/*!
+ * @brief Read software version number from the sensor
+ * @return Software version number (16-bit), or 0 if read failed
+ */
+uint16_t DYP_R01CW_Linux::readSoftwareVersion() {
+    if (_bus == nullptr) {
+        return 0;
+    }
+
+    uint16_t version;
+    if (Protocol::read<DYP_R01CW_VersionRegister>(*_bus, _addr, version) != DYP_R01CW_STATUS_OK) {
+        return 0;
+    }
+
+    return version;
+}
+
+/*!
+ * @brief Set the I2C address of the sensor
+ * @param newAddr New I2C address in 8-bit format
+ * @return true if address was set successfully, false otherwise
+ */
+bool DYP_R01CW_Linux::setAddress(uint8_t newAddr) {
+    if (_bus == nullptr || !DYP_R01CW_isValidAddress(newAddr)) {
+        return false;
+    }
+
+    if (Protocol::write<DYP_R01CW_SlaveAddrRegister>(*_bus, _addr, newAddr) != 0) {
+        return false;
+    }
+
+    // Address change successful: update internal 7-bit address
+    _addr = newAddr >> 1;
+
+    return true;
+}
+
+/*!
+ * @brief Restart the sensor
+ * @return true if restart command was sent successfully, false otherwise
+ */
+bool DYP_R01CW_Linux::restart() {
+    if (_bus == nullptr) {
+        return false;
+    }
+
+    return Protocol::command<DYP_R01CW_RestartCommand>(*_bus, _addr) == 0;
+}
@@ -0,0 +1,315 @@
+/*!
+ * @file DYP_R01CW_Linux.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - Linux i2c-dev backend
+ *
+ * @section intro_sec Introduction
+ *
+ * Linux backend for the DYP-R01CW sensor using /dev/i2c-N. Register pointer
+ * write and data read are issued as a single I2C_RDWR ioctl with a repeated
+ * start. Triggers and readouts of several sensors on the same bus can be
+ * batched into one ioctl each. Register layout and transactions come from
+ * the shared protocol core (DYP_R01CW_Protocol.h); DYP_R01CW_LinuxBus is
+ * its bus transport.
+ *
+ * All system calls go through DYP_R01CW_LinuxIo, which can be replaced to
+ * run the backend without hardware.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_LINUX_H
+#define DYP_R01CW_LINUX_H
+
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DYP_R01CW_Protocol.h"
+#include "DYP_R01CW_Registers.h"
+#include "DYP_R01CW_Sample.h"
+
+/*!
+ * @brief System call layer used by DYP_R01CW_LinuxBus
+ *
+ * The default implementation forwards to open(), ioctl(), close(),
+ * clock_gettime(CLOCK_MONOTONIC) and nanosleep(). Override it to inject
+ * a simulated bus or faults.
+ */
+class DYP_R01CW_LinuxIo {
+public:
+    virtual ~DYP_R01CW_LinuxIo() {}
+
+    /*!
+     * @brief Open an i2c-dev device
+     * @param path Device path
+     * @return File descriptor, or -1 on error
+     */
+    virtual int open(const char *path);
+
+    /*!
+     * @brief Issue a combined I2C transfer (I2C_RDWR)
+     * @param fd File descriptor
+     * @param data Message set
+     * @return Number of messages transferred, or -1 on error
+     */
+    virtual int transfer(int fd, struct i2c_rdwr_ioctl_data *data);
+
+    /*!
+     * @brief Close an i2c-dev device
+     * @param fd File descriptor
+     */
+    virtual void close(int fd);
+
+    /*!
+     * @brief Get monotonic time
+     * @return Time in microseconds
+     */
+    virtual uint64_t micros();
+
+    /*!
+     * @brief Sleep
+     * @param us Duration in microseconds
+     */
+    virtual void sleep(uint32_t us);
+
+    /*!
+     * @brief Get the default instance (real system calls)
+     * @return Default instance
+     */
+    static DYP_R01CW_LinuxIo &system();
+};
+
+class DYP_R01CW_Linux;
+
+/*!
+ * @brief Linux I2C bus (/dev/i2c-N)
+ */
+class DYP_R01CW_LinuxBus {
+public:
+    static constexpr bool combined = true;  ///< Register reads with repeated start (writeRead())
+
+    /*!
+     * @brief Constructor
+     * @param io System call layer (default: real system calls)
+     */
+    DYP_R01CW_LinuxBus(DYP_R01CW_LinuxIo &io = DYP_R01CW_LinuxIo::system());
+
+    ~DYP_R01CW_LinuxBus();
+
+    /*!
+     * @brief Open the bus
+     * @param bus Bus number N of /dev/i2c-N
+     * @return true if the device was opened, false otherwise
+     */
+    bool begin(int bus);
+
+    /*!
+     * @brief Open the bus
+     * @param path Device path, e.g. "/dev/i2c-1"
+     * @return true if the device was opened, false otherwise
+     */
+    bool begin(const char *path);
+
+    /*!
+     * @brief Close the bus
+     */
+    void end();
+
+    /*!
+     * @brief Issue messages as one combined transfer (repeated start between messages)
+     * @param msgs Messages
+     * @param count Number of messages (max. I2C_RDWR_IOCTL_MAX_MSGS)
+     * @return true if all messages were transferred, false otherwise
+     */
+    bool transfer(struct i2c_msg *msgs, uint32_t count);
+
+    /*!
+     * @brief Write transfer (DYP_R01CW_Protocol bus transport)
+     * @param addr 7-bit I2C address
+     * @param data Data bytes
+     * @param len Number of data bytes (0: address only)
+     * @return 0 on success, 4 (other error) otherwise
+     */
+    uint8_t write(uint8_t addr, const uint8_t *data, uint8_t len);
+
+    /*!
+     * @brief Read transfer (DYP_R01CW_Protocol bus transport)
+     * @param addr 7-bit I2C address
+     * @param buf Destination
+     * @param len Number of bytes requested
+     * @return Number of bytes received (0 or len)
+     */
+    uint8_t read(uint8_t addr, uint8_t *buf, uint8_t len);
+
+    /*!
+     * @brief Write and read with repeated start (DYP_R01CW_Protocol bus transport)
+     * @param addr 7-bit I2C address
+     * @param data Data bytes (register pointer)
+     * @param len Number of data bytes
+     * @param buf Destination
+     * @param rlen Number of bytes requested
+     * @return DYP_R01CW_STATUS_OK or DYP_R01CW_STATUS_BUS_ERROR
+     */
+    uint8_t writeRead(uint8_t addr, const uint8_t *data, uint8_t len, uint8_t *buf, uint8_t rlen);
+
+    /*!
+     * @brief Trigger measurements of several sensors with one ioctl per I2C_RDWR_IOCTL_MAX_MSGS sensors
+     * @param sensors Sensors on this bus
+     * @param count Number of sensors
+     * @return true if all triggers were acknowledged, false otherwise
+     * @note If the combined transfer fails, the failing sensor is retried individually
+     *       and the remaining sensors are triggered in another combined transfer, so a
+     *       single failing sensor does not prevent the others from measuring. The
+     *       sensors before it are not triggered again (a trigger restarts the
+     *       conversion). If the adapter does not report how many messages were
+     *       transferred, the failing sensor is located with address-only probes. If
+     *       every probe succeeds (transient error), the remaining sensors of the
+     *       transfer are not triggered again; their next readout reports
+     *       DYP_R01CW_STATUS_BUS_ERROR, as it is unknown whether they started a conversion.
+     */
+    bool triggerAll(DYP_R01CW_Linux *const *sensors, size_t count);
+
+    /*!
+     * @brief Read the results of several sensors (pointer write + read per sensor) with one ioctl
+     * @param sensors Sensors on this bus
+     * @param count Number of sensors
+     * @param samples Samples (one per sensor)
+     * @return Number of valid samples
+     * @note If the combined transfer fails, the sensors are read individually.
+     */
+    size_t readAll(DYP_R01CW_Linux *const *sensors, size_t count, DYP_R01CW_Sample *samples);
+
+    /*!
+     * @brief Get the system call layer
+     * @return System call layer
+     */
+    DYP_R01CW_LinuxIo &io() { return _io; }
+
+private:
+    // Issue messages as one combined transfer, return the number of messages transferred or -1
+    int transferCount(struct i2c_msg *msgs, uint32_t count);
+
+    DYP_R01CW_LinuxIo &_io;  ///< System call layer
+    int _fd;                 ///< File descriptor, -1 if closed
+};
+
+/*!
+ * @brief DYP-R01CW sensor on a Linux I2C bus
+ *
+ * Provides the same API as the Arduino DYP_R01CW class, plus split
+ * trigger()/readResult() calls for non-blocking use.
+ */
+class DYP_R01CW_Linux {
+    typedef DYP_R01CW_Protocol<DYP_R01CW_LinuxBus> Protocol;  ///< Transactions on the bus
+
+
+public:
+    /*!
+     * @brief Constructor
+     * @param addr I2C address of the sensor in 8-bit format (default: 0xE8)
+     */
+    DYP_R01CW_Linux(uint8_t addr = DYP_R01CW_DEFAULT_ADDR);
+
+    /*!
+     * @brief Initialize the sensor
+     * @param bus Opened I2C bus
+     * @return true if initialization successful, false otherwise
+     */
+    bool begin(DYP_R01CW_LinuxBus *bus);
+
+    /*!
+     * @brief Read distance measurement (trigger, wait, read)
+     * @return Distance in millimeters, or -1 if read failed
+     */
+    int16_t readDistance();
+
+    /*!
+     * @brief Read a raw distance sample (trigger, wait, read)
+     * @param sample Sample to fill
+     * @return true if the sample is valid, false otherwise
+     */
+    bool readSample(DYP_R01CW_Sample &sample);
+
+    /*!
+     * @brief Start a measurement
+     * @return true if the command was acknowledged, false otherwise
+     */
+    bool trigger();
+
+    /*!
+     * @brief Read the result of a measurement started DYP_R01CW_CONVERSION_TIME_MS before
+     * @param sample Sample to fill
+     * @return true if the sample is valid, false otherwise
+     */
+    bool readResult(DYP_R01CW_Sample &sample);
+
+    /*!
+     * @brief Check if sensor is connected and responding
+     * @return true if sensor is connected, false otherwise
+     */
+    bool isConnected();
+
+    /*!
+     * @brief Read software version number from the sensor
+     * @return Software version number (16-bit), or 0 if read failed
+     */
+    uint16_t readSoftwareVersion();
+
+    /*!
+     * @brief Set the I2C address of the sensor
+     * @param newAddr New I2C address in 8-bit format
+     * @return true if address was set successfully, false otherwise
+     */
+    bool setAddress(uint8_t newAddr);
+
+    /*!
+     * @brief Set the distance offset
+     * @param offset Offset in millimeters to add to distance readings
+     */
+    void setDistanceOffset(int16_t offset) { _distanceOffset = offset; }
+
+    /*!
+     * @brief Get the current distance offset
+     * @return Current offset in millimeters
+     */
+    int16_t getDistanceOffset() const { return _distanceOffset; }
+
+    /*!
+     * @brief Restart the sensor
+     * @return true if restart command was sent successfully, false otherwise
+     */
+    bool restart();
+
+    /*!
+     * @brief Get the I2C address
+     * @return I2C address in 8-bit format
+     */
+    uint8_t getAddress() const { return _addr << 1; }
+
+private:
+    friend class DYP_R01CW_LinuxBus;
+
+    // Fill trigger message (buf: DYP_R01CW_MeasureCommand::reg::writeSize bytes)
+    void triggerMsg(struct i2c_msg &msg, uint8_t *buf);
+
+    // Fill pointer write + data read messages (ptr: 1 byte, data: DYP_R01CW_DataRegister::width bytes)
+    void readMsgs(struct i2c_msg *msgs, uint8_t *ptr, uint8_t *data);
+
+    // Fill sample with a data register value (ok: transfer succeeded)
+    bool decode(bool ok, uint16_t raw, DYP_R01CW_Sample &sample);
+
+    uint8_t _addr;              ///< I2C address of the sensor (7-bit)
+    DYP_R01CW_LinuxBus *_bus;   ///< Bus, nullptr before begin()
+    int16_t _distanceOffset;    ///< Distance offset in millimeters
+    bool _triggerLost;          ///< Trigger of the current cycle unconfirmed (readout fails)
+};
+
+#endif // DYP_R01CW_LINUX_H
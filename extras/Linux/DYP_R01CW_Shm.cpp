@@ -0,0 +1,271 @@
+/*!
+ * @file DYP_R01CW_Shm.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - shared-memory sample ring
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Shm.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Size of mapping with the given number of slots
+static size_t shmSize(uint32_t capacity) {
+    return sizeof(DYP_R01CW_ShmHeader) + (capacity - 1) * sizeof(DYP_R01CW_ShmSlot);
+}
+
+/*!
+ * @brief Constructor
+ */
+DYP_R01CW_ShmPublisher::DYP_R01CW_ShmPublisher() {
+    _hdr = nullptr;
+    _size = 0;
+    _mask = 0;
+    _name[0] = '\0';
+}
+
+DYP_R01CW_ShmPublisher::~DYP_R01CW_ShmPublisher() {
+    end();
+}
+
+/*!
+ * @brief Create (or replace) the shared-memory ring
+ * @param name Shared-memory object name
+ * @param capacity Number of slots, rounded up to a power of two
+ * @return true if the ring was created, false otherwise
+ */
+bool DYP_R01CW_ShmPublisher::begin(const char *name, uint32_t capacity) {
+    end();
+
+    uint32_t cap = 1;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+
+    // Readers still mapping a previous ring keep their (orphaned) copy
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    size_t size = shmSize(cap);
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+
+    // ftruncate() zero-fills: all stamps and the head start at 0
+    _hdr = static_cast<DYP_R01CW_ShmHeader *>(p);
+    _size = size;
+    _mask = cap - 1;
+    strncpy(_name, name, sizeof(_name) - 1);
+    _name[sizeof(_name) - 1] = '\0';
+
+    _hdr->version = DYP_R01CW_SHM_VERSION;
+    _hdr->capacity = cap;
+    _hdr->slotSize = sizeof(DYP_R01CW_ShmSlot);
+    _hdr->magic.store(DYP_R01CW_SHM_MAGIC, std::memory_order_release);
+
+    return true;
+}
+
+/*!
+ * @brief Unmap and remove the shared-memory ring
+ */
+void DYP_R01CW_ShmPublisher::end() {
+    if (_hdr != nullptr) {
+        munmap(_hdr, _size);
+        shm_unlink(_name);
+        _hdr = nullptr;
+    }
+}
+
+/*!
+ * @brief Publish a frame
+ * @param sample Raw sample
+ * @param distance Processed distance in millimeters
+ * @param bus Bus index
+ * @param event Threshold event
+ * @return Frame number
+ */
+uint64_t DYP_R01CW_ShmPublisher::publish(const DYP_R01CW_Sample &sample, int16_t distance, uint8_t bus,
+                                         uint8_t event) {
+    if (_hdr == nullptr) {
+        return 0;
+    }
+
+    uint64_t n = _hdr->head.load(std::memory_order_relaxed);
+    DYP_R01CW_ShmSlot &slot = _hdr->slots[n & _mask];
+
+    // Odd stamp: write in progress
+    slot.stamp.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.frame.seq = n;
+    slot.frame.timestamp = sample.timestamp;
+    slot.frame.raw = sample.raw;
+    slot.frame.distance = distance;
+    slot.frame.addr = sample.addr;
+    slot.frame.status = sample.status;
+    slot.frame.bus = bus;
+    slot.frame.event = event;
+
+    slot.stamp.store(2 * n + 2, std::memory_order_release);
+    _hdr->head.store(n + 1, std::memory_order_release);
+
+    return n;
+}
+
+/*!
+ * @brief Constructor
+ */
+DYP_R01CW_ShmReader::DYP_R01CW_ShmReader() {
+    _hdr = nullptr;
+    _size = 0;
+    _mask = 0;
+    _cursor = 0;
+    _lost = 0;
+}
+
+DYP_R01CW_ShmReader::~DYP_R01CW_ShmReader() {
+    end();
+}
+
+/*!
+ * @brief Map an existing ring read-only
+ * @param name Shared-memory object name
+ * @return true if the ring was mapped, false otherwise
+ */
+bool DYP_R01CW_ShmReader::begin(const char *name) {
+    end();
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(DYP_R01CW_ShmHeader)) {
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+
+    const DYP_R01CW_ShmHeader *hdr = static_cast<const DYP_R01CW_ShmHeader *>(p);
+    if (hdr->magic.load(std::memory_order_acquire) != DYP_R01CW_SHM_MAGIC || hdr->version != DYP_R01CW_SHM_VERSION ||
+        hdr->slotSize != sizeof(DYP_R01CW_ShmSlot) || (size_t)st.st_size < shmSize(hdr->capacity)) {
+        munmap(p, st.st_size);
+        return false;
+    }
+
+    _hdr = hdr;
+    _size = st.st_size;
+    _mask = hdr->capacity - 1;
+    _cursor = hdr->head.load(std::memory_order_acquire);
+    _lost = 0;
+
+    return true;
+}
+
+/*!
+ * @brief Unmap the ring
+ */
+void DYP_R01CW_ShmReader::end() {
+    if (_hdr != nullptr) {
+        munmap(const_cast<DYP_R01CW_ShmHeader *>(_hdr), _size);
+        _hdr = nullptr;
+    }
+}
+
+/*!
+ * @brief Copy frame n from its slot
+ */
+bool DYP_R01CW_ShmReader::readFrame(uint64_t n, DYP_R01CW_ShmFrame &frame) const {
+    const DYP_R01CW_ShmSlot &slot = _hdr->slots[n & _mask];
+
+    uint64_t s1 = slot.stamp.load(std::memory_order_acquire);
+    if (s1 != 2 * n + 2) {
+        return false;
+    }
+    memcpy(&frame, (const void *)&slot.frame, sizeof(frame));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t s2 = slot.stamp.load(std::memory_order_relaxed);
+
+    return (s1 == s2);
+}
+
+/*!
+ * @brief Read the most recent frame
+ * @param frame Destination
+ * @return true if a frame was read, false if none has been published yet
+ */
+bool DYP_R01CW_ShmReader::latest(DYP_R01CW_ShmFrame &frame) {
+    if (_hdr == nullptr) {
+        return false;
+    }
+
+    // Retry if the slot was overwritten while copying (publisher lapped the reader)
+    for (int i = 0; i < 4; i++) {
+        uint64_t head = _hdr->head.load(std::memory_order_acquire);
+        if (head == 0) {
+            return false;
+        }
+        if (readFrame(head - 1, frame)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * @brief Read frames published since the last call
+ * @param frames Destination array
+ * @param max Size of destination array
+ * @return Number of frames read
+ */
+size_t DYP_R01CW_ShmReader::poll(DYP_R01CW_ShmFrame *frames, size_t max) {
+    if (_hdr == nullptr) {
+        return 0;
+    }
+
+    uint64_t head = _hdr->head.load(std::memory_order_acquire);
+    uint64_t capacity = _mask + 1;
+    if (head - _cursor > capacity) {
+        _lost += head - _cursor - capacity;
+        _cursor = head - capacity;
+    }
+
+    size_t count = 0;
+    while (_cursor < head && count < max) {
+        if (readFrame(_cursor, frames[count])) {
+            count++;
+        } else {
+            _lost++;
+        }
+        _cursor++;
+    }
+
+    return count;
+}
@@ -0,0 +1,180 @@
+/*!
+ * @file DYP_R01CW_Shm.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - shared-memory sample ring
+ *
+ * @section intro_sec Introduction
+ *
+ * Publishes processed samples into a ring buffer in POSIX shared memory
+ * (/dev/shm/<name>). Any number of local processes can map the ring
+ * read-only and read frames directly from the mapping - no system calls,
+ * no kernel copies, and readers never block the publisher.
+ *
+ * Each slot is protected by a seqlock stamp: the publisher sets the stamp to
+ * an odd value while writing frame n and to 2 * (n + 1) when done. Readers
+ * check the stamp before and after copying a frame and detect frames that
+ * were overwritten while being read. The head counter (next frame number)
+ * is published with release semantics after each frame.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_SHM_H
+#define DYP_R01CW_SHM_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DYP_R01CW_Sample.h"
+
+#define DYP_R01CW_SHM_MAGIC 0x44595053u  // "DYPS"
+#define DYP_R01CW_SHM_VERSION 1
+#define DYP_R01CW_SHM_DEFAULT_NAME "/dyp_r01cw"
+#define DYP_R01CW_SHM_DEFAULT_CAPACITY 4096
+
+/*!
+ * @brief Published frame
+ */
+struct DYP_R01CW_ShmFrame {
+    uint64_t seq;        ///< Frame number (0, 1, 2, ...)
+    uint32_t timestamp;  ///< Sample timestamp in milliseconds
+    uint16_t raw;        ///< Raw DATA_REG value
+    int16_t distance;    ///< Processed distance in millimeters (-1 if invalid)
+    uint8_t addr;        ///< I2C address of the sensor in 8-bit format
+    uint8_t status;      ///< Sample status (DYP_R01CW_STATUS_*)
+    uint8_t bus;         ///< Bus index
+    uint8_t event;       ///< Threshold event (DYP_R01CW_EVENT_*)
+};
+
+/*!
+ * @brief Ring slot
+ *
+ * 8-byte stamp plus 24-byte frame (20 bytes of fields, padded to the
+ * alignment of seq) = 32 bytes, so slots never straddle a 64-byte cache
+ * line and one line holds two slots.
+ */
+struct DYP_R01CW_ShmSlot {
+    std::atomic<uint64_t> stamp;  ///< Seqlock stamp
+    DYP_R01CW_ShmFrame frame;     ///< Frame data
+};
+
+static_assert(sizeof(DYP_R01CW_ShmFrame) == 24, "DYP_R01CW_ShmFrame: unexpected layout");
+static_assert(sizeof(DYP_R01CW_ShmSlot) == 32, "DYP_R01CW_ShmSlot: unexpected layout");
+
+// The stamps and the head counter are shared between processes: a lock-based
+// atomic would keep its lock in process-local memory
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "DYP_R01CW_Shm requires lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "DYP_R01CW_Shm requires lock-free 32-bit atomics");
+
+/*!
+ * @brief Shared-memory header, followed by capacity slots
+ */
+struct DYP_R01CW_ShmHeader {
+    std::atomic<uint32_t> magic;  ///< DYP_R01CW_SHM_MAGIC once initialized
+    uint32_t version;             ///< DYP_R01CW_SHM_VERSION
+    uint32_t capacity;            ///< Number of slots (power of two)
+    uint32_t slotSize;            ///< sizeof(DYP_R01CW_ShmSlot)
+    alignas(64) std::atomic<uint64_t> head;  ///< Number of frames published
+    alignas(64) DYP_R01CW_ShmSlot slots[1];  ///< Ring slots
+};
+
+/*!
+ * @brief Shared-memory publisher (single writer; serialize calls to publish())
+ */
+class DYP_R01CW_ShmPublisher {
+public:
+    DYP_R01CW_ShmPublisher();
+    ~DYP_R01CW_ShmPublisher();
+
+    /*!
+     * @brief Create (or replace) the shared-memory ring
+     * @param name Shared-memory object name (default: DYP_R01CW_SHM_DEFAULT_NAME)
+     * @param capacity Number of slots, rounded up to a power of two
+     * @return true if the ring was created, false otherwise
+     */
+    bool begin(const char *name = DYP_R01CW_SHM_DEFAULT_NAME, uint32_t capacity = DYP_R01CW_SHM_DEFAULT_CAPACITY);
+
+    /*!
+     * @brief Unmap and remove the shared-memory ring
+     */
+    void end();
+
+    /*!
+     * @brief Publish a frame
+     * @param sample Raw sample
+     * @param distance Processed distance in millimeters
+     * @param bus Bus index
+     * @param event Threshold event
+     * @return Frame number
+     */
+    uint64_t publish(const DYP_R01CW_Sample &sample, int16_t distance, uint8_t bus = 0, uint8_t event = 0);
+
+private:
+    DYP_R01CW_ShmHeader *_hdr;  ///< Mapping, nullptr if closed
+    size_t _size;               ///< Mapping size
+    uint64_t _mask;             ///< capacity - 1
+    char _name[64];             ///< Shared-memory object name
+};
+
+/*!
+ * @brief Shared-memory reader
+ */
+class DYP_R01CW_ShmReader {
+public:
+    DYP_R01CW_ShmReader();
+    ~DYP_R01CW_ShmReader();
+
+    /*!
+     * @brief Map an existing ring read-only
+     * @param name Shared-memory object name
+     * @return true if the ring was mapped, false otherwise
+     * @note The read cursor starts at the current head, i.e. only new frames are returned by poll()
+     */
+    bool begin(const char *name = DYP_R01CW_SHM_DEFAULT_NAME);
+
+    /*!
+     * @brief Unmap the ring
+     */
+    void end();
+
+    /*!
+     * @brief Read the most recent frame
+     * @param frame Destination
+     * @return true if a frame was read, false if none has been published yet
+     */
+    bool latest(DYP_R01CW_ShmFrame &frame);
+
+    /*!
+     * @brief Read frames published since the last call
+     * @param frames Destination array
+     * @param max Size of destination array
+     * @return Number of frames read
+     * @note Frames overwritten before they could be read are counted by lost()
+     */
+    size_t poll(DYP_R01CW_ShmFrame *frames, size_t max);
+
+    /*!
+     * @brief Get the number of frames lost by this reader
+     * @return Number of frames overwritten before they were read
+     */
+    uint64_t lost() const { return _lost; }
+
+private:
+    // Copy frame n; returns false if it is not (or no longer) in its slot
+    bool readFrame(uint64_t n, DYP_R01CW_ShmFrame &frame) const;
+
+    const DYP_R01CW_ShmHeader *_hdr;  ///< Mapping, nullptr if closed
+    size_t _size;                     ///< Mapping size
+    uint64_t _mask;                   ///< capacity - 1
+    uint64_t _cursor;                 ///< Next frame to read
+    uint64_t _lost;                   ///< Lost frames
+};
+
+#endif // DYP_R01CW_SHM_H
@@ -0,0 +1,543 @@
+/*!
+ * @file dyp_daemon.cpp
+ *
+ * @brief Multi-bus DYP-R01CW acquisition daemon for Linux
+ *
+ * Polls DYP-R01CW sensors on one or more I2C buses at a fixed rate.
+ * Each bus runs its own event loop thread (epoll) with two timerfds:
+ * a periodic trigger timer and a one-shot readout timer armed
+ * DYP_R01CW_CONVERSION_TIME_MS after each trigger. Triggers and readouts of
+ * all sensors on a bus are batched into one I2C_RDWR ioctl each.
+ * Readout batches are handed to a worker pool which runs the processing
+ * chain (DYP_R01CW_Pipeline) per sensor; all batches of a bus go to the same
+ * worker, so per-sensor filter state is updated in order.
+ * No thread busy-waits: all threads block in epoll_wait() or on a condition
+ * variable.
+ *
+ * Per-bus statistics (cycles, errors, timer overruns, wake-up jitter) are
+ * printed to stderr every -s seconds and on SIGUSR1.
+ *
+ * With -p, processed samples are also published to a shared-memory ring
+ * (see DYP_R01CW_Shm.h) for local consumers.
+ *
+ * Usage:
+ *   dyp_daemon -b bus:addr[,addr...] [-b ...] [-r rate_hz] [-w workers] [-s stats_s]
+ *              [-o offset] [-m median] [-e ema_shift] [-T threshold] [-H hysteresis] [-p shm_name] [-q]
+ *
+ * Output (stdout, CSV): timestamp_ms,bus,addr,raw,distance,event
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -pthread -I../../src dyp_daemon.cpp DYP_R01CW_Linux.cpp \
+ *       DYP_R01CW_Shm.cpp ../../src/DYP_R01CW_Processing.cpp -o dyp_daemon
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DYP_R01CW_Linux.h"
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_Shm.h"
+
+/*!
+ * @brief Processing parameters (applied to all sensors)
+ */
+struct ProcessingConfig {
+    int16_t offset = 0;
+    uint8_t median = 1;
+    uint8_t emaShift = 0;
+    int16_t threshold = 0;
+    uint16_t hysteresis = 0;
+};
+
+/*!
+ * @brief Per-bus statistics
+ */
+struct BusStats {
+    std::atomic<uint64_t> cycles{0};        ///< Trigger cycles
+    std::atomic<uint64_t> triggerErrors{0}; ///< Cycles with failed triggers
+    std::atomic<uint64_t> samplesOk{0};     ///< Valid samples
+    std::atomic<uint64_t> samplesBad{0};    ///< Invalid samples
+    std::atomic<uint64_t> overruns{0};      ///< Missed trigger periods
+    std::atomic<uint64_t> jitterSumUs{0};   ///< Sum of trigger wake-up delays
+    std::atomic<uint64_t> jitterMaxUs{0};   ///< Max. trigger wake-up delay
+    std::atomic<uint64_t> busTimeUs{0};     ///< Time spent in ioctls
+};
+
+/*!
+ * @brief Batch of samples read in one cycle
+ */
+struct Batch {
+    size_t bus;
+    std::vector<DYP_R01CW_Sample> samples;
+};
+
+/*!
+ * @brief Processing worker with its own queue
+ */
+class Worker {
+public:
+    Worker(const ProcessingConfig &cfg, bool quiet, DYP_R01CW_ShmPublisher *publisher)
+        : _cfg(cfg), _quiet(quiet), _publisher(publisher) {
+        _thread = std::thread(&Worker::run, this);
+    }
+
+    ~Worker() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_one();
+        _thread.join();
+    }
+
+    void push(Batch &&batch) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(std::move(batch));
+        }
+        _cv.notify_one();
+    }
+
+private:
+    void run() {
+        static const char *eventNames[] = {"", "enter", "leave"};
+        std::string out;
+        char line[96];
+        for (;;) {
+            Batch batch;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this]() { return _stop || !_queue.empty(); });
+                if (_queue.empty()) {
+                    return;
+                }
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            out.clear();
+            for (const DYP_R01CW_Sample &s : batch.samples) {
+                DYP_R01CW_Pipeline &p = pipeline(batch.bus, s.addr);
+                int16_t distance = -1;
+                uint8_t event = p.process(s, distance);
+                if (_publisher != nullptr) {
+                    // Held for one frame only - processing and formatting run concurrently
+                    std::lock_guard<std::mutex> lock(publisherMutex());
+                    _publisher->publish(s, distance, (uint8_t)batch.bus, event);
+                }
+                if (_quiet || s.status != DYP_R01CW_STATUS_OK) {
+                    continue;
+                }
+                int n = snprintf(line, sizeof(line), "%" PRIu32 ",%zu,0x%02X,%u,%d,%s\n", s.timestamp, batch.bus,
+                                 s.addr, s.raw, distance, eventNames[event]);
+                out.append(line, n);
+            }
+            if (!out.empty()) {
+                std::lock_guard<std::mutex> lock(outputMutex());
+                fwrite(out.data(), 1, out.size(), stdout);
+                fflush(stdout);
+            }
+        }
+    }
+
+    DYP_R01CW_Pipeline &pipeline(size_t bus, uint8_t addr) {
+        size_t key = bus * 256 + addr;
+        if (key >= _pipelines.size()) {
+            _pipelines.resize(key + 1);
+        }
+        if (!_pipelines[key]) {
+            _pipelines[key].reset(new DYP_R01CW_Pipeline());
+            _pipelines[key]->setDistanceOffset(_cfg.offset);
+            _pipelines[key]->setMedianWindow(_cfg.median);
+            _pipelines[key]->setEmaShift(_cfg.emaShift);
+            _pipelines[key]->setThreshold(_cfg.threshold, _cfg.hysteresis);
+        }
+        return *_pipelines[key];
+    }
+
+    static std::mutex &outputMutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    // The ring has a single writer - serialize publishing workers
+    static std::mutex &publisherMutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    ProcessingConfig _cfg;
+    bool _quiet;
+    DYP_R01CW_ShmPublisher *_publisher;
+    std::vector<std::unique_ptr<DYP_R01CW_Pipeline>> _pipelines;
+    std::deque<Batch> _queue;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stop = false;
+    std::thread _thread;
+};
+
+/*!
+ * @brief Acquisition loop of one I2C bus
+ */
+class BusLoop {
+public:
+    BusLoop(size_t index, int busNumber, const std::vector<uint8_t> &addrs)
+        : _index(index), _busNumber(busNumber), _addrs(addrs) {}
+
+    ~BusLoop() {
+        stop();
+        for (int fd : {_triggerFd, _readFd, _stopFd, _epollFd}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    bool begin() {
+        if (!_bus.begin(_busNumber)) {
+            fprintf(stderr, "bus %d: cannot open /dev/i2c-%d: %s\n", _busNumber, _busNumber, strerror(errno));
+            return false;
+        }
+        for (uint8_t a : _addrs) {
+            _sensors.emplace_back(new DYP_R01CW_Linux(a));
+            if (!_sensors.back()->begin(&_bus)) {
+                fprintf(stderr, "bus %d: sensor 0x%02X not responding\n", _busNumber, a);
+            }
+            _sensorPtrs.push_back(_sensors.back().get());
+        }
+        _triggerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        _readFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        _stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        _epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (_triggerFd < 0 || _readFd < 0 || _stopFd < 0 || _epollFd < 0) {
+            perror("bus loop");
+            return false;
+        }
+        for (int fd : {_triggerFd, _readFd, _stopFd}) {
+            struct epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev);
+        }
+        return true;
+    }
+
+    void start(uint32_t periodUs, Worker *worker) {
+        _periodUs = periodUs;
+        _worker = worker;
+        _thread = std::thread(&BusLoop::run, this);
+    }
+
+    void stop() {
+        if (_thread.joinable()) {
+            uint64_t one = 1;
+            (void)!write(_stopFd, &one, sizeof(one));
+            _thread.join();
+        }
+    }
+
+    void printStats(FILE *f) const {
+        uint64_t cycles = _stats.cycles;
+        uint64_t ok = _stats.samplesOk;
+        uint64_t bad = _stats.samplesBad;
+        fprintf(f,
+                "bus %d: sensors %zu cycles %" PRIu64 " trigger_err %" PRIu64 " ok %" PRIu64 " bad %" PRIu64
+                " err_rate %.3f%% overruns %" PRIu64 " jitter_avg %.1fus jitter_max %" PRIu64
+                "us bus_time_avg %.1fus\n",
+                _busNumber, _sensors.size(), cycles, (uint64_t)_stats.triggerErrors, ok, bad,
+                (ok + bad) ? 100.0 * bad / (ok + bad) : 0.0, (uint64_t)_stats.overruns,
+                cycles ? (double)_stats.jitterSumUs / cycles : 0.0, (uint64_t)_stats.jitterMaxUs,
+                cycles ? (double)_stats.busTimeUs / cycles : 0.0);
+    }
+
+private:
+    static void armAbsolute(int fd, uint64_t us, uint32_t intervalUs) {
+        struct itimerspec its = {};
+        its.it_value.tv_sec = us / 1000000u;
+        its.it_value.tv_nsec = (us % 1000000u) * 1000;
+        its.it_interval.tv_sec = intervalUs / 1000000u;
+        its.it_interval.tv_nsec = (intervalUs % 1000000u) * 1000;
+        timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, nullptr);
+    }
+
+    void run() {
+        DYP_R01CW_LinuxIo &io = _bus.io();
+        // Start on the next full period, so the buses run phase-aligned
+        uint64_t next = (io.micros() / _periodUs + 1) * _periodUs;
+        armAbsolute(_triggerFd, next, _periodUs);
+
+        struct epoll_event events[3];
+        for (;;) {
+            int n = epoll_wait(_epollFd, events, 3, -1);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("epoll_wait");
+                return;
+            }
+            for (int i = 0; i < n; i++) {
+                int fd = events[i].data.fd;
+                uint64_t expirations = 0;
+                if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                    continue;
+                }
+                if (fd == _stopFd) {
+                    return;
+                }
+                if (fd == _triggerFd) {
+                    onTrigger(io, next, expirations);
+                    next += expirations * _periodUs;
+                } else if (fd == _readFd) {
+                    onReadout(io);
+                }
+            }
+        }
+    }
+
+    void onTrigger(DYP_R01CW_LinuxIo &io, uint64_t scheduled, uint64_t expirations) {
+        uint64_t now = io.micros();
+        uint64_t late = (expirations - 1) * _periodUs;
+        uint64_t jitter = now - scheduled - late;
+        _stats.cycles++;
+        _stats.overruns += expirations - 1;
+        _stats.jitterSumUs += jitter;
+        if (jitter > _stats.jitterMaxUs) {
+            _stats.jitterMaxUs = jitter;
+        }
+
+        if (!_bus.triggerAll(_sensorPtrs.data(), _sensorPtrs.size())) {
+            _stats.triggerErrors++;
+        }
+        _triggerTime = io.micros();
+        _stats.busTimeUs += _triggerTime - now;
+        armAbsolute(_readFd, _triggerTime + DYP_R01CW_CONVERSION_TIME_MS * 1000u, 0);
+    }
+
+    void onReadout(DYP_R01CW_LinuxIo &io) {
+        uint64_t start = io.micros();
+        Batch batch;
+        batch.bus = _index;
+        batch.samples.resize(_sensorPtrs.size());
+        size_t ok = _bus.readAll(_sensorPtrs.data(), _sensorPtrs.size(), batch.samples.data());
+        _stats.busTimeUs += io.micros() - start;
+        _stats.samplesOk += ok;
+        _stats.samplesBad += _sensorPtrs.size() - ok;
+        _worker->push(std::move(batch));
+    }
+
+    size_t _index;
+    int _busNumber;
+    std::vector<uint8_t> _addrs;
+    DYP_R01CW_LinuxBus _bus;
+    std::vector<std::unique_ptr<DYP_R01CW_Linux>> _sensors;
+    std::vector<DYP_R01CW_Linux *> _sensorPtrs;
+    int _triggerFd = -1;
+    int _readFd = -1;
+    int _stopFd = -1;
+    int _epollFd = -1;
+    uint32_t _periodUs = 0;
+    uint64_t _triggerTime = 0;
+    Worker *_worker = nullptr;
+    BusStats _stats;
+    std::thread _thread;
+};
+
+static void usage() {
+    fprintf(stderr, "Usage: dyp_daemon -b bus:addr[,addr...] [-b ...] [-r rate_hz] [-w workers] [-s stats_s]\n"
+                    "                  [-o offset] [-m median] [-e ema_shift] [-T threshold] [-H hysteresis] [-p shm_name] [-q]\n");
+}
+
+static bool parseBus(const char *arg, int &bus, std::vector<uint8_t> &addrs) {
+    char *end;
+    bus = (int)strtol(arg, &end, 10);
+    if (*end != ':') {
+        return false;
+    }
+    const char *p = end + 1;
+    while (*p) {
+        long a = strtol(p, &end, 0);
+        if (end == p || !DYP_R01CW_isValidAddress((uint8_t)a)) {
+            return false;
+        }
+        addrs.push_back((uint8_t)a);
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return !addrs.empty();
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::pair<int, std::vector<uint8_t>>> busArgs;
+    double rate = 10.0;
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    int statsInterval = 10;
+    bool quiet = false;
+    const char *shmName = nullptr;
+    ProcessingConfig cfg;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:r:w:s:o:m:e:T:H:p:qh")) != -1) {
+        switch (opt) {
+        case 'b': {
+            int bus;
+            std::vector<uint8_t> addrs;
+            if (!parseBus(optarg, bus, addrs)) {
+                fprintf(stderr, "invalid bus specification '%s'\n", optarg);
+                return 2;
+            }
+            busArgs.emplace_back(bus, addrs);
+            break;
+        }
+        case 'r':
+            rate = atof(optarg);
+            break;
+        case 'w':
+            workers = std::max(1, atoi(optarg));
+            break;
+        case 's':
+            statsInterval = atoi(optarg);
+            break;
+        case 'o':
+            cfg.offset = (int16_t)atoi(optarg);
+            break;
+        case 'm':
+            cfg.median = (uint8_t)atoi(optarg);
+            break;
+        case 'e':
+            cfg.emaShift = (uint8_t)atoi(optarg);
+            break;
+        case 'T':
+            cfg.threshold = (int16_t)atoi(optarg);
+            break;
+        case 'H':
+            cfg.hysteresis = (uint16_t)atoi(optarg);
+            break;
+        case 'p':
+            shmName = optarg;
+            break;
+        case 'q':
+            quiet = true;
+            break;
+        default:
+            usage();
+            return 2;
+        }
+    }
+    if (busArgs.empty() || rate <= 0) {
+        usage();
+        return 2;
+    }
+    // Trigger, conversion and readout must fit into one period
+    const double maxRate = 1000.0 / (DYP_R01CW_CONVERSION_TIME_MS + 5);
+    if (rate > maxRate) {
+        fprintf(stderr, "rate limited to %.1f Hz (conversion time %d ms)\n", maxRate, DYP_R01CW_CONVERSION_TIME_MS);
+        rate = maxRate;
+    }
+    uint32_t periodUs = (uint32_t)(1e6 / rate);
+
+    // Handle signals synchronously in the main thread (inherited by all threads)
+    sigset_t sigs;
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    sigaddset(&sigs, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &sigs, nullptr);
+
+    DYP_R01CW_ShmPublisher publisher;
+    if (shmName != nullptr && !publisher.begin(shmName)) {
+        fprintf(stderr, "cannot create shared memory %s: %s\n", shmName, strerror(errno));
+        return 1;
+    }
+
+    workers = std::min<unsigned>(workers, busArgs.size());
+    std::vector<std::unique_ptr<Worker>> pool;
+    for (unsigned i = 0; i < workers; i++) {
+        pool.emplace_back(new Worker(cfg, quiet, shmName ? &publisher : nullptr));
+    }
+
+    std::vector<std::unique_ptr<BusLoop>> loops;
+    for (size_t i = 0; i < busArgs.size(); i++) {
+        loops.emplace_back(new BusLoop(i, busArgs[i].first, busArgs[i].second));
+        if (!loops.back()->begin()) {
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < loops.size(); i++) {
+        loops[i]->start(periodUs, pool[i % workers].get());
+    }
+
+    int sigFd = signalfd(-1, &sigs, SFD_CLOEXEC);
+    int statsFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (statsInterval > 0) {
+        struct itimerspec its = {};
+        its.it_value.tv_sec = statsInterval;
+        its.it_interval.tv_sec = statsInterval;
+        timerfd_settime(statsFd, 0, &its, nullptr);
+    }
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    for (int fd : {sigFd, statsFd}) {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    bool running = true;
+    while (running) {
+        struct epoll_event ev;
+        if (epoll_wait(epollFd, &ev, 1, -1) != 1) {
+            continue;
+        }
+        bool print = false;
+        if (ev.data.fd == sigFd) {
+            struct signalfd_siginfo si;
+            if (read(sigFd, &si, sizeof(si)) == sizeof(si)) {
+                print = true;
+                running = (si.ssi_signo == SIGUSR1);
+            }
+        } else {
+            uint64_t expirations;
+            print = (read(statsFd, &expirations, sizeof(expirations)) == sizeof(expirations));
+        }
+        if (print) {
+            for (const auto &loop : loops) {
+                loop->printStats(stderr);
+            }
+        }
+    }
+
+    loops.clear();
+    pool.clear();
+    close(epollFd);
+    close(statsFd);
+    close(sigFd);
+
+    return 0;
+}
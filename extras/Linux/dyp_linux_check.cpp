@@ -0,0 +1,367 @@
+/*!
+ * @file dyp_linux_check.cpp
+ *
+ * @brief Hardware-free check of the Linux i2c-dev backend
+ *
+ * Drives DYP_R01CW_LinuxBus and DYP_R01CW_Linux through a recording
+ * DYP_R01CW_LinuxIo which behaves like the kernel: the messages of one
+ * I2C_RDWR transfer are executed in order and the transfer is aborted at the
+ * first message to a sensor which does not acknowledge. Checks
+ *
+ * - the message layout of register reads (pointer write and data read with
+ *   repeated start in one transfer) and of triggers
+ * - batching of triggerAll() and readAll() into as few transfers as
+ *   I2C_RDWR_IOCTL_MAX_MSGS allows
+ * - the NACK fallbacks: triggerAll() retries only the failing sensor and
+ *   never triggers a sensor twice, whether the adapter reports the number of
+ *   transferred messages or only an error; after an error at an unknown
+ *   position, the samples of the sensors not known to be triggered fail
+ *   for that cycle; readAll() still returns the samples of the other sensors
+ *
+ * Prints each failed check and exits with status 1 if any check failed.
+ *
+ * Usage:
+ *   dyp_linux_check
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I../../src dyp_linux_check.cpp DYP_R01CW_Linux.cpp \
+ *       ../../src/DYP_R01CW_Processing.cpp -o dyp_linux_check
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "DYP_R01CW_Linux.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+/*!
+ * @brief Copy of one message of a transfer
+ */
+struct Msg {
+    uint16_t addr;
+    uint16_t flags;
+    std::vector<uint8_t> data;  ///< Bytes written (write messages only)
+    uint16_t len;
+};
+
+/*!
+ * @brief Recording system call layer with simulated sensors
+ *
+ * Every 7-bit address answers reads of DATA_REG with 1000 + address and of
+ * VERSION_REG with 0x0102, unless it is in the NACK set.
+ */
+class FakeIo : public DYP_R01CW_LinuxIo {
+public:
+    int open(const char *) override { return 3; }
+    void close(int) override {}
+    uint64_t micros() override { return 5000000; }
+    void sleep(uint32_t) override {}
+
+    int transfer(int fd, struct i2c_rdwr_ioctl_data *data) override {
+        if (fd != 3) {
+            return -1;
+        }
+        transfers.push_back(std::vector<Msg>());
+        std::vector<Msg> &rec = transfers.back();
+        uint8_t ptr = 0xFF;
+        for (uint32_t i = 0; i < data->nmsgs; i++) {
+            const struct i2c_msg &m = data->msgs[i];
+            Msg r;
+            r.addr = m.addr;
+            r.flags = m.flags;
+            r.len = m.len;
+            if (!(m.flags & I2C_M_RD)) {
+                r.data.assign(m.buf, m.buf + m.len);
+            }
+            rec.push_back(r);
+            if (m.addr < 128 && nack[m.addr]) {
+                return reportCount ? (int)i : -1;
+            }
+            if (m.flags & I2C_M_RD) {
+                uint16_t v = (ptr == DYP_R01CW_VERSION_REG) ? 0x0102 : 1000 + m.addr;
+                m.buf[0] = v >> 8;
+                if (m.len > 1) {
+                    m.buf[1] = v & 0xFF;
+                }
+            } else if (m.len > 0) {
+                ptr = m.buf[0];
+                if (m.len >= 2 && m.buf[0] == DYP_R01CW_COMMAND_REG && m.buf[1] == DYP_R01CW_MEASURE_COMMAND) {
+                    triggers[m.addr]++;
+                }
+            }
+        }
+        return (int)data->nmsgs;
+    }
+
+    void clear() {
+        transfers.clear();
+        for (int i = 0; i < 128; i++) {
+            triggers[i] = 0;
+        }
+    }
+
+    std::vector<std::vector<Msg>> transfers;  ///< Recorded transfers
+    int triggers[128] = {};                   ///< Triggers acknowledged per 7-bit address
+    bool nack[128] = {};                      ///< Addresses which do not acknowledge
+    bool reportCount = false;                 ///< Report transferred messages instead of -1 on NACK
+};
+
+static bool isTrigger(const Msg &m) {
+    return m.flags == 0 && m.data.size() == 2 && m.data[0] == DYP_R01CW_COMMAND_REG &&
+           m.data[1] == DYP_R01CW_MEASURE_COMMAND;
+}
+
+static bool isProbe(const Msg &m) {
+    return m.flags == 0 && m.len == 0;
+}
+
+/*!
+ * @brief Register read: pointer write and data read in one transfer
+ */
+static void checkLayout() {
+    FakeIo io;
+    DYP_R01CW_LinuxBus bus(io);
+    CHECK(bus.begin(1));
+    DYP_R01CW_Linux sensor(0xE8);
+    CHECK(sensor.begin(&bus));
+    CHECK(io.transfers.size() == 1);
+    if (io.transfers.size() == 1) {
+        const std::vector<Msg> &t = io.transfers[0];
+        CHECK(t.size() == 2);
+        if (t.size() == 2) {
+            CHECK(t[0].addr == 0x74 && t[0].flags == 0 && t[0].data == std::vector<uint8_t>{DYP_R01CW_VERSION_REG});
+            CHECK(t[1].addr == 0x74 && t[1].flags == I2C_M_RD && t[1].len == 2);
+        }
+    }
+    CHECK(sensor.readSoftwareVersion() == 0x0102);
+
+    io.clear();
+    DYP_R01CW_Sample s;
+    CHECK(sensor.readSample(s));
+    CHECK(s.addr == 0xE8 && s.raw == 1000 + 0x74 && s.status == DYP_R01CW_STATUS_OK && s.timestamp == 5000);
+    CHECK(io.transfers.size() == 2);
+    if (io.transfers.size() == 2) {
+        CHECK(io.transfers[0].size() == 1 && isTrigger(io.transfers[0][0]));
+        CHECK(io.transfers[1].size() == 2 && io.transfers[1][0].data == std::vector<uint8_t>{DYP_R01CW_DATA_REG} &&
+              io.transfers[1][1].flags == I2C_M_RD);
+    }
+}
+
+/*!
+ * @brief Create count sensors at consecutive 7-bit addresses from 0x10
+ */
+static void makeSensors(DYP_R01CW_LinuxBus &bus, size_t count, std::vector<DYP_R01CW_Linux> &sensors,
+                        std::vector<DYP_R01CW_Linux *> &ptrs) {
+    sensors.clear();
+    ptrs.clear();
+    for (size_t i = 0; i < count; i++) {
+        sensors.push_back(DYP_R01CW_Linux((uint8_t)((0x10 + i) << 1)));
+    }
+    for (auto &s : sensors) {
+        s.begin(&bus);
+        ptrs.push_back(&s);
+    }
+}
+
+/*!
+ * @brief Batching of triggers and readouts
+ */
+static void checkBatching() {
+    const size_t count = I2C_RDWR_IOCTL_MAX_MSGS + 8;
+    FakeIo io;
+    DYP_R01CW_LinuxBus bus(io);
+    bus.begin(1);
+    std::vector<DYP_R01CW_Linux> sensors;
+    std::vector<DYP_R01CW_Linux *> ptrs;
+    makeSensors(bus, count, sensors, ptrs);
+
+    io.clear();
+    CHECK(bus.triggerAll(ptrs.data(), count));
+    CHECK(io.transfers.size() == 2);
+    if (io.transfers.size() == 2) {
+        CHECK(io.transfers[0].size() == I2C_RDWR_IOCTL_MAX_MSGS);
+        CHECK(io.transfers[1].size() == 8);
+        for (const auto &t : io.transfers) {
+            for (const Msg &m : t) {
+                CHECK(isTrigger(m));
+            }
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        CHECK(io.triggers[0x10 + i] == 1);
+    }
+
+    // Two messages per sensor: I2C_RDWR_IOCTL_MAX_MSGS / 2 sensors per transfer
+    io.clear();
+    std::vector<DYP_R01CW_Sample> samples(count);
+    CHECK(bus.readAll(ptrs.data(), count, samples.data()) == count);
+    const size_t perXfer = I2C_RDWR_IOCTL_MAX_MSGS / 2;
+    CHECK(io.transfers.size() == (count + perXfer - 1) / perXfer);
+    for (size_t t = 0; t < io.transfers.size(); t++) {
+        const std::vector<Msg> &msgs = io.transfers[t];
+        for (size_t j = 0; j + 1 < msgs.size(); j += 2) {
+            uint16_t addr = 0x10 + t * perXfer + j / 2;
+            CHECK(msgs[j].addr == addr && msgs[j].flags == 0 &&
+                  msgs[j].data == std::vector<uint8_t>{DYP_R01CW_DATA_REG});
+            CHECK(msgs[j + 1].addr == addr && msgs[j + 1].flags == I2C_M_RD && msgs[j + 1].len == 2);
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        CHECK(samples[i].addr == ((0x10 + i) << 1) && samples[i].raw == 1000 + 0x10 + i &&
+              samples[i].status == DYP_R01CW_STATUS_OK);
+    }
+}
+
+/*!
+ * @brief NACK of one sensor in a combined trigger transfer
+ * @param reportCount true if the adapter reports the number of transferred messages
+ */
+static void checkTriggerNack(bool reportCount) {
+    const size_t count = 6;
+    const size_t bad = 2;
+    FakeIo io;
+    DYP_R01CW_LinuxBus bus(io);
+    bus.begin(1);
+    std::vector<DYP_R01CW_Linux> sensors;
+    std::vector<DYP_R01CW_Linux *> ptrs;
+    makeSensors(bus, count, sensors, ptrs);
+
+    io.clear();
+    io.reportCount = reportCount;
+    io.nack[0x10 + bad] = true;
+    CHECK(!bus.triggerAll(ptrs.data(), count));
+
+    // Every other sensor triggered exactly once - no restarted conversions
+    for (size_t i = 0; i < count; i++) {
+        CHECK(io.triggers[0x10 + i] == (i == bad ? 0 : 1));
+    }
+
+    // Combined transfer, [probes,] retry of the failing sensor, combined transfer of the rest
+    size_t probes = 0;
+    size_t retries = 0;
+    for (size_t t = 1; t < io.transfers.size(); t++) {
+        const std::vector<Msg> &msgs = io.transfers[t];
+        if (msgs.size() == 1 && isProbe(msgs[0])) {
+            probes++;
+            CHECK(msgs[0].addr <= 0x10 + bad);
+        } else if (msgs.size() == 1 && isTrigger(msgs[0]) && msgs[0].addr == 0x10 + bad) {
+            retries++;
+        }
+    }
+    CHECK(probes == (reportCount ? 0 : bad + 1));
+    CHECK(retries == 1);
+    const std::vector<Msg> &last = io.transfers.back();
+    CHECK(last.size() == count - bad - 1 && last[0].addr == 0x10 + bad + 1);
+}
+
+/*!
+ * @brief Recording system call layer whose next combined transfer fails after some messages
+ */
+class FlakyIo : public FakeIo {
+public:
+    int transfer(int fd, struct i2c_rdwr_ioctl_data *data) override {
+        if (failAfter != 0 && data->nmsgs > failAfter) {
+            data->nmsgs = failAfter;
+            failAfter = 0;
+            FakeIo::transfer(fd, data);
+            return -1;
+        }
+        return FakeIo::transfer(fd, data);
+    }
+
+    uint32_t failAfter = 0;  ///< Messages of the next combined transfer before the error (0: none)
+};
+
+/*!
+ * @brief Transient error in a combined trigger transfer (all sensors acknowledge the probes)
+ */
+static void checkTriggerTransient() {
+    const size_t count = 6;
+    FlakyIo io;
+    DYP_R01CW_LinuxBus bus(io);
+    bus.begin(1);
+    std::vector<DYP_R01CW_Linux> sensors;
+    std::vector<DYP_R01CW_Linux *> ptrs;
+    makeSensors(bus, count, sensors, ptrs);
+
+    io.clear();
+    io.failAfter = 3;
+    CHECK(!bus.triggerAll(ptrs.data(), count));
+    // No sensor is triggered twice
+    for (size_t i = 0; i < count; i++) {
+        CHECK(io.triggers[0x10 + i] <= 1);
+    }
+    // The error position is unknown, so no trigger of this cycle is confirmed
+    std::vector<DYP_R01CW_Sample> samples(count);
+    CHECK(bus.readAll(ptrs.data(), count, samples.data()) == 0);
+    for (size_t i = 0; i < count; i++) {
+        CHECK(samples[i].status == DYP_R01CW_STATUS_BUS_ERROR);
+    }
+
+    // The next cycle is complete again
+    CHECK(bus.triggerAll(ptrs.data(), count));
+    CHECK(bus.readAll(ptrs.data(), count, samples.data()) == count);
+}
+
+/*!
+ * @brief NACK of one sensor in a combined readout transfer
+ */
+static void checkReadNack() {
+    const size_t count = 5;
+    const size_t bad = 3;
+    FakeIo io;
+    DYP_R01CW_LinuxBus bus(io);
+    bus.begin(1);
+    std::vector<DYP_R01CW_Linux> sensors;
+    std::vector<DYP_R01CW_Linux *> ptrs;
+    makeSensors(bus, count, sensors, ptrs);
+
+    io.clear();
+    io.nack[0x10 + bad] = true;
+    std::vector<DYP_R01CW_Sample> samples(count);
+    CHECK(bus.readAll(ptrs.data(), count, samples.data()) == count - 1);
+    // One combined transfer, then one register read per sensor
+    CHECK(io.transfers.size() == 1 + count);
+    for (size_t i = 0; i < count; i++) {
+        if (i == bad) {
+            CHECK(samples[i].status == DYP_R01CW_STATUS_BUS_ERROR && samples[i].raw == DYP_R01CW_RAW_INVALID);
+        } else {
+            CHECK(samples[i].status == DYP_R01CW_STATUS_OK && samples[i].raw == 1000 + 0x10 + i);
+        }
+        CHECK(samples[i].addr == ((0x10 + i) << 1));
+    }
+}
+
+int main() {
+    checkLayout();
+    checkBatching();
+    checkTriggerNack(false);
+    checkTriggerNack(true);
+    checkTriggerTransient();
+    checkReadNack();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*!
+ * @file dyp_shm_cat.cpp
+ *
+ * @brief Example consumer of the DYP-R01CW shared-memory sample ring
+ *
+ * Maps the ring published by dyp_daemon -p and prints frames as CSV
+ * (seq,timestamp_ms,bus,addr,raw,distance,status,event). Reading the ring
+ * requires no system calls; the tool only sleeps between polls.
+ *
+ * Usage:
+ *   dyp_shm_cat [-n shm_name] [-i interval_ms] [-l]
+ *
+ *   -l prints only the latest frame once per interval instead of every frame
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -I../../src dyp_shm_cat.cpp DYP_R01CW_Shm.cpp -o dyp_shm_cat
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+#include "DYP_R01CW_Shm.h"
+
+static void print(const DYP_R01CW_ShmFrame &f) {
+    printf("%" PRIu64 ",%" PRIu32 ",%u,0x%02X,%u,%d,%u,%u\n", f.seq, f.timestamp, f.bus, f.addr, f.raw, f.distance,
+           f.status, f.event);
+}
+
+int main(int argc, char **argv) {
+    const char *name = DYP_R01CW_SHM_DEFAULT_NAME;
+    unsigned intervalMs = 10;
+    bool latestOnly = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:i:lh")) != -1) {
+        switch (opt) {
+        case 'n':
+            name = optarg;
+            break;
+        case 'i':
+            intervalMs = (unsigned)atoi(optarg);
+            break;
+        case 'l':
+            latestOnly = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: dyp_shm_cat [-n shm_name] [-i interval_ms] [-l]\n");
+            return 2;
+        }
+    }
+
+    DYP_R01CW_ShmReader reader;
+    if (!reader.begin(name)) {
+        fprintf(stderr, "cannot map shared memory %s\n", name);
+        return 1;
+    }
+
+    DYP_R01CW_ShmFrame frames[256];
+    uint64_t lastSeq = UINT64_MAX;
+    uint64_t lost = 0;
+    for (;;) {
+        if (latestOnly) {
+            if (reader.latest(frames[0]) && frames[0].seq != lastSeq) {
+                lastSeq = frames[0].seq;
+                print(frames[0]);
+            }
+        } else {
+            size_t n;
+            while ((n = reader.poll(frames, 256)) > 0) {
+                for (size_t i = 0; i < n; i++) {
+                    print(frames[i]);
+                }
+            }
+            if (reader.lost() != lost) {
+                lost = reader.lost();
+                fprintf(stderr, "%" PRIu64 " frames lost\n", lost);
+            }
+        }
+        fflush(stdout);
+        usleep(intervalMs * 1000);
+    }
+}
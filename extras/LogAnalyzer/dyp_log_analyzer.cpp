@@ -0,0 +1,352 @@
+/*!
+ * @file dyp_log_analyzer.cpp
+ *
+ * @brief Host-side analyzer for DYP-R01CW binary sample logs
+ *
+ * Memory-maps one or more sample logs (see DYP_R01CW_Log.h), splits the record
+ * area into blocks at record boundaries and decodes the blocks in parallel.
+ * Prints per-sensor statistics and error rates, and optionally writes a CSV
+ * extract of the (filtered) samples.
+ *
+ * The time span of a sensor is the sum of the steps between its consecutive
+ * timestamps in record order, added up per log: millis() rollovers are
+ * unwrapped, and steps backwards (device restarts) are not counted.
+ *
+ * Usage:
+ *   dyp_log_analyzer [-j threads] [-a addr] [-f from_ms] [-t to_ms] [-c out.csv] log...
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -pthread -I../../src dyp_log_analyzer.cpp ../../src/DYP_R01CW_Log.cpp -o dyp_log_analyzer
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DYP_R01CW_Log.h"
+
+// Records per CSV formatting block and thread
+#define CSV_BLOCK_RECORDS (1u << 20)
+
+/*!
+ * @brief Accumulated statistics of one sensor
+ */
+struct SensorStats {
+    uint64_t count = 0;           ///< Total number of records
+    uint64_t status[4] = {};      ///< Number of records per status code
+    uint64_t other = 0;           ///< Records with unknown status code
+    uint32_t min = UINT16_MAX;    ///< Minimum valid raw distance
+    uint32_t max = 0;             ///< Maximum valid raw distance
+    uint64_t sum = 0;             ///< Sum of valid raw distances
+    double sumSq = 0;             ///< Sum of squared valid raw distances
+    uint32_t first = 0;           ///< Timestamp of the first record
+    uint32_t last = 0;            ///< Timestamp of the last record
+    uint64_t span = 0;            ///< Time span in milliseconds
+
+    /*!
+     * @brief Time between two consecutive timestamps
+     * @return Forward step, also across a millis() rollover; 0 for a step backwards (restart)
+     */
+    static uint64_t step(uint32_t from, uint32_t to) {
+        uint32_t d = to - from;
+        return (d < 0x80000000u) ? d : 0;
+    }
+
+    /*!
+     * @brief Add a record's timestamp (records in file order)
+     */
+    void addTime(uint32_t timestamp) {
+        if (count == 0) {
+            first = timestamp;
+        } else {
+            span += step(last, timestamp);
+        }
+        last = timestamp;
+    }
+
+    /*!
+     * @brief Merge the statistics of another range
+     * @param o Statistics of the range
+     * @param contiguous true if the range directly follows this one in the same log
+     */
+    void merge(const SensorStats &o, bool contiguous) {
+        if (o.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            first = o.first;
+        } else if (contiguous) {
+            span += step(last, o.first);
+        }
+        span += o.span;
+        last = o.last;
+        count += o.count;
+        for (int i = 0; i < 4; i++) {
+            status[i] += o.status[i];
+        }
+        other += o.other;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+        sum += o.sum;
+        sumSq += o.sumSq;
+    }
+};
+
+/*!
+ * @brief Sample filter given on the command line
+ */
+struct Filter {
+    int addr = -1;            ///< 8-bit address or -1 for all sensors
+    uint32_t from = 0;        ///< Earliest timestamp in milliseconds
+    uint32_t to = UINT32_MAX; ///< Latest timestamp in milliseconds
+
+    bool match(const DYP_R01CW_Sample &s) const {
+        return (addr < 0 || s.addr == addr) && s.timestamp >= from && s.timestamp <= to;
+    }
+};
+
+/*!
+ * @brief Memory-mapped log file
+ */
+struct MappedLog {
+    const uint8_t *base = nullptr;
+    size_t size = 0;
+    const uint8_t *records = nullptr;
+    size_t count = 0;
+};
+
+static bool mapLog(const char *path, MappedLog &log) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < DYP_R01CW_LOG_HEADER_SIZE) {
+        fprintf(stderr, "%s: not a DYP-R01CW log\n", path);
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    // The advice values are not flags and cannot be combined; both are hints
+    // only, so a failure costs read-ahead but not correctness
+    if (madvise(p, st.st_size, MADV_SEQUENTIAL) != 0) {
+        fprintf(stderr, "%s: madvise(MADV_SEQUENTIAL): %s\n", path, strerror(errno));
+    }
+    if (madvise(p, st.st_size, MADV_WILLNEED) != 0) {
+        fprintf(stderr, "%s: madvise(MADV_WILLNEED): %s\n", path, strerror(errno));
+    }
+
+    log.base = static_cast<const uint8_t *>(p);
+    log.size = st.st_size;
+    if (!DYP_R01CW_Log::checkHeader(log.base)) {
+        fprintf(stderr, "%s: bad header\n", path);
+        munmap(p, st.st_size);
+        return false;
+    }
+    log.records = log.base + DYP_R01CW_LOG_HEADER_SIZE;
+    log.count = (log.size - DYP_R01CW_LOG_HEADER_SIZE) / DYP_R01CW_LOG_RECORD_SIZE;
+    if ((log.size - DYP_R01CW_LOG_HEADER_SIZE) % DYP_R01CW_LOG_RECORD_SIZE != 0) {
+        fprintf(stderr, "%s: ignoring truncated last record\n", path);
+    }
+    return true;
+}
+
+/*!
+ * @brief Decode a range of records and accumulate per-sensor statistics
+ */
+static void analyzeRange(const uint8_t *records, size_t begin, size_t end, const Filter &filter,
+                         SensorStats *stats) {
+    DYP_R01CW_Sample s;
+    for (size_t i = begin; i < end; i++) {
+        DYP_R01CW_Log::decode(records + i * DYP_R01CW_LOG_RECORD_SIZE, s);
+        if (!filter.match(s)) {
+            continue;
+        }
+        SensorStats &st = stats[s.addr];
+        st.addTime(s.timestamp);
+        st.count++;
+        if (s.status < 4) {
+            st.status[s.status]++;
+        } else {
+            st.other++;
+        }
+        if (s.status == DYP_R01CW_STATUS_OK) {
+            st.min = std::min<uint32_t>(st.min, s.raw);
+            st.max = std::max<uint32_t>(st.max, s.raw);
+            st.sum += s.raw;
+            st.sumSq += (double)s.raw * s.raw;
+        }
+    }
+}
+
+/*!
+ * @brief Format a range of records as CSV lines
+ */
+static void formatRange(const uint8_t *records, size_t begin, size_t end, const Filter &filter,
+                        std::string &out) {
+    static const char *statusNames[] = {"ok", "bus_error", "short_read", "invalid"};
+    DYP_R01CW_Sample s;
+    char line[64];
+    out.clear();
+    for (size_t i = begin; i < end; i++) {
+        DYP_R01CW_Log::decode(records + i * DYP_R01CW_LOG_RECORD_SIZE, s);
+        if (!filter.match(s)) {
+            continue;
+        }
+        int n = snprintf(line, sizeof(line), "%" PRIu32 ",0x%02X,%u,%s\n", s.timestamp, s.addr, s.raw,
+                         s.status < 4 ? statusNames[s.status] : "unknown");
+        out.append(line, n);
+    }
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Usage: dyp_log_analyzer [-j threads] [-a addr] [-f from_ms] [-t to_ms] [-c out.csv] log...\n");
+}
+
+int main(int argc, char **argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    Filter filter;
+    const char *csvPath = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:a:f:t:c:h")) != -1) {
+        switch (opt) {
+        case 'j':
+            threads = std::max(1, atoi(optarg));
+            break;
+        case 'a':
+            filter.addr = (int)strtol(optarg, nullptr, 0) & 0xFF;
+            break;
+        case 'f':
+            filter.from = strtoul(optarg, nullptr, 0);
+            break;
+        case 't':
+            filter.to = strtoul(optarg, nullptr, 0);
+            break;
+        case 'c':
+            csvPath = optarg;
+            break;
+        default:
+            usage();
+            return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+
+    FILE *csv = nullptr;
+    if (csvPath != nullptr) {
+        csv = fopen(csvPath, "w");
+        if (csv == nullptr) {
+            perror(csvPath);
+            return 1;
+        }
+        fputs("timestamp_ms,addr,raw,status\n", csv);
+    }
+
+    std::vector<SensorStats> total(256);
+    uint64_t totalRecords = 0;
+
+    for (int f = optind; f < argc; f++) {
+        MappedLog log;
+        if (!mapLog(argv[f], log)) {
+            return 1;
+        }
+        totalRecords += log.count;
+
+        // Statistics: one contiguous block per thread, private accumulators
+        std::vector<std::vector<SensorStats>> partial(threads, std::vector<SensorStats>(256));
+        std::vector<std::thread> workers;
+        size_t per = (log.count + threads - 1) / threads;
+        for (unsigned t = 0; t < threads; t++) {
+            size_t b = std::min(log.count, t * per);
+            size_t e = std::min(log.count, b + per);
+            workers.emplace_back(analyzeRange, log.records, b, e, std::cref(filter), partial[t].data());
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+        // Blocks in file order; logs are not contiguous with each other
+        std::vector<SensorStats> perLog(256);
+        for (unsigned t = 0; t < threads; t++) {
+            for (int a = 0; a < 256; a++) {
+                perLog[a].merge(partial[t][a], true);
+            }
+        }
+        for (int a = 0; a < 256; a++) {
+            total[a].merge(perLog[a], false);
+        }
+
+        // CSV: format blocks in parallel, write them in file order
+        if (csv != nullptr) {
+            std::vector<std::string> out(threads);
+            for (size_t base = 0; base < log.count; base += (size_t)threads * CSV_BLOCK_RECORDS) {
+                workers.clear();
+                for (unsigned t = 0; t < threads; t++) {
+                    size_t b = std::min(log.count, base + (size_t)t * CSV_BLOCK_RECORDS);
+                    size_t e = std::min(log.count, b + CSV_BLOCK_RECORDS);
+                    workers.emplace_back(formatRange, log.records, b, e, std::cref(filter), std::ref(out[t]));
+                }
+                for (unsigned t = 0; t < threads; t++) {
+                    workers[t].join();
+                    fwrite(out[t].data(), 1, out[t].size(), csv);
+                }
+            }
+        }
+
+        munmap(const_cast<uint8_t *>(log.base), log.size);
+    }
+
+    if (csv != nullptr) {
+        fclose(csv);
+    }
+
+    printf("%" PRIu64 " records\n\n", totalRecords);
+    printf("addr  %12s %8s %8s %8s %8s %9s %6s %6s %9s %9s %12s\n", "samples", "ok", "bus_err",
+           "short", "invalid", "err_rate", "min", "max", "mean", "stddev", "span_ms");
+    for (int a = 0; a < 256; a++) {
+        const SensorStats &s = total[a];
+        if (s.count == 0) {
+            continue;
+        }
+        uint64_t ok = s.status[DYP_R01CW_STATUS_OK];
+        double errRate = 100.0 * (double)(s.count - ok) / (double)s.count;
+        double mean = ok ? (double)s.sum / ok : 0.0;
+        double var = ok ? s.sumSq / ok - mean * mean : 0.0;
+        printf("0x%02X  %12" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8.3f%% %6u %6u %9.1f %9.2f %12" PRIu64 "\n",
+               a, s.count, ok, s.status[DYP_R01CW_STATUS_BUS_ERROR], s.status[DYP_R01CW_STATUS_SHORT_READ],
+               s.status[DYP_R01CW_STATUS_INVALID], errRate, ok ? s.min : 0, s.max, mean,
+               std::sqrt(std::max(0.0, var)), s.span);
+    }
+
+    return 0;
+}
@@ -0,0 +1,331 @@
+/*!
+ * @file dyp_replay.cpp
+ *
+ * @brief Offline replay of DYP-R01CW sample logs through the processing chain
+ *
+ * Feeds recorded samples (see DYP_R01CW_Log.h) through DYP_R01CW_Pipeline -
+ * the same offset, median, EMA and threshold code that runs on the device -
+ * on a virtual clock derived from the sample timestamps. Nothing waits for
+ * real time, so recordings are replayed as fast as they can be decoded.
+ *
+ * Each parameter accepts a comma-separated list; all combinations are
+ * replayed (one pipeline per sensor and combination), spread over all cores.
+ * Each log is replayed as a separate device run: the pipelines start with
+ * fresh filter and threshold state, as after a restart of the device.
+ *
+ * Usage:
+ *   dyp_replay [-j threads] [-a addr] [-o offsets] [-m medians] [-e ema_shifts]
+ *              [-T thresholds] [-H hysteresis] [-v] log...
+ *
+ *   -v prints every threshold event (virtual time, address, event, distance);
+ *      use it with a single parameter combination.
+ *
+ * Build (from this directory):
+ *   g++ -std=c++17 -O2 -pthread -I../../src dyp_replay.cpp ../../src/DYP_R01CW_Log.cpp \
+ *       ../../src/DYP_R01CW_Processing.cpp -o dyp_replay
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DYP_R01CW_Log.h"
+#include "DYP_R01CW_Processing.h"
+
+/*!
+ * @brief Virtual clock driven by 32-bit millisecond sample timestamps
+ *
+ * Extends the timestamps to 64 bit, so millis() rollover in long
+ * recordings does not move the clock backwards. Each log has its own time
+ * base (the device may have been restarted in between), so rebase() is
+ * called at the start of every log: its first sample continues at the
+ * current virtual time instead of being compared with the previous log.
+ */
+class VirtualClock {
+public:
+    void reset() {
+        _now = 0;
+        _last = 0;
+        _started = false;
+        _rebase = false;
+    }
+
+    void rebase() { _rebase = _started; }
+
+    uint64_t advance(uint32_t timestamp) {
+        if (!_started) {
+            _now = timestamp;
+            _started = true;
+        } else if (_rebase) {
+            _rebase = false;
+        } else {
+            _now += (uint32_t)(timestamp - _last);
+        }
+        _last = timestamp;
+        return _now;
+    }
+
+    uint64_t now() const { return _now; }
+
+private:
+    uint64_t _now = 0;
+    uint32_t _last = 0;
+    bool _started = false;
+    bool _rebase = false;
+};
+
+/*!
+ * @brief One parameter combination
+ */
+struct Config {
+    int16_t offset;
+    uint8_t median;
+    uint8_t emaShift;
+    int16_t threshold;
+    uint16_t hysteresis;
+};
+
+/*!
+ * @brief Replay result of one parameter combination
+ */
+struct Result {
+    uint64_t valid = 0;
+    uint64_t invalid = 0;
+    uint64_t enter = 0;
+    uint64_t leave = 0;
+    int64_t sum = 0;
+    uint64_t startMs = 0;
+    uint64_t endMs = 0;
+};
+
+struct Log {
+    const uint8_t *records;
+    size_t count;
+};
+
+static std::vector<long> parseList(const char *arg) {
+    std::vector<long> values;
+    std::string s(arg);
+    size_t pos = 0;
+    while (pos <= s.size()) {
+        size_t comma = s.find(',', pos);
+        if (comma == std::string::npos) {
+            comma = s.size();
+        }
+        values.push_back(strtol(s.substr(pos, comma - pos).c_str(), nullptr, 0));
+        pos = comma + 1;
+    }
+    return values;
+}
+
+static bool mapLog(const char *path, Log &log) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < DYP_R01CW_LOG_HEADER_SIZE) {
+        fprintf(stderr, "%s: not a DYP-R01CW log\n", path);
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    // Hint only: a failure costs read-ahead but not correctness
+    if (madvise(p, st.st_size, MADV_WILLNEED) != 0) {
+        fprintf(stderr, "%s: madvise(MADV_WILLNEED): %s\n", path, strerror(errno));
+    }
+    const uint8_t *base = static_cast<const uint8_t *>(p);
+    if (!DYP_R01CW_Log::checkHeader(base)) {
+        fprintf(stderr, "%s: bad header\n", path);
+        munmap(p, st.st_size);
+        return false;
+    }
+    log.records = base + DYP_R01CW_LOG_HEADER_SIZE;
+    log.count = (st.st_size - DYP_R01CW_LOG_HEADER_SIZE) / DYP_R01CW_LOG_RECORD_SIZE;
+    if ((st.st_size - DYP_R01CW_LOG_HEADER_SIZE) % DYP_R01CW_LOG_RECORD_SIZE != 0) {
+        fprintf(stderr, "%s: ignoring truncated last record\n", path);
+    }
+    return true;
+}
+
+static void replay(const std::vector<Log> &logs, const Config &cfg, int addrFilter, bool verbose,
+                   Result &res) {
+    static const char *eventNames[] = {"none", "enter", "leave"};
+    std::vector<DYP_R01CW_Pipeline> pipelines(256);
+    for (auto &p : pipelines) {
+        p.setDistanceOffset(cfg.offset);
+        p.setMedianWindow(cfg.median);
+        p.setEmaShift(cfg.emaShift);
+        p.setThreshold(cfg.threshold, cfg.hysteresis);
+    }
+
+    VirtualClock clock;
+    bool first = true;
+    DYP_R01CW_Sample s;
+    for (const Log &log : logs) {
+        // The device starts its filters fresh after a restart
+        clock.rebase();
+        for (auto &p : pipelines) {
+            p.reset();
+        }
+        for (size_t i = 0; i < log.count; i++) {
+            DYP_R01CW_Log::decode(log.records + i * DYP_R01CW_LOG_RECORD_SIZE, s);
+            uint64_t now = clock.advance(s.timestamp);
+            if (first) {
+                res.startMs = now;
+                first = false;
+            }
+            if (addrFilter >= 0 && s.addr != addrFilter) {
+                continue;
+            }
+            if (s.status != DYP_R01CW_STATUS_OK) {
+                res.invalid++;
+                continue;
+            }
+            int16_t distance = 0;
+            uint8_t event = pipelines[s.addr].process(s, distance);
+            res.valid++;
+            res.sum += distance;
+            if (event == DYP_R01CW_EVENT_ENTER) {
+                res.enter++;
+            } else if (event == DYP_R01CW_EVENT_LEAVE) {
+                res.leave++;
+            }
+            if (verbose && event != DYP_R01CW_EVENT_NONE) {
+                printf("%" PRIu64 ",0x%02X,%s,%d\n", now, s.addr, eventNames[event], distance);
+            }
+        }
+    }
+    res.endMs = clock.now();
+}
+
+static void usage() {
+    fprintf(stderr, "Usage: dyp_replay [-j threads] [-a addr] [-o offsets] [-m medians] [-e ema_shifts]\n"
+                    "                  [-T thresholds] [-H hysteresis] [-v] log...\n");
+}
+
+int main(int argc, char **argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    int addrFilter = -1;
+    bool verbose = false;
+    std::vector<long> offsets{0}, medians{1}, emaShifts{0}, thresholds{0}, hystereses{0};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:a:o:m:e:T:H:vh")) != -1) {
+        switch (opt) {
+        case 'j':
+            threads = std::max(1, atoi(optarg));
+            break;
+        case 'a':
+            addrFilter = (int)strtol(optarg, nullptr, 0) & 0xFF;
+            break;
+        case 'o':
+            offsets = parseList(optarg);
+            break;
+        case 'm':
+            medians = parseList(optarg);
+            break;
+        case 'e':
+            emaShifts = parseList(optarg);
+            break;
+        case 'T':
+            thresholds = parseList(optarg);
+            break;
+        case 'H':
+            hystereses = parseList(optarg);
+            break;
+        case 'v':
+            verbose = true;
+            break;
+        default:
+            usage();
+            return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+
+    std::vector<Log> logs;
+    for (int f = optind; f < argc; f++) {
+        Log log;
+        if (!mapLog(argv[f], log)) {
+            return 1;
+        }
+        logs.push_back(log);
+    }
+
+    std::vector<Config> configs;
+    for (long o : offsets)
+        for (long m : medians)
+            for (long e : emaShifts)
+                for (long t : thresholds)
+                    for (long h : hystereses)
+                        configs.push_back({(int16_t)o, (uint8_t)m, (uint8_t)e, (int16_t)t, (uint16_t)h});
+    if (verbose && configs.size() > 1) {
+        fprintf(stderr, "-v requires a single parameter combination\n");
+        return 2;
+    }
+
+    std::vector<Result> results(configs.size());
+    std::atomic<size_t> next{0};
+    auto wallStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < std::min<size_t>(threads, configs.size()); t++) {
+        workers.emplace_back([&]() {
+            size_t i;
+            while ((i = next++) < configs.size()) {
+                replay(logs, configs[i], addrFilter, verbose, results[i]);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    FILE *out = verbose ? stderr : stdout;
+    fprintf(out, "%7s %6s %5s %9s %10s %12s %12s %10s %10s %10s\n", "offset", "median", "ema",
+            "threshold", "hysteresis", "valid", "invalid", "enter", "leave", "mean");
+    uint64_t virtualMs = 0;
+    for (size_t i = 0; i < configs.size(); i++) {
+        const Config &c = configs[i];
+        const Result &r = results[i];
+        fprintf(out, "%7d %6u %5u %9d %10u %12" PRIu64 " %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10.1f\n",
+                c.offset, c.median, c.emaShift, c.threshold, c.hysteresis, r.valid, r.invalid, r.enter,
+                r.leave, r.valid ? (double)r.sum / r.valid : 0.0);
+        virtualMs += r.endMs - r.startMs;
+    }
+    fprintf(out, "\n%zu combination(s), %.1f h of recordings replayed in %.3f s (%.0fx real time)\n",
+            configs.size(), virtualMs / 3.6e6, wall, wall > 0 ? virtualMs / 1000.0 / wall : 0.0);
+
+    return 0;
+}
@@ -13,6 +13,8 @@
  */
 
 #include "DYP_R01CW.h"
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_WireBus.h"
 
 /*!
  * @brief Constructor
@@ -23,6 +25,16 @@ DYP_R01CW::DYP_R01CW(uint8_t addr) {
     _addr = addr >> 1;
     _wire = nullptr;
     _distanceOffset = 0;  // Default offset is 0
+#if DYP_R01CW_HAS_RETRIES
+    _retries = 0;
+#endif
+#if DYP_R01CW_HAS_ASYNC
+    _pending = false;
+    _triggerTime = 0;
+#endif
+#if DYP_R01CW_HAS_INSTRUMENTATION
+    resetStats();
+#endif
 }
 
 /*!
@@ -54,55 +66,158 @@ bool DYP_R01CW::begin(TwoWire *wire) {
  * @return Distance in millimeters, or -1 if read failed
  */
 int16_t DYP_R01CW::readDistance() {
-    if (_wire == nullptr) {
+    DYP_R01CW_Sample sample;
+    
+    if (!readSample(sample)) {
         return -1;
     }
     
-    // Send measurement command to command register
-    _wire->beginTransmission(_addr);
-    _wire->write(DYP_R01CW_COMMAND_REG);
-    _wire->write(DYP_R01CW_MEASURE_COMMAND);
-    uint8_t error = _wire->endTransmission();
+    // Apply offset and return distance in millimeters
+    int16_t distance = DYP_R01CW_applyOffset(sample.raw, _distanceOffset);
     
-    if (error != 0) {
-        return -1;
-    }
+    return distance;
+}
+
+/*!
+ * @brief Read a raw distance sample from the sensor
+ * @param sample Sample to fill with timestamp, raw value, address and status
+ * @return true if the sample is valid, false otherwise
+ */
+bool DYP_R01CW::readSample(DYP_R01CW_Sample &sample) {
+#if DYP_R01CW_HAS_INSTRUMENTATION
+    uint32_t startUs = micros();
+#endif
+    sample.addr = _addr << 1;
+    sample.raw = DYP_R01CW_RAW_INVALID;
+    sample.status = DYP_R01CW_STATUS_BUS_ERROR;
+    sample.timestamp = millis();
     
-    // Wait for measurement to complete (sensor requires ~50ms)
-    delay(50);
+    if (_wire == nullptr) {
+        return false;
+    }
     
-    // Set pointer to data register
-    _wire->beginTransmission(_addr);
-    _wire->write(DYP_R01CW_DATA_REG);
-    error = _wire->endTransmission();
+    bool valid = false;
     
-    if (error != 0) {
-        return -1;
+    // Send measurement command, then wait for measurement to complete (sensor requires ~50ms)
+    if (trigger() == 0) {
+#if DYP_R01CW_HAS_ASYNC
+        _triggerTime = millis();
+#endif
+        delay(DYP_R01CW_CONVERSION_TIME_MS);
+        valid = readResult(sample);
     }
     
-    // Request 2 bytes from data register
-    uint8_t bytesReceived = _wire->requestFrom(_addr, (uint8_t)2);
+#if DYP_R01CW_HAS_INSTRUMENTATION
+    _stats.lastUs = micros() - startUs;
+    if (_stats.lastUs > _stats.maxUs) {
+        _stats.maxUs = _stats.lastUs;
+    }
+#endif
+    count(sample);
     
-    if (bytesReceived != 2) {
-        return -1;
+    return valid;
+}
+
+/*!
+ * @brief Send the measurement command
+ * @return 0 on success, Wire error code otherwise
+ */
+uint8_t DYP_R01CW::trigger() {
+    DYP_R01CW_WireBus bus(*_wire);
+    uint8_t error;
+    uint8_t attempt = 0;
+    
+    for (;;) {
+        // Send measurement command to command register
+        error = DYP_R01CW_WireProtocol::command<DYP_R01CW_MeasureCommand>(bus, _addr);
+        
+#if DYP_R01CW_HAS_RETRIES
+        if (error != 0 && attempt < _retries) {
+            attempt++;
+#if DYP_R01CW_HAS_INSTRUMENTATION
+            _stats.retries++;
+#endif
+            continue;
+        }
+#endif
+        break;
     }
+    (void)attempt;
     
-    // Read high and low bytes
-    uint8_t highByte = _wire->read();
-    uint8_t lowByte = _wire->read();
+    return error;
+}
+
+/*!
+ * @brief Read the measurement result from the data register
+ * @param sample Sample to update with timestamp, raw value and status
+ * @return true if the sample is valid, false otherwise
+ */
+bool DYP_R01CW::readResult(DYP_R01CW_Sample &sample) {
+    DYP_R01CW_WireBus bus(*_wire);
+    uint8_t attempt = 0;
+    
+    for (;;) {
+        // Set pointer to data register
+        uint8_t error = DYP_R01CW_WireProtocol::select<DYP_R01CW_DataRegister>(bus, _addr);
+        sample.timestamp = millis();
+        
+        if (error != 0) {
+            sample.status = DYP_R01CW_STATUS_BUS_ERROR;
+        } else {
+            // Read 2 bytes from data register
+            sample.status = DYP_R01CW_WireProtocol::fetch<DYP_R01CW_DataRegister>(bus, _addr, sample.raw);
+        }
+        
+#if DYP_R01CW_HAS_RETRIES
+        if (sample.status != DYP_R01CW_STATUS_OK && attempt < _retries) {
+            attempt++;
+#if DYP_R01CW_HAS_INSTRUMENTATION
+            _stats.retries++;
+#endif
+            continue;
+        }
+#endif
+        break;
+    }
+    (void)attempt;
     
-    // Combine bytes to form distance value
-    uint16_t rawDistance = (highByte << 8) | lowByte;
+    if (sample.status != DYP_R01CW_STATUS_OK) {
+        return false;
+    }
     
     // Check for invalid data
-    if (rawDistance == 0xFFFF) {
-        return -1;
+    if (sample.raw == DYP_R01CW_RAW_INVALID) {
+        sample.status = DYP_R01CW_STATUS_INVALID;
+        return false;
     }
     
-    // Apply offset and return distance in millimeters
-    int16_t distance = rawDistance + _distanceOffset;
-    
-    return distance;
+    return true;
+}
+
+/*!
+ * @brief Update statistics with a finished sample
+ * @param sample Sample
+ */
+void DYP_R01CW::count(const DYP_R01CW_Sample &sample) {
+#if DYP_R01CW_HAS_INSTRUMENTATION
+    _stats.samples++;
+    switch (sample.status) {
+    case DYP_R01CW_STATUS_OK:
+        _stats.valid++;
+        break;
+    case DYP_R01CW_STATUS_SHORT_READ:
+        _stats.shortReads++;
+        break;
+    case DYP_R01CW_STATUS_INVALID:
+        _stats.invalid++;
+        break;
+    default:
+        _stats.busErrors++;
+        break;
+    }
+#else
+    (void)sample;
+#endif
 }
 
 /*!
@@ -114,8 +229,8 @@ bool DYP_R01CW::isConnected() {
         return false;
     }
     
-    _wire->beginTransmission(_addr);
-    uint8_t error = _wire->endTransmission();
+    DYP_R01CW_WireBus bus(*_wire);
+    uint8_t error = DYP_R01CW_WireProtocol::probe(bus, _addr);
     
     return (error == 0);
 }
@@ -129,29 +244,14 @@ uint16_t DYP_R01CW::readSoftwareVersion() {
         return 0;
     }
     
-    // Set pointer to version register
-    _wire->beginTransmission(_addr);
-    _wire->write(DYP_R01CW_VERSION_REG);
-    uint8_t error = _wire->endTransmission();
-    
-    if (error != 0) {
-        return 0;
-    }
-    
-    // Request 2 bytes from version register
-    uint8_t bytesReceived = _wire->requestFrom(_addr, (uint8_t)2);
+    // Read 2 bytes from version register
+    DYP_R01CW_WireBus bus(*_wire);
+    uint16_t version;
     
-    if (bytesReceived != 2) {
+    if (DYP_R01CW_WireProtocol::read<DYP_R01CW_VersionRegister>(bus, _addr, version) != DYP_R01CW_STATUS_OK) {
         return 0;
     }
     
-    // Read high and low bytes
-    uint8_t highByte = _wire->read();
-    uint8_t lowByte = _wire->read();
-    
-    // Combine bytes to form version number
-    uint16_t version = (highByte << 8) | lowByte;
-    
     return version;
 }
 
@@ -167,20 +267,13 @@ bool DYP_R01CW::setAddress(uint8_t newAddr) {
     
     // Validate the new address
     // Valid addresses are 0xD0, 0xD2, ..., 0xEE, 0xF8, 0xFA, 0xFC, 0xFE (20 addresses)
-    // These are even addresses from 0xD0 to 0xFE, excluding 0xF0-0xF6
-    if (newAddr < 0xD0 || newAddr > 0xFE || (newAddr & 0x01) != 0) {
-        return false;
-    }
-    // Exclude reserved addresses 0xF0, 0xF2, 0xF4, 0xF6
-    if (newAddr >= 0xF0 && newAddr <= 0xF6) {
+    if (!DYP_R01CW_isValidAddress(newAddr)) {
         return false;
     }
     
     // Write the new address to the slave address register
-    _wire->beginTransmission(_addr);
-    _wire->write(DYP_R01CW_SLAVE_ADDR_REG);
-    _wire->write(newAddr);
-    uint8_t error = _wire->endTransmission();
+    DYP_R01CW_WireBus bus(*_wire);
+    uint8_t error = DYP_R01CW_WireProtocol::write<DYP_R01CW_SlaveAddrRegister>(bus, _addr, newAddr);
     
     if (error != 0) {
         return false;
@@ -218,11 +311,82 @@ bool DYP_R01CW::restart() {
     }
     
     // Send restart command sequence to command register
-    _wire->beginTransmission(_addr);
-    _wire->write(DYP_R01CW_COMMAND_REG);
-    _wire->write(DYP_R01CW_RESTART_COMMAND_1);
-    _wire->write(DYP_R01CW_RESTART_COMMAND_2);
-    uint8_t error = _wire->endTransmission();
+    DYP_R01CW_WireBus bus(*_wire);
+    uint8_t error = DYP_R01CW_WireProtocol::command<DYP_R01CW_RestartCommand>(bus, _addr);
     
     return (error == 0);
 }
+
+#if DYP_R01CW_HAS_RETRIES
+/*!
+ * @brief Set the number of retries of failed bus transactions
+ * @param retries Number of retries (limited to DYP_R01CW_Config::maxRetries)
+ */
+void DYP_R01CW::setRetries(uint8_t retries) {
+    _retries = (retries > DYP_R01CW_Config::maxRetries) ? DYP_R01CW_Config::maxRetries : retries;
+}
+#endif
+
+#if DYP_R01CW_HAS_INSTRUMENTATION
+/*!
+ * @brief Reset call statistics
+ */
+void DYP_R01CW::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+#endif
+
+#if DYP_R01CW_HAS_ASYNC
+/*!
+ * @brief Start a measurement without waiting for the result
+ * @return true if the measurement command was sent successfully, false otherwise
+ */
+bool DYP_R01CW::startMeasurement() {
+    if (_wire == nullptr) {
+        return false;
+    }
+    
+    _pending = (trigger() == 0);
+    if (_pending) {
+        _triggerTime = millis();
+    }
+    
+    return _pending;
+}
+
+/*!
+ * @brief Check if the pending measurement is complete
+ * @return true if the conversion time has elapsed, false otherwise
+ */
+bool DYP_R01CW::isMeasurementReady() {
+    return _pending && (uint32_t)(millis() - _triggerTime) >= DYP_R01CW_CONVERSION_TIME_MS;
+}
+
+/*!
+ * @brief Read the result of the pending measurement
+ * @param sample Sample to fill with timestamp, raw value, address and status
+ * @return true if the sample is valid, false otherwise
+ */
+bool DYP_R01CW::readMeasurement(DYP_R01CW_Sample &sample) {
+    sample.addr = _addr << 1;
+    sample.raw = DYP_R01CW_RAW_INVALID;
+    sample.status = DYP_R01CW_STATUS_BUS_ERROR;
+    sample.timestamp = millis();
+    
+    if (_wire == nullptr || !_pending) {
+        return false;
+    }
+    
+    // Wait for the remaining conversion time
+    uint32_t elapsed = millis() - _triggerTime;
+    if (elapsed < DYP_R01CW_CONVERSION_TIME_MS) {
+        delay(DYP_R01CW_CONVERSION_TIME_MS - elapsed);
+    }
+    _pending = false;
+    
+    bool valid = readResult(sample);
+    count(sample);
+    
+    return valid;
+}
+#endif
@@ -22,21 +22,25 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "DYP_R01CW_Config.h"
+#include "DYP_R01CW_Registers.h"
+#include "DYP_R01CW_Sample.h"
 
-// Default I2C address for DYP-R01CW sensor (8-bit format)
-// Note: This is the library default; adjust if your sensor is configured differently
-#define DYP_R01CW_DEFAULT_ADDR 0xE8
-
-// Sensor registers
-#define DYP_R01CW_VERSION_REG 0x00
-#define DYP_R01CW_COMMAND_REG 0x10
-#define DYP_R01CW_DATA_REG 0x02
-#define DYP_R01CW_SLAVE_ADDR_REG 0x05
-
-// Commands
-#define DYP_R01CW_MEASURE_COMMAND 0xB0
-#define DYP_R01CW_RESTART_COMMAND_1 0x5A
-#define DYP_R01CW_RESTART_COMMAND_2 0xA5
+#if DYP_R01CW_HAS_INSTRUMENTATION
+/*!
+ * @brief Call statistics (DYP_R01CW_TIER_FULL)
+ */
+struct DYP_R01CW_Stats {
+    uint32_t samples;     ///< Samples read (readSample(), readDistance(), readMeasurement())
+    uint32_t valid;       ///< Valid samples
+    uint32_t busErrors;   ///< Samples failed with DYP_R01CW_STATUS_BUS_ERROR
+    uint32_t shortReads;  ///< Samples failed with DYP_R01CW_STATUS_SHORT_READ
+    uint32_t invalid;     ///< Samples failed with DYP_R01CW_STATUS_INVALID
+    uint32_t retries;     ///< Repeated bus transactions
+    uint32_t lastUs;      ///< Duration of the last blocking sample read in microseconds
+    uint32_t maxUs;       ///< Maximum duration of a blocking sample read in microseconds
+};
+#endif
 
 /*!
  * @brief DYP_R01CW class for interfacing with the laser ranging sensor
@@ -61,6 +65,14 @@ public:
      * @return Distance in millimeters, or -1 if read failed
      */
     int16_t readDistance();
+
+    /*!
+     * @brief Read a raw distance sample from the sensor
+     * @param sample Sample to fill with timestamp, raw value, address and status
+     * @return true if the sample is valid, false otherwise (see sample.status)
+     * @note The distance offset is not applied to sample.raw
+     */
+    bool readSample(DYP_R01CW_Sample &sample);
     
     /*!
      * @brief Check if sensor is connected and responding
@@ -107,10 +119,91 @@ public:
      */
     bool restart();
 
+#if DYP_R01CW_HAS_RETRIES
+    /*!
+     * @brief Set the number of retries of failed bus transactions
+     * @param retries Number of retries (0...DYP_R01CW_Config::maxRetries, default: 0)
+     * @note Retries the failed transaction only (trigger, register pointer or data read);
+     *       an invalid result (0xFFFF) is not retried
+     */
+    void setRetries(uint8_t retries);
+#endif
+
+#if DYP_R01CW_HAS_INSTRUMENTATION
+    /*!
+     * @brief Get call statistics
+     * @return Statistics since begin() or the last resetStats()
+     */
+    const DYP_R01CW_Stats &getStats() const { return _stats; }
+
+    /*!
+     * @brief Reset call statistics
+     */
+    void resetStats();
+#endif
+
+#if DYP_R01CW_HAS_ASYNC
+    /*!
+     * @brief Start a measurement without waiting for the result
+     * @return true if the measurement command was sent successfully, false otherwise
+     */
+    bool startMeasurement();
+
+    /*!
+     * @brief Check if the measurement started with startMeasurement() is complete
+     * @return true if the conversion time has elapsed, false otherwise or if no measurement is pending
+     */
+    bool isMeasurementReady();
+
+    /*!
+     * @brief Read the result of the measurement started with startMeasurement()
+     * @param sample Sample to fill with timestamp, raw value, address and status
+     * @return true if the sample is valid, false otherwise (see sample.status)
+     * @note Waits for the remaining conversion time if called before isMeasurementReady()
+     *       returns true; fails with DYP_R01CW_STATUS_BUS_ERROR if no measurement is pending
+     */
+    bool readMeasurement(DYP_R01CW_Sample &sample);
+
+    /*!
+     * @brief Get the time of the last successful measurement trigger
+     * @return millis() when the measurement command was sent (by startMeasurement() or readSample())
+     */
+    uint32_t getTriggerTime() const { return _triggerTime; }
+#endif
+
 private:
+    /*!
+     * @brief Send the measurement command
+     * @return 0 on success, Wire error code otherwise
+     */
+    uint8_t trigger();
+
+    /*!
+     * @brief Read the measurement result from the data register
+     * @param sample Sample to update with timestamp, raw value and status
+     * @return true if the sample is valid, false otherwise
+     */
+    bool readResult(DYP_R01CW_Sample &sample);
+
+    /*!
+     * @brief Update statistics with a finished sample
+     * @param sample Sample
+     */
+    void count(const DYP_R01CW_Sample &sample);
+
     uint8_t _addr;         ///< I2C address of the sensor
     TwoWire *_wire;        ///< Pointer to Wire object
     int16_t _distanceOffset; ///< Distance offset in millimeters
+#if DYP_R01CW_HAS_RETRIES
+    uint8_t _retries;      ///< Retries of failed bus transactions
+#endif
+#if DYP_R01CW_HAS_ASYNC
+    bool _pending;         ///< Measurement started, result not read yet
+    uint32_t _triggerTime; ///< millis() of the last trigger
+#endif
+#if DYP_R01CW_HAS_INSTRUMENTATION
+    DYP_R01CW_Stats _stats; ///< Call statistics
+#endif
 };
 
 #endif // DYP_R01CW_H
@@ -0,0 +1,175 @@
+/*!
+ * @file DYP_R01CW_Capture.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - pre-/post-trigger capture
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Capture<CAPACITY> records the samples of one sensor around an
+ * event, like the trigger of an oscilloscope. While armed, every sample is
+ * written to a ring buffer which is continuously overwritten. trigger()
+ * marks the most recent sample; after the configured number of post-trigger
+ * samples the buffer is frozen and holds one block:
+ *
+ *   [ CAPACITY - post - 1 pre-trigger samples | trigger sample | post samples ]
+ *
+ * The block is read in chronological order with sample() (e.g. to encode it
+ * with DYP_R01CW_Log for transfer) and released with rearm(). Samples added
+ * while the block is frozen are dropped and counted. Only the samples around
+ * events need to leave the device.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_CAPTURE_H
+#define DYP_R01CW_CAPTURE_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Sample.h"
+
+// Capture states
+#define DYP_R01CW_CAPTURE_ARMED 0      ///< Recording pre-trigger samples
+#define DYP_R01CW_CAPTURE_TRIGGERED 1  ///< Recording post-trigger samples
+#define DYP_R01CW_CAPTURE_READY 2      ///< Block complete and frozen
+
+/*!
+ * @brief Pre-/post-trigger capture buffer for one sensor
+ * @tparam CAPACITY Number of samples in a block (2...65535)
+ */
+template <uint16_t CAPACITY> class DYP_R01CW_Capture {
+    static_assert(CAPACITY >= 2, "DYP_R01CW_Capture: capacity must be at least 2");
+
+public:
+    static const uint16_t capacity = CAPACITY;  ///< Number of samples in a block
+
+    DYP_R01CW_Capture() {
+        _post = CAPACITY / 2;
+        _dropped = 0;
+        rearm();
+    }
+
+    /*!
+     * @brief Set the number of post-trigger samples
+     * @param post Samples recorded after the trigger sample (0...CAPACITY - 1, default CAPACITY / 2)
+     * @note Restarts recording
+     */
+    void setPostTrigger(uint16_t post) {
+        _post = (post > CAPACITY - 1) ? CAPACITY - 1 : post;
+        rearm();
+    }
+
+    /*!
+     * @brief Release the block and restart recording
+     * @note The pre-trigger ring starts empty, so a block never spans a gap
+     */
+    void rearm() {
+        _head = 0;
+        _count = 0;
+        _remaining = 0;
+        _state = DYP_R01CW_CAPTURE_ARMED;
+    }
+
+    /*!
+     * @brief Add a sample
+     * @param sample Sample (valid or not)
+     * @return true if this sample completed the block
+     */
+    bool add(const DYP_R01CW_Sample &sample) {
+        if (_state == DYP_R01CW_CAPTURE_READY) {
+            if (_dropped < 0xFFFF) {
+                _dropped++;
+            }
+            return false;
+        }
+        _buf[_head] = sample;
+        _head = (_head + 1 == CAPACITY) ? 0 : _head + 1;
+        if (_count < CAPACITY) {
+            _count++;
+        }
+        if (_state == DYP_R01CW_CAPTURE_TRIGGERED && --_remaining == 0) {
+            _state = DYP_R01CW_CAPTURE_READY;
+            return true;
+        }
+        return false;
+    }
+
+    /*!
+     * @brief Trigger the capture at the most recent sample
+     * @return true if triggered, false if not armed or no sample has been added yet
+     */
+    bool trigger() {
+        if (_state != DYP_R01CW_CAPTURE_ARMED || _count == 0) {
+            return false;
+        }
+        if (_post == 0) {
+            _state = DYP_R01CW_CAPTURE_READY;
+        } else {
+            _remaining = _post;
+            _state = DYP_R01CW_CAPTURE_TRIGGERED;
+        }
+        return true;
+    }
+
+    /*!
+     * @brief Get the capture state
+     * @return DYP_R01CW_CAPTURE_ARMED, DYP_R01CW_CAPTURE_TRIGGERED or DYP_R01CW_CAPTURE_READY
+     */
+    uint8_t state() const { return _state; }
+
+    /*!
+     * @brief Check if a block is complete
+     * @return true if the block is frozen and can be read
+     */
+    bool ready() const { return _state == DYP_R01CW_CAPTURE_READY; }
+
+    /*!
+     * @brief Get the number of samples in the block
+     * @return Number of samples (fewer than CAPACITY if triggered before the ring was full)
+     */
+    uint16_t size() const { return _count; }
+
+    /*!
+     * @brief Get the position of the trigger sample in the block
+     * @return Index of the trigger sample (valid while ready())
+     */
+    uint16_t triggerIndex() const { return _count - 1 - _post; }
+
+    /*!
+     * @brief Get a sample of the block in chronological order
+     * @param i Index (0: oldest, size() - 1: newest)
+     * @return Sample
+     */
+    const DYP_R01CW_Sample &sample(uint16_t i) const {
+        uint32_t pos = (uint32_t)_head + CAPACITY - _count + i;
+        return _buf[pos % CAPACITY];
+    }
+
+    /*!
+     * @brief Get the number of samples dropped while a block was frozen
+     * @return Dropped samples (saturates at 65535)
+     */
+    uint16_t dropped() const { return _dropped; }
+
+    /*!
+     * @brief Reset the dropped samples counter
+     */
+    void resetDropped() { _dropped = 0; }
+
+private:
+    DYP_R01CW_Sample _buf[CAPACITY];  ///< Ring buffer
+    uint16_t _head;                   ///< Next write position
+    uint16_t _count;                  ///< Samples in the ring
+    uint16_t _post;                   ///< Post-trigger samples
+    uint16_t _remaining;              ///< Post-trigger samples still to record
+    uint16_t _dropped;                ///< Samples dropped while frozen
+    uint8_t _state;                   ///< Capture state
+};
+
+#endif // DYP_R01CW_CAPTURE_H
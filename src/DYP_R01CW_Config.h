@@ -0,0 +1,78 @@
+/*!
+ * @file DYP_R01CW_Config.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - feature tiers
+ *
+ * @section intro_sec Introduction
+ *
+ * The library is built in one of three feature tiers, selected by defining
+ * DYP_R01CW_TIER for all translation units (e.g. PlatformIO build_flags
+ * -DDYP_R01CW_TIER=0, or arduino-cli --build-property
+ * "compiler.cpp.extra_flags=-DDYP_R01CW_TIER=0"):
+ *
+ * | Tier                      | Instrumentation | Retries | Filters | Async |
+ * |---------------------------|-----------------|---------|---------|-------|
+ * | DYP_R01CW_TIER_MINIMAL    | -               | -       | -       | -     |
+ * | DYP_R01CW_TIER_STANDARD   | -               | x       | x       | -     |
+ * | DYP_R01CW_TIER_FULL       | x               | x       | x       | x     |
+ *
+ * - Instrumentation: DYP_R01CW::getStats() / resetStats()
+ * - Retries: DYP_R01CW::setRetries()
+ * - Filters: DYP_R01CW_Pipeline and its stages (DYP_R01CW_Processing.h)
+ * - Async: DYP_R01CW::startMeasurement() / isMeasurementReady() / readMeasurement()
+ *
+ * The default is DYP_R01CW_TIER_STANDARD, so the sensor objects carry no
+ * statistics or async state unless a sketch opts in to DYP_R01CW_TIER_FULL.
+ *
+ * Features of other tiers are not declared, so using them fails at compile
+ * time; the headers of the processing stages built on the filters
+ * (DYP_R01CW_FilterBank.h, DYP_R01CW_Counter.h and DYP_R01CW_Edge.h) stop
+ * with an #error naming the required tier.
+ * DYP_R01CW_Config exposes the selection as constexpr values.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_CONFIG_H
+#define DYP_R01CW_CONFIG_H
+
+#include <stdint.h>
+
+// Feature tiers
+#define DYP_R01CW_TIER_MINIMAL 0   ///< Blocking API only
+#define DYP_R01CW_TIER_STANDARD 1  ///< Adds retries and filters
+#define DYP_R01CW_TIER_FULL 2      ///< Adds instrumentation and async API
+
+#ifndef DYP_R01CW_TIER
+#define DYP_R01CW_TIER DYP_R01CW_TIER_STANDARD
+#endif
+
+#if DYP_R01CW_TIER < DYP_R01CW_TIER_MINIMAL || DYP_R01CW_TIER > DYP_R01CW_TIER_FULL
+#error "DYP_R01CW_TIER must be DYP_R01CW_TIER_MINIMAL (0), DYP_R01CW_TIER_STANDARD (1) or DYP_R01CW_TIER_FULL (2)"
+#endif
+
+// Feature switches for declarations (use DYP_R01CW_Config in code)
+#define DYP_R01CW_HAS_INSTRUMENTATION (DYP_R01CW_TIER >= DYP_R01CW_TIER_FULL)
+#define DYP_R01CW_HAS_RETRIES (DYP_R01CW_TIER >= DYP_R01CW_TIER_STANDARD)
+#define DYP_R01CW_HAS_FILTERS (DYP_R01CW_TIER >= DYP_R01CW_TIER_STANDARD)
+#define DYP_R01CW_HAS_ASYNC (DYP_R01CW_TIER >= DYP_R01CW_TIER_FULL)
+
+/*!
+ * @brief Compile-time feature configuration
+ */
+struct DYP_R01CW_Config {
+    static constexpr uint8_t tier = DYP_R01CW_TIER;                            ///< Selected tier
+    static constexpr bool instrumentation = DYP_R01CW_HAS_INSTRUMENTATION;    ///< Call statistics
+    static constexpr bool retries = DYP_R01CW_HAS_RETRIES;                    ///< Transaction retries
+    static constexpr bool filters = DYP_R01CW_HAS_FILTERS;                    ///< Processing stages
+    static constexpr bool async = DYP_R01CW_HAS_ASYNC;                        ///< Non-blocking measurement API
+    static constexpr uint8_t maxRetries = DYP_R01CW_HAS_RETRIES ? 3 : 0;      ///< Upper limit for setRetries()
+};
+
+#endif // DYP_R01CW_CONFIG_H
@@ -0,0 +1,192 @@
+/*!
+ * @file DYP_R01CW_Counter.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - bidirectional counter
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Config.h"
+
+#if DYP_R01CW_HAS_FILTERS
+
+#include "DYP_R01CW_Counter.h"
+
+#include "DYP_R01CW_Registers.h"
+
+/*!
+ * @brief Constructor (detectors disabled, timeout 10 s)
+ */
+DYP_R01CW_Counter::DYP_R01CW_Counter() {
+    _timeout = 10000;
+    _period = 2 * DYP_R01CW_CONVERSION_TIME_MS;
+    _lastDirection = DYP_R01CW_DIRECTION_NONE;
+    _transit = 0;
+    reset();
+    resetCounts();
+}
+
+/*!
+ * @brief Configure the detectors of both sensors
+ * @param threshold Distance in millimeters below which a sensor is interrupted
+ * @param hysteresis Distance above threshold required to clear the sensor
+ */
+void DYP_R01CW_Counter::begin(int16_t threshold, uint16_t hysteresis) {
+    setThreshold(DYP_R01CW_COUNTER_A, threshold, hysteresis);
+    setThreshold(DYP_R01CW_COUNTER_B, threshold, hysteresis);
+}
+
+/*!
+ * @brief Configure the detector of one sensor
+ * @param channel Sensor channel
+ * @param threshold Distance in millimeters below which the sensor is interrupted
+ * @param hysteresis Distance above threshold required to clear the sensor
+ */
+void DYP_R01CW_Counter::setThreshold(uint8_t channel, int16_t threshold, uint16_t hysteresis) {
+    if (channel > DYP_R01CW_COUNTER_B) {
+        return;
+    }
+    _detector[channel].begin(threshold, hysteresis);
+    _first = DYP_R01CW_COUNTER_NONE;
+    _both = false;
+}
+
+/*!
+ * @brief Set the sample period of each sensor
+ * @param period Period in milliseconds
+ */
+void DYP_R01CW_Counter::setPeriod(uint16_t period) {
+    _period = (period < 2) ? 2 : period;
+    _nextChannel = DYP_R01CW_COUNTER_NONE;
+}
+
+/*!
+ * @brief Get the sensor to be triggered now
+ * @param now Current time in milliseconds
+ * @return Sensor channel or DYP_R01CW_COUNTER_NONE
+ */
+uint8_t DYP_R01CW_Counter::next(uint32_t now) {
+    if (_nextChannel == DYP_R01CW_COUNTER_NONE) {
+        _due = now;
+        _nextChannel = DYP_R01CW_COUNTER_A;
+    }
+    if ((int32_t)(now - _due) < 0) {
+        return DYP_R01CW_COUNTER_NONE;
+    }
+
+    uint8_t channel = _nextChannel;
+    uint16_t step = (channel == DYP_R01CW_COUNTER_A) ? _period / 2 : _period - _period / 2;
+    _due += step;
+    if ((int32_t)(now - _due) >= 0) {
+        // Fallen behind: restart the schedule instead of triggering in a burst
+        _due = now + step;
+    }
+    _nextChannel = channel ^ 1;
+    return channel;
+}
+
+/*!
+ * @brief Clear the detector and passage state
+ */
+void DYP_R01CW_Counter::reset() {
+    _detector[DYP_R01CW_COUNTER_A].reset();
+    _detector[DYP_R01CW_COUNTER_B].reset();
+    _first = DYP_R01CW_COUNTER_NONE;
+    _both = false;
+    _firstTime = 0;
+    _secondTime = 0;
+    _due = 0;
+    _nextChannel = DYP_R01CW_COUNTER_NONE;
+}
+
+/*!
+ * @brief Clear the counts
+ */
+void DYP_R01CW_Counter::resetCounts() {
+    _count[0] = 0;
+    _count[1] = 0;
+    _discarded = 0;
+}
+
+/*!
+ * @brief End the current passage
+ * @param counted true if the passage was counted
+ */
+void DYP_R01CW_Counter::endPassage(bool counted) {
+    if (!counted && _discarded < 0xFFFF) {
+        _discarded++;
+    }
+    _first = DYP_R01CW_COUNTER_NONE;
+    _both = false;
+}
+
+/*!
+ * @brief Process a distance of one sensor
+ * @param channel Sensor channel
+ * @param distance Distance in millimeters
+ * @param time Time of the distance in milliseconds
+ * @return Direction of a completed passage
+ */
+uint8_t DYP_R01CW_Counter::update(uint8_t channel, int16_t distance, uint32_t time) {
+    if (channel > DYP_R01CW_COUNTER_B) {
+        return DYP_R01CW_DIRECTION_NONE;
+    }
+    if (_first != DYP_R01CW_COUNTER_NONE && _timeout != 0 && time - _firstTime > _timeout) {
+        endPassage(false);
+    }
+
+    uint8_t event = _detector[channel].update(distance);
+    if (event == DYP_R01CW_EVENT_ENTER) {
+        if (_first != DYP_R01CW_COUNTER_NONE && channel == _first && !_both) {
+            // The previous object cleared the first sensor without reaching the second one
+            endPassage(false);
+        }
+        if (_first == DYP_R01CW_COUNTER_NONE) {
+            _first = channel;
+            _firstTime = time;
+            _both = false;
+        } else if (channel != _first && !_both) {
+            _both = true;
+            _secondTime = time;
+        }
+    } else if (event == DYP_R01CW_EVENT_LEAVE && _first != DYP_R01CW_COUNTER_NONE &&
+               !_detector[DYP_R01CW_COUNTER_A].isBelow() && !_detector[DYP_R01CW_COUNTER_B].isBelow()) {
+        // Both sensors clear: counted if the second sensor was the last one interrupted.
+        // If the second sensor has not been interrupted yet, the object may be shorter
+        // than the sensor spacing: keep the passage open (until the timeout).
+        if (!_both) {
+            return DYP_R01CW_DIRECTION_NONE;
+        }
+        if (channel != _first) {
+            uint8_t direction = (_first == DYP_R01CW_COUNTER_A) ? DYP_R01CW_DIRECTION_AB : DYP_R01CW_DIRECTION_BA;
+            _count[direction - 1]++;
+            _lastDirection = direction;
+            _transit = _secondTime - _firstTime;
+            endPassage(true);
+            return direction;
+        }
+        endPassage(false);
+    }
+
+    return DYP_R01CW_DIRECTION_NONE;
+}
+
+/*!
+ * @brief Get the number of passages
+ * @param direction Passage direction
+ * @return Number of passages in this direction
+ */
+uint32_t DYP_R01CW_Counter::count(uint8_t direction) const {
+    if (direction == DYP_R01CW_DIRECTION_AB || direction == DYP_R01CW_DIRECTION_BA) {
+        return _count[direction - 1];
+    }
+    return 0;
+}
+
+#endif // DYP_R01CW_HAS_FILTERS
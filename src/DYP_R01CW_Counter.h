@@ -0,0 +1,183 @@
+/*!
+ * @file DYP_R01CW_Counter.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - bidirectional counter
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Counter counts objects passing two sensors A and B mounted one
+ * after the other along a passage (e.g. a door or a conveyor). Each sensor
+ * has a threshold detector with hysteresis; a passage is counted when the
+ * object has interrupted both sensors and the second sensor is the last one
+ * to be cleared:
+ *
+ *   A blocked, B blocked, A clear, B clear -> A to B
+ *   B blocked, A blocked, B clear, A clear -> B to A
+ *
+ * Objects shorter than the sensor spacing clear the first sensor before
+ * they reach the second one; the passage stays open until then:
+ *
+ *   A blocked, A clear, B blocked, B clear -> A to B
+ *
+ * Passages which turn back or exceed the timeout are discarded; so is an
+ * open passage when the first sensor is interrupted again before the second
+ * one. The transit
+ * time is the time between the interruptions of the first and the second
+ * sensor; with the sensor spacing it gives the speed of the object.
+ *
+ * The temporal resolution is limited by the sample period. next() schedules
+ * the measurements of both sensors phase-aligned, half a period apart, so
+ * that the interleaved sample streams resolve the sequence of interruptions
+ * at twice the rate of each sensor.
+ * The counter requires DYP_R01CW_TIER_STANDARD or higher.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_COUNTER_H
+#define DYP_R01CW_COUNTER_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Config.h"
+#include "DYP_R01CW_Processing.h"
+
+#if !DYP_R01CW_HAS_FILTERS
+#error "DYP_R01CW_Counter requires DYP_R01CW_TIER_STANDARD or higher (-DDYP_R01CW_TIER=1)"
+#endif
+
+// Sensor channels
+#define DYP_R01CW_COUNTER_A 0       ///< First sensor
+#define DYP_R01CW_COUNTER_B 1       ///< Second sensor
+#define DYP_R01CW_COUNTER_NONE 0xFF ///< No sensor
+
+// Passage directions
+#define DYP_R01CW_DIRECTION_NONE 0  ///< No passage
+#define DYP_R01CW_DIRECTION_AB 1    ///< Passage from sensor A to sensor B
+#define DYP_R01CW_DIRECTION_BA 2    ///< Passage from sensor B to sensor A
+
+/*!
+ * @brief Bidirectional object counter with two sensors
+ */
+class DYP_R01CW_Counter {
+public:
+    DYP_R01CW_Counter();
+
+    /*!
+     * @brief Configure the detectors of both sensors
+     * @param threshold Distance in millimeters below which a sensor is interrupted
+     * @param hysteresis Distance above threshold required to clear the sensor
+     */
+    void begin(int16_t threshold, uint16_t hysteresis);
+
+    /*!
+     * @brief Configure the detector of one sensor
+     * @param channel DYP_R01CW_COUNTER_A or DYP_R01CW_COUNTER_B
+     * @param threshold Distance in millimeters below which the sensor is interrupted
+     * @param hysteresis Distance above threshold required to clear the sensor
+     */
+    void setThreshold(uint8_t channel, int16_t threshold, uint16_t hysteresis);
+
+    /*!
+     * @brief Set the passage timeout
+     * @param timeout Maximum time from the first interruption to the end of a passage in milliseconds
+     *                (0: none, default 10000)
+     */
+    void setTimeout(uint32_t timeout) { _timeout = timeout; }
+
+    /*!
+     * @brief Set the sample period of each sensor for next()
+     * @param period Period in milliseconds (default 2 * DYP_R01CW_CONVERSION_TIME_MS)
+     */
+    void setPeriod(uint16_t period);
+
+    /*!
+     * @brief Get the sensor to be triggered now
+     * @param now Current time in milliseconds
+     * @return DYP_R01CW_COUNTER_A, DYP_R01CW_COUNTER_B or DYP_R01CW_COUNTER_NONE if none is due
+     * @note The sensors alternate half a period apart; if the caller falls behind,
+     *       the schedule restarts from now instead of catching up in a burst
+     */
+    uint8_t next(uint32_t now);
+
+    /*!
+     * @brief Clear the detector and passage state (counts are kept)
+     */
+    void reset();
+
+    /*!
+     * @brief Clear the counts
+     */
+    void resetCounts();
+
+    /*!
+     * @brief Process a distance of one sensor
+     * @param channel DYP_R01CW_COUNTER_A or DYP_R01CW_COUNTER_B
+     * @param distance Distance in millimeters (valid samples only)
+     * @param time Time of the distance in milliseconds (e.g. middle between trigger and read)
+     * @return Direction of a completed passage (DYP_R01CW_DIRECTION_*)
+     * @note Distances of both sensors must be processed in time order
+     */
+    uint8_t update(uint8_t channel, int16_t distance, uint32_t time);
+
+    /*!
+     * @brief Get the number of passages
+     * @param direction DYP_R01CW_DIRECTION_AB or DYP_R01CW_DIRECTION_BA
+     * @return Number of passages in this direction
+     */
+    uint32_t count(uint8_t direction) const;
+
+    /*!
+     * @brief Get the number of discarded passages
+     * @return Passages which turned back or timed out (saturates at 65535)
+     */
+    uint16_t discarded() const { return _discarded; }
+
+    /*!
+     * @brief Get the direction of the last passage
+     * @return DYP_R01CW_DIRECTION_* (NONE if no passage has been counted)
+     */
+    uint8_t lastDirection() const { return _lastDirection; }
+
+    /*!
+     * @brief Get the transit time of the last passage
+     * @return Time between the interruptions of the first and the second sensor in milliseconds
+     */
+    uint32_t transitTime() const { return _transit; }
+
+    /*!
+     * @brief Check if a sensor is interrupted
+     * @param channel DYP_R01CW_COUNTER_A or DYP_R01CW_COUNTER_B
+     * @return true if interrupted
+     */
+    bool isBlocked(uint8_t channel) const { return channel <= DYP_R01CW_COUNTER_B && _detector[channel].isBelow(); }
+
+private:
+    /*!
+     * @brief End the current passage
+     * @param counted true if the passage was counted
+     */
+    void endPassage(bool counted);
+
+    DYP_R01CW_Threshold _detector[2]; ///< Interruption detectors
+    uint32_t _count[2];               ///< Passages A to B, B to A
+    uint32_t _timeout;                ///< Passage timeout in milliseconds
+    uint32_t _firstTime;              ///< Interruption time of the first sensor
+    uint32_t _secondTime;             ///< Interruption time of the second sensor
+    uint32_t _transit;                ///< Transit time of the last passage
+    uint32_t _due;                    ///< Time of the next trigger
+    uint16_t _period;                 ///< Sample period of each sensor
+    uint16_t _discarded;              ///< Discarded passages
+    uint8_t _first;                   ///< First interrupted sensor of the passage (NONE: idle)
+    uint8_t _nextChannel;             ///< Next sensor to trigger (NONE: not scheduled)
+    uint8_t _lastDirection;           ///< Direction of the last passage
+    bool _both;                       ///< Both sensors interrupted in this passage
+};
+
+#endif // DYP_R01CW_COUNTER_H
@@ -0,0 +1,114 @@
+/*!
+ * @file DYP_R01CW_Decimator.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - decimation
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Decimator.h"
+
+#include "DYP_R01CW_Processing.h"
+
+/*!
+ * @brief Constructor (factor 10, offset 0)
+ */
+DYP_R01CW_Decimator::DYP_R01CW_Decimator() {
+    _factor = 10;
+    _offset = 0;
+    _record.timestamp = 0;
+    _record.mean = 0;
+    _record.min = 0;
+    _record.max = 0;
+    _record.samples = 0;
+    _record.valid = 0;
+    reset();
+}
+
+/*!
+ * @brief Set the decimation factor
+ * @param factor Number of input samples per record
+ */
+void DYP_R01CW_Decimator::setFactor(uint16_t factor) {
+    _factor = (factor < 1) ? 1 : factor;
+    reset();
+}
+
+/*!
+ * @brief Discard the current window
+ */
+void DYP_R01CW_Decimator::reset() {
+    _sum = 0;
+    _first = 0;
+    _min = 32767;
+    _max = -32768;
+    _samples = 0;
+    _valid = 0;
+}
+
+/*!
+ * @brief Add a sample
+ * @param sample Raw sample
+ * @return true if a record is complete
+ */
+bool DYP_R01CW_Decimator::update(const DYP_R01CW_Sample &sample) {
+    if (_samples == 0) {
+        _first = sample.timestamp;
+    }
+    _samples++;
+    if (sample.status == DYP_R01CW_STATUS_OK) {
+        int16_t d = DYP_R01CW_applyOffset(sample.raw, _offset);
+        _sum += d;
+        if (d < _min) {
+            _min = d;
+        }
+        if (d > _max) {
+            _max = d;
+        }
+        _valid++;
+    }
+    if (_samples < _factor) {
+        return false;
+    }
+    emit();
+    return true;
+}
+
+/*!
+ * @brief Complete a partial window
+ * @return true if a record is complete
+ */
+bool DYP_R01CW_Decimator::flush() {
+    if (_samples == 0) {
+        return false;
+    }
+    emit();
+    return true;
+}
+
+/*!
+ * @brief Close the current window into the record
+ */
+void DYP_R01CW_Decimator::emit() {
+    _record.timestamp = _first;
+    _record.samples = _samples;
+    _record.valid = _valid;
+    if (_valid == 0) {
+        _record.mean = 0;
+        _record.min = 0;
+        _record.max = 0;
+    } else {
+        // Rounded to the nearest millimeter
+        int32_t half = _valid / 2;
+        _record.mean = (int16_t)((_sum + ((_sum < 0) ? -half : half)) / (int32_t)_valid);
+        _record.min = _min;
+        _record.max = _max;
+    }
+    reset();
+}
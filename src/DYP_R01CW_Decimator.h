@@ -0,0 +1,105 @@
+/*!
+ * @file DYP_R01CW_Decimator.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - decimation
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Decimator reduces the sample rate of one sensor by a factor N.
+ * Every N input samples (valid or not) produce one aggregate record with
+ * the mean (boxcar average, i.e. a first-order CIC filter), the minimum and
+ * the maximum of the valid distances and their count. Unlike keeping every
+ * Nth sample, short events remain visible in the minimum and maximum, and
+ * the mean suppresses aliasing. Each input takes constant time.
+ * The decimation stage is available in every tier.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_DECIMATOR_H
+#define DYP_R01CW_DECIMATOR_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Sample.h"
+
+/*!
+ * @brief Aggregate of N samples
+ */
+struct DYP_R01CW_Aggregate {
+    uint32_t timestamp;  ///< Time of the first sample in milliseconds
+    int16_t mean;        ///< Mean distance in millimeters (rounded)
+    int16_t min;         ///< Minimum distance in millimeters
+    int16_t max;         ///< Maximum distance in millimeters
+    uint16_t samples;    ///< Number of samples
+    uint16_t valid;      ///< Number of valid samples (mean, min and max are 0 if none)
+};
+
+/*!
+ * @brief Decimation with mean, minimum, maximum and valid count
+ */
+class DYP_R01CW_Decimator {
+public:
+    DYP_R01CW_Decimator();
+
+    /*!
+     * @brief Set the decimation factor
+     * @param factor Number of input samples per record (1...65535, default 10)
+     * @note Discards the current window
+     */
+    void setFactor(uint16_t factor);
+
+    /*!
+     * @brief Set the distance offset
+     * @param offset Offset in millimeters
+     */
+    void setDistanceOffset(int16_t offset) { _offset = offset; }
+
+    /*!
+     * @brief Discard the current window
+     */
+    void reset();
+
+    /*!
+     * @brief Add a sample
+     * @param sample Raw sample (invalid samples count towards the factor only)
+     * @return true if a record is complete (see record())
+     */
+    bool update(const DYP_R01CW_Sample &sample);
+
+    /*!
+     * @brief Complete a partial window
+     * @return true if the window contained samples and a record is complete
+     */
+    bool flush();
+
+    /*!
+     * @brief Get the last complete record
+     * @return Record
+     */
+    const DYP_R01CW_Aggregate &record() const { return _record; }
+
+private:
+    /*!
+     * @brief Close the current window into the record
+     */
+    void emit();
+
+    DYP_R01CW_Aggregate _record; ///< Last complete record
+    int32_t _sum;                ///< Sum of the valid distances
+    uint32_t _first;             ///< Time of the first sample
+    int16_t _min;                ///< Minimum valid distance
+    int16_t _max;                ///< Maximum valid distance
+    int16_t _offset;             ///< Distance offset in millimeters
+    uint16_t _factor;            ///< Decimation factor
+    uint16_t _samples;           ///< Samples in the window
+    uint16_t _valid;             ///< Valid samples in the window
+};
+
+#endif // DYP_R01CW_DECIMATOR_H
@@ -0,0 +1,133 @@
+/*!
+ * @file DYP_R01CW_Edge.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - edge timing
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Config.h"
+
+#if DYP_R01CW_HAS_FILTERS
+
+#include "DYP_R01CW_Edge.h"
+
+/*!
+ * @brief Integer square root
+ * @param x Value
+ * @return floor(sqrt(x))
+ */
+static uint32_t isqrt(uint64_t x) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/*!
+ * @brief Limit an uncertainty term
+ * @param x Term (Q8)
+ * @return Term limited to 2^31 - 1
+ */
+static uint64_t cap(uint64_t x) {
+    return (x > 2147483647UL) ? 2147483647UL : x;
+}
+
+/*!
+ * @brief Constructor (detector disabled, noise 5 mm, no jitter)
+ */
+DYP_R01CW_Edge::DYP_R01CW_Edge() {
+    _noise = 5;
+    _jitter = 0;
+    begin(0, 0);
+}
+
+/*!
+ * @brief Configure the threshold
+ * @param threshold Arrival level in millimeters
+ * @param hysteresis Departure level above threshold in millimeters
+ */
+void DYP_R01CW_Edge::begin(int16_t threshold, uint16_t hysteresis) {
+    _threshold = threshold;
+    _hysteresis = hysteresis;
+    _detector.begin(threshold, hysteresis);
+    reset();
+}
+
+/*!
+ * @brief Clear the sample history and the detector state
+ */
+void DYP_R01CW_Edge::reset() {
+    _detector.reset();
+    _d0 = 0;
+    _t0 = 0;
+    _time = 0;
+    _uncertainty = 0;
+    _edge = DYP_R01CW_EVENT_NONE;
+    _primed = false;
+}
+
+/*!
+ * @brief Process a distance
+ * @param distance Distance in millimeters
+ * @param triggerTime Time of the measurement trigger
+ * @param readTime Time of the result read
+ * @return DYP_R01CW_EVENT_NONE, DYP_R01CW_EVENT_ENTER or DYP_R01CW_EVENT_LEAVE
+ */
+uint8_t DYP_R01CW_Edge::update(int16_t distance, uint32_t triggerTime, uint32_t readTime) {
+    // Date the distance to the middle of its conversion
+    uint32_t t1 = triggerTime + (uint32_t)(readTime - triggerTime) / 2;
+
+    uint8_t event = _detector.update(distance);
+    if (event != DYP_R01CW_EVENT_NONE && _primed) {
+        int32_t level = (event == DYP_R01CW_EVENT_ENTER) ? _threshold : (int32_t)_threshold + _hysteresis;
+        // Distances from the crossing level (p, q >= 0, p + q > 0)
+        uint32_t p = (uint32_t)((event == DYP_R01CW_EVENT_ENTER) ? _d0 - level : level - _d0);
+        uint32_t q = (uint32_t)((event == DYP_R01CW_EVENT_ENTER) ? level - distance : distance - level);
+        uint32_t delta = p + q;
+        uint32_t dt = t1 - _t0;
+
+        // Interpolated crossing and its position in the interval (Q16)
+        _time = _t0 + (uint32_t)(((uint64_t)dt * p + delta / 2) / delta);
+        uint32_t f = (uint32_t)(((uint64_t)p << 16) / delta);
+
+        // Uncertainty terms in Q8, capped so that the squares cannot overflow
+        // Distance noise of both samples through the interpolation:
+        // u_d = dt * noise * sqrt(p^2 + q^2) / delta^2
+        uint64_t ud = ((uint64_t)dt * _noise << 8) / delta;
+        if (ud > (uint64_t)dt << 8) {
+            ud = (uint64_t)dt << 8;
+        }
+        ud = cap(ud * isqrt((uint64_t)p * p + (uint64_t)q * q) / delta);
+        // Jitter of the sample times: sigma * sqrt((1 - f)^2 + f^2)
+        uint64_t ua = cap(((uint64_t)(65536 - f) * _jitter) >> 8);
+        uint64_t ub = cap(((uint64_t)f * _jitter) >> 8);
+        uint64_t u = (isqrt(ud * ud + ua * ua + ub * ub) + 255) >> 8;
+        _uncertainty = (u > dt / 2) ? dt / 2 : (uint32_t)u;
+        _edge = event;
+    }
+
+    _d0 = distance;
+    _t0 = t1;
+    _primed = true;
+    return event;
+}
+
+#endif // DYP_R01CW_HAS_FILTERS
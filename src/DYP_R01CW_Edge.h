@@ -0,0 +1,126 @@
+/*!
+ * @file DYP_R01CW_Edge.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - edge timing
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Edge times the crossings of a distance threshold more precisely
+ * than the sample period. Each distance is dated to the middle of its
+ * conversion (between the trigger and the read); when two consecutive
+ * samples lie on different sides of the threshold, the crossing time is
+ * interpolated linearly between them:
+ *
+ *   t = t0 + (t1 - t0) * (d0 - threshold) / (d0 - d1)
+ *
+ * Each crossing is reported with a 1-sigma uncertainty, combining the
+ * distance noise propagated through the interpolation and the jitter of the
+ * sample times. The interpolation assumes that
+ * the distance changes gradually between the samples (e.g. an edge moving
+ * through the laser spot); the uncertainty is limited to half the sample
+ * interval.
+ *
+ * Times can be in any unit (e.g. millis() or micros()); crossing times and
+ * uncertainties are reported in the same unit. No additional bus traffic
+ * is needed. The edge timing stage requires DYP_R01CW_TIER_STANDARD or higher.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_EDGE_H
+#define DYP_R01CW_EDGE_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Config.h"
+#include "DYP_R01CW_Processing.h"
+
+#if !DYP_R01CW_HAS_FILTERS
+#error "DYP_R01CW_Edge requires DYP_R01CW_TIER_STANDARD or higher (-DDYP_R01CW_TIER=1)"
+#endif
+
+/*!
+ * @brief Threshold-crossing time interpolation for one sensor
+ */
+class DYP_R01CW_Edge {
+public:
+    DYP_R01CW_Edge();
+
+    /*!
+     * @brief Configure the threshold
+     * @param threshold Distance in millimeters below which DYP_R01CW_EVENT_ENTER is reported
+     * @param hysteresis Distance above threshold required for DYP_R01CW_EVENT_LEAVE
+     * @note Arrivals are timed at the threshold, departures at threshold + hysteresis;
+     *       a threshold of 0 disables the detector
+     */
+    void begin(int16_t threshold, uint16_t hysteresis);
+
+    /*!
+     * @brief Set the distance noise used for the uncertainty
+     * @param noise Standard deviation of the distance in millimeters (default 5)
+     */
+    void setNoise(uint16_t noise) { _noise = noise; }
+
+    /*!
+     * @brief Set the sample time jitter used for the uncertainty
+     * @param jitter Standard deviation of the sample times (unit of the sample times, default 0)
+     * @note E.g. the scatter of the measurement instant within the conversion; a constant
+     *       delay does not affect time differences and should not be included
+     */
+    void setJitter(uint32_t jitter) { _jitter = jitter; }
+
+    /*!
+     * @brief Clear the sample history and the detector state
+     */
+    void reset();
+
+    /*!
+     * @brief Process a distance
+     * @param distance Distance in millimeters (valid samples only)
+     * @param triggerTime Time of the measurement trigger (e.g. DYP_R01CW::getTriggerTime())
+     * @param readTime Time of the result read (e.g. DYP_R01CW_Sample::timestamp)
+     * @return DYP_R01CW_EVENT_NONE, DYP_R01CW_EVENT_ENTER or DYP_R01CW_EVENT_LEAVE
+     *         (the crossing is available with time() and uncertainty())
+     * @note No crossing time is interpolated for an event on the first sample after reset()
+     */
+    uint8_t update(int16_t distance, uint32_t triggerTime, uint32_t readTime);
+
+    /*!
+     * @brief Get the time of the last crossing
+     * @return Interpolated crossing time (unit of the sample times)
+     */
+    uint32_t time() const { return _time; }
+
+    /*!
+     * @brief Get the uncertainty of the last crossing
+     * @return 1-sigma uncertainty of time() (unit of the sample times)
+     */
+    uint32_t uncertainty() const { return _uncertainty; }
+
+    /*!
+     * @brief Get the type of the last crossing
+     * @return DYP_R01CW_EVENT_ENTER, DYP_R01CW_EVENT_LEAVE or DYP_R01CW_EVENT_NONE if none
+     */
+    uint8_t edge() const { return _edge; }
+
+private:
+    DYP_R01CW_Threshold _detector; ///< Crossing detector
+    int16_t _threshold;            ///< Arrival level in millimeters
+    uint16_t _hysteresis;          ///< Departure level above threshold in millimeters
+    uint16_t _noise;               ///< Distance noise in millimeters
+    int16_t _d0;                   ///< Previous distance
+    uint32_t _t0;                  ///< Previous sample time
+    uint32_t _jitter;              ///< Sample time jitter
+    uint32_t _time;                ///< Last crossing time
+    uint32_t _uncertainty;         ///< Last crossing uncertainty
+    uint8_t _edge;                 ///< Last crossing type
+    bool _primed;                  ///< Previous sample available
+};
+
+#endif // DYP_R01CW_EDGE_H
@@ -0,0 +1,280 @@
+/*!
+ * @file DYP_R01CW_FilterBank.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - multi-channel filter bank
+ *
+ * The filter step is written once (processVector()) over a small set of
+ * vector operations; each instruction set provides these operations on
+ * 32-bit lanes. Channels which do not fill a vector are processed by
+ * processLane(), which implements the same arithmetic on scalars. Both use
+ * the median network and the EMA step of DYP_R01CW_Processing.h.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Config.h"
+
+#if DYP_R01CW_HAS_FILTERS
+
+#include "DYP_R01CW_FilterBank.h"
+
+#if !defined(DYP_R01CW_FILTERBANK_SCALAR)
+#if defined(__AVX2__)
+#define DYP_R01CW_FILTERBANK_AVX2
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#define DYP_R01CW_FILTERBANK_SSE41
+#include <smmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DYP_R01CW_FILTERBANK_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace {
+
+/*!
+ * @brief Filter one channel (reference implementation)
+ * @return true if the value is valid
+ */
+bool processLane(const DYP_R01CW_FilterBankLanes &s, uint8_t i, uint8_t window, uint8_t shift, uint16_t raw,
+                 int16_t &distance) {
+    if (raw == DYP_R01CW_RAW_INVALID) {
+        distance = s.out[i];
+        return false;
+    }
+
+    // Offset (int16_t arithmetic as DYP_R01CW_applyOffset()), calibration with rounding and saturation
+    int32_t v = DYP_R01CW_applyOffset(raw, s.offset[i]);
+    v = (v * s.gain[i] + 2048) >> 12;
+    v = DYP_R01CW_min<int32_t>(DYP_R01CW_max<int32_t>(v, -32768), 32767);
+
+    // Median history: shift in the new value, or fill it with the first value
+    int32_t h[DYP_R01CW_MEDIAN_MAX];
+    for (uint8_t k = 0; k + 1 < window; k++) {
+        h[k] = s.primed[i] ? s.hist[k + 1][i] : v;
+    }
+    h[window - 1] = v;
+    for (uint8_t k = 0; k < window; k++) {
+        s.hist[k][i] = (int16_t)h[k];
+    }
+    int32_t m = DYP_R01CW_median<int32_t, DYP_R01CW_min<int32_t>, DYP_R01CW_max<int32_t> >(h, window);
+
+    // EMA, starting from the first value
+    s.acc[i] = DYP_R01CW_emaStep(s.acc[i], m, shift, s.primed[i] != 0);
+    s.primed[i] = -1;
+    s.out[i] = (int16_t)(s.acc[i] >> shift);
+    distance = s.out[i];
+
+    return true;
+}
+
+#if defined(DYP_R01CW_FILTERBANK_AVX2)
+// AVX2: 8 lanes
+struct Ops {
+    typedef __m256i V;
+    static const uint8_t lanes = 8;
+    static V load(const int32_t *p) { return _mm256_loadu_si256((const __m256i *)p); }
+    static void store(int32_t *p, V x) { _mm256_storeu_si256((__m256i *)p, x); }
+    static V loadRaw(const uint16_t *p) { return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p)); }
+    static V load16(const int16_t *p) { return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)p)); }
+    static void store16(int16_t *p, V x) {
+        // Values are in int16_t range, saturation does not change them
+        V packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(x, x), 0x08);
+        _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(packed));
+    }
+    static V set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm256_mullo_epi32(a, b); }
+    static V sra12(V x) { return _mm256_srai_epi32(x, 12); }
+    static V sext16(V x) { return _mm256_srai_epi32(_mm256_slli_epi32(x, 16), 16); }
+    static V sra(V x, uint8_t n) { return _mm256_sra_epi32(x, _mm_cvtsi32_si128(n)); }
+    static V sll(V x, uint8_t n) { return _mm256_sll_epi32(x, _mm_cvtsi32_si128(n)); }
+    static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    static V max(V a, V b) { return _mm256_max_epi32(a, b); }
+    static V cmpeq(V a, V b) { return _mm256_cmpeq_epi32(a, b); }
+    static V select(V mask, V t, V f) { return _mm256_blendv_epi8(f, t, mask); }
+    static int32_t sum(V x) {
+        int32_t a[8];
+        store(a, x);
+        return a[0] + a[1] + a[2] + a[3] + a[4] + a[5] + a[6] + a[7];
+    }
+};
+#elif defined(DYP_R01CW_FILTERBANK_SSE41)
+// SSE4.1: 4 lanes
+struct Ops {
+    typedef __m128i V;
+    static const uint8_t lanes = 4;
+    static V load(const int32_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+    static void store(int32_t *p, V x) { _mm_storeu_si128((__m128i *)p, x); }
+    static V loadRaw(const uint16_t *p) { return _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)p)); }
+    static V load16(const int16_t *p) { return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)p)); }
+    static void store16(int16_t *p, V x) {
+        // Values are in int16_t range, saturation does not change them
+        _mm_storel_epi64((__m128i *)p, _mm_packs_epi32(x, x));
+    }
+    static V set1(int32_t x) { return _mm_set1_epi32(x); }
+    static V add(V a, V b) { return _mm_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+    static V mul(V a, V b) { return _mm_mullo_epi32(a, b); }
+    static V sra12(V x) { return _mm_srai_epi32(x, 12); }
+    static V sext16(V x) { return _mm_srai_epi32(_mm_slli_epi32(x, 16), 16); }
+    static V sra(V x, uint8_t n) { return _mm_sra_epi32(x, _mm_cvtsi32_si128(n)); }
+    static V sll(V x, uint8_t n) { return _mm_sll_epi32(x, _mm_cvtsi32_si128(n)); }
+    static V min(V a, V b) { return _mm_min_epi32(a, b); }
+    static V max(V a, V b) { return _mm_max_epi32(a, b); }
+    static V cmpeq(V a, V b) { return _mm_cmpeq_epi32(a, b); }
+    static V select(V mask, V t, V f) { return _mm_blendv_epi8(f, t, mask); }
+    static int32_t sum(V x) {
+        int32_t a[4];
+        store(a, x);
+        return a[0] + a[1] + a[2] + a[3];
+    }
+};
+#elif defined(DYP_R01CW_FILTERBANK_NEON)
+// NEON: 4 lanes
+struct Ops {
+    typedef int32x4_t V;
+    static const uint8_t lanes = 4;
+    static V load(const int32_t *p) { return vld1q_s32(p); }
+    static void store(int32_t *p, V x) { vst1q_s32(p, x); }
+    static V loadRaw(const uint16_t *p) { return vreinterpretq_s32_u32(vmovl_u16(vld1_u16(p))); }
+    static V load16(const int16_t *p) { return vmovl_s16(vld1_s16(p)); }
+    static void store16(int16_t *p, V x) { vst1_s16(p, vmovn_s32(x)); }
+    static V set1(int32_t x) { return vdupq_n_s32(x); }
+    static V add(V a, V b) { return vaddq_s32(a, b); }
+    static V sub(V a, V b) { return vsubq_s32(a, b); }
+    static V mul(V a, V b) { return vmulq_s32(a, b); }
+    static V sra12(V x) { return vshrq_n_s32(x, 12); }
+    static V sext16(V x) { return vshrq_n_s32(vshlq_n_s32(x, 16), 16); }
+    static V sra(V x, uint8_t n) { return vshlq_s32(x, vdupq_n_s32(-(int32_t)n)); }
+    static V sll(V x, uint8_t n) { return vshlq_s32(x, vdupq_n_s32(n)); }
+    static V min(V a, V b) { return vminq_s32(a, b); }
+    static V max(V a, V b) { return vmaxq_s32(a, b); }
+    static V cmpeq(V a, V b) { return vreinterpretq_s32_u32(vceqq_s32(a, b)); }
+    static V select(V mask, V t, V f) { return vbslq_s32(vreinterpretq_u32_s32(mask), t, f); }
+    static int32_t sum(V x) {
+        return vgetq_lane_s32(x, 0) + vgetq_lane_s32(x, 1) + vgetq_lane_s32(x, 2) + vgetq_lane_s32(x, 3);
+    }
+};
+#endif
+
+#if defined(DYP_R01CW_FILTERBANK_AVX2) || defined(DYP_R01CW_FILTERBANK_SSE41) || defined(DYP_R01CW_FILTERBANK_NEON)
+#define DYP_R01CW_FILTERBANK_VECTOR
+
+inline Ops::V vmin(Ops::V a, Ops::V b) {
+    return Ops::min(a, b);
+}
+
+inline Ops::V vmax(Ops::V a, Ops::V b) {
+    return Ops::max(a, b);
+}
+
+/*!
+ * @brief Filter the channels [0, n - n % lanes) in vectors (same arithmetic as processLane())
+ * @return Number of valid values
+ */
+uint8_t processVector(const DYP_R01CW_FilterBankLanes &s, uint8_t n, uint8_t window, uint8_t shift, const uint16_t *raw,
+                      int16_t *distance) {
+    typedef Ops::V V;
+    const V invalidRaw = Ops::set1(DYP_R01CW_RAW_INVALID);
+    const V half = Ops::set1(2048);
+    const V lo = Ops::set1(-32768);
+    const V hi = Ops::set1(32767);
+    const V ones = Ops::set1(-1);
+    V invalidCount = Ops::set1(0);
+    uint8_t i = 0;
+
+    for (; (uint8_t)(i + Ops::lanes) <= n; i += Ops::lanes) {
+        V invalid = Ops::cmpeq(Ops::loadRaw(raw + i), invalidRaw);
+        invalidCount = Ops::sub(invalidCount, invalid);
+
+        // Offset, calibration
+        V v = Ops::sext16(Ops::add(Ops::loadRaw(raw + i), Ops::load16(s.offset + i)));
+        v = Ops::sra12(Ops::add(Ops::mul(v, Ops::load16(s.gain + i)), half));
+        v = Ops::min(Ops::max(v, lo), hi);
+
+        // Median history
+        V primed = Ops::load16(s.primed + i);
+        V h[DYP_R01CW_MEDIAN_MAX];
+        for (uint8_t k = 0; k + 1 < window; k++) {
+            h[k] = Ops::select(primed, Ops::load16(s.hist[k + 1] + i), v);
+        }
+        h[window - 1] = v;
+        V m = DYP_R01CW_median<V, vmin, vmax>(h, window);
+
+        // EMA (DYP_R01CW_emaStep())
+        V acc = Ops::load(s.acc + i);
+        V accNew = Ops::select(primed, Ops::add(acc, Ops::sub(m, Ops::sra(acc, shift))), Ops::sll(m, shift));
+
+        // Commit valid lanes only
+        for (uint8_t k = 0; k < window; k++) {
+            Ops::store16(s.hist[k] + i, Ops::select(invalid, Ops::load16(s.hist[k] + i), h[k]));
+        }
+        Ops::store(s.acc + i, Ops::select(invalid, acc, accNew));
+        Ops::store16(s.primed + i, Ops::select(invalid, primed, ones));
+        V out = Ops::select(invalid, Ops::load16(s.out + i), Ops::sra(accNew, shift));
+        Ops::store16(s.out + i, out);
+        Ops::store16(distance + i, out);
+    }
+
+    return (uint8_t)(i - Ops::sum(invalidCount));
+}
+#endif
+
+} // namespace
+
+/*!
+ * @brief Filter a frame
+ * @param s Channel state
+ * @param channels Number of channels
+ * @param window Median window size
+ * @param shift EMA smoothing shift
+ * @param raw Raw DATA_REG values, one per channel
+ * @param distance Filtered distances in millimeters, one per channel
+ * @param vector true: SIMD lanes, false: scalar reference implementation
+ * @return Number of valid values in the frame
+ */
+uint8_t DYP_R01CW_filterBankProcess(const DYP_R01CW_FilterBankLanes &s, uint8_t channels, uint8_t window,
+                                    uint8_t shift, const uint16_t *raw, int16_t *distance, bool vector) {
+    uint8_t valid = 0;
+    uint8_t i = 0;
+#ifdef DYP_R01CW_FILTERBANK_VECTOR
+    if (vector) {
+        valid = processVector(s, channels, window, shift, raw, distance);
+        i = channels - channels % Ops::lanes;
+    }
+#else
+    (void)vector;
+#endif
+    for (; i < channels; i++) {
+        valid += processLane(s, i, window, shift, raw[i], distance[i]);
+    }
+
+    return valid;
+}
+
+/*!
+ * @brief Get the filter bank implementation selected at compile time
+ * @return Name of the instruction set
+ */
+const char *DYP_R01CW_filterBankIsa() {
+#if defined(DYP_R01CW_FILTERBANK_AVX2)
+    return "avx2";
+#elif defined(DYP_R01CW_FILTERBANK_SSE41)
+    return "sse4.1";
+#elif defined(DYP_R01CW_FILTERBANK_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+#endif // DYP_R01CW_HAS_FILTERS
@@ -0,0 +1,242 @@
+/*!
+ * @file DYP_R01CW_FilterBank.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - multi-channel filter bank
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_FilterBank<CHANNELS> filters a frame of raw DATA_REG values of
+ * many sensors (channels) in one call:
+ *
+ *   offset -> calibration (Q12 gain) -> median -> EMA
+ *
+ * The channel state is kept as a structure of arrays sized by the template
+ * parameter and the channels are processed in SIMD lanes: AVX2 (8 lanes),
+ * SSE4.1 or NEON (4 lanes), selected at compile time, with a portable scalar
+ * implementation for microcontrollers (or if DYP_R01CW_FILTERBANK_SCALAR is
+ * defined). All implementations are integer-only, use the median and EMA
+ * arithmetic of DYP_R01CW_Processing.h and produce bit-identical results.
+ *
+ * Invalid values (DYP_R01CW_RAW_INVALID) are masked: the channel's filter
+ * state is not changed and its previous distance is output again.
+ * The median history of a channel is filled with its first valid value.
+ * The filter bank requires DYP_R01CW_TIER_STANDARD or higher.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_FILTERBANK_H
+#define DYP_R01CW_FILTERBANK_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Config.h"
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_Sample.h"
+
+#if !DYP_R01CW_HAS_FILTERS
+#error "DYP_R01CW_FilterBank requires DYP_R01CW_TIER_STANDARD or higher (-DDYP_R01CW_TIER=1)"
+#endif
+
+// Calibration gain 1.0 (Q12 fixed-point)
+#define DYP_R01CW_GAIN_ONE 4096
+
+/*!
+ * @brief Channel state arrays of a filter bank (one element per channel)
+ */
+struct DYP_R01CW_FilterBankLanes {
+    int16_t *offset;                      ///< Offsets in millimeters
+    int16_t *gain;                        ///< Gains (Q12)
+    int16_t *hist[DYP_R01CW_MEDIAN_MAX];  ///< Median histories, oldest first
+    int32_t *acc;                         ///< EMA accumulators (value scaled by 2^shift)
+    int16_t *primed;                      ///< -1 if the channel had a valid value, 0 otherwise
+    int16_t *out;                         ///< Last distances
+};
+
+/*!
+ * @brief Filter a frame (capacity-independent part of DYP_R01CW_FilterBank)
+ * @param s Channel state
+ * @param channels Number of channels
+ * @param window Median window size (odd)
+ * @param shift EMA smoothing shift
+ * @param raw Raw DATA_REG values, one per channel
+ * @param distance Filtered distances in millimeters, one per channel
+ * @param vector true: SIMD lanes selected at compile time (remaining channels scalar),
+ *               false: scalar reference implementation for all channels
+ * @return Number of valid values in the frame
+ */
+uint8_t DYP_R01CW_filterBankProcess(const DYP_R01CW_FilterBankLanes &s, uint8_t channels, uint8_t window,
+                                    uint8_t shift, const uint16_t *raw, int16_t *distance, bool vector);
+
+/*!
+ * @brief Get the filter bank implementation selected at compile time
+ * @return "avx2", "sse4.1", "neon" or "scalar"
+ */
+const char *DYP_R01CW_filterBankIsa();
+
+/*!
+ * @brief Multi-channel filter bank: offset, calibration, median and EMA
+ * @tparam CHANNELS Maximum number of channels
+ */
+template <uint8_t CHANNELS> class DYP_R01CW_FilterBank {
+    static_assert(CHANNELS > 0 && CHANNELS <= 127, "DYP_R01CW_FilterBank: capacity must be 1...127");
+
+public:
+    static const uint8_t capacity = CHANNELS;  ///< Maximum number of channels
+
+    DYP_R01CW_FilterBank() {
+        _channels = 0;
+        _window = 1;
+        _shift = 0;
+        reset();
+    }
+
+    /*!
+     * @brief Set the number of channels and clear the filter state
+     * @param channels Number of channels (1...CHANNELS)
+     * @return true if successful, false if channels is out of range
+     * @note Offsets are reset to 0 and gains to DYP_R01CW_GAIN_ONE
+     */
+    bool begin(uint8_t channels) {
+        if (channels == 0 || channels > CHANNELS) {
+            return false;
+        }
+        _channels = channels;
+        for (uint8_t i = 0; i < CHANNELS; i++) {
+            _offset[i] = 0;
+            _gain[i] = DYP_R01CW_GAIN_ONE;
+        }
+        reset();
+        return true;
+    }
+
+    /*!
+     * @brief Set a channel's distance offset
+     * @param channel Channel index
+     * @param offset Offset in millimeters (applied before calibration)
+     */
+    void setOffset(uint8_t channel, int16_t offset) {
+        if (channel < CHANNELS) {
+            _offset[channel] = offset;
+        }
+    }
+
+    /*!
+     * @brief Set a channel's calibration gain
+     * @param channel Channel index
+     * @param gain Gain in Q12 fixed-point (DYP_R01CW_GAIN_ONE = 1.0)
+     * @note The calibrated value is rounded to the nearest millimeter and
+     *       saturated to the int16_t range
+     */
+    void setGain(uint8_t channel, int16_t gain) {
+        if (channel < CHANNELS) {
+            _gain[channel] = gain;
+        }
+    }
+
+    /*!
+     * @brief Set the median window size of all channels (1 disables the filter)
+     * @param window Window size (1...DYP_R01CW_MEDIAN_MAX; even sizes are rounded up)
+     */
+    void setMedianWindow(uint8_t window) {
+        if (window < 1) {
+            window = 1;
+        }
+        if (window > DYP_R01CW_MEDIAN_MAX) {
+            window = DYP_R01CW_MEDIAN_MAX;
+        }
+        // Use odd window sizes only
+        _window = window | 0x01;
+        reset();
+    }
+
+    /*!
+     * @brief Set the EMA smoothing shift of all channels (0 disables the filter)
+     * @param shift Smoothing shift (max. 15)
+     */
+    void setEmaShift(uint8_t shift) {
+        _shift = (shift > 15) ? 15 : shift;
+        reset();
+    }
+
+    /*!
+     * @brief Clear the filter state of all channels
+     */
+    void reset() {
+        for (uint8_t i = 0; i < CHANNELS; i++) {
+            for (uint8_t k = 0; k < DYP_R01CW_MEDIAN_MAX; k++) {
+                _hist[k][i] = 0;
+            }
+            _acc[i] = 0;
+            _primed[i] = 0;
+            _out[i] = 0;
+        }
+    }
+
+    /*!
+     * @brief Filter a frame
+     * @param raw Raw DATA_REG values, one per channel
+     * @param distance Filtered distances in millimeters, one per channel
+     *        (previous distance, initially 0, for invalid values)
+     * @return Number of valid values in the frame
+     */
+    uint8_t process(const uint16_t *raw, int16_t *distance) {
+        return DYP_R01CW_filterBankProcess(lanes(), _channels, _window, _shift, raw, distance, true);
+    }
+
+    /*!
+     * @brief Filter a frame with the scalar reference implementation
+     * @param raw Raw DATA_REG values, one per channel
+     * @param distance Filtered distances in millimeters, one per channel
+     * @return Number of valid values in the frame
+     * @note Same results as process(); used to verify the SIMD implementations
+     */
+    uint8_t processScalar(const uint16_t *raw, int16_t *distance) {
+        return DYP_R01CW_filterBankProcess(lanes(), _channels, _window, _shift, raw, distance, false);
+    }
+
+    /*!
+     * @brief Get the number of channels
+     * @return Number of channels
+     */
+    uint8_t channels() const { return _channels; }
+
+    /*!
+     * @brief Get the implementation selected at compile time
+     * @return "avx2", "sse4.1", "neon" or "scalar"
+     */
+    static const char *isa() { return DYP_R01CW_filterBankIsa(); }
+
+private:
+    // Pointers to the channel state arrays
+    DYP_R01CW_FilterBankLanes lanes() {
+        DYP_R01CW_FilterBankLanes s;
+        s.offset = _offset;
+        s.gain = _gain;
+        for (uint8_t k = 0; k < DYP_R01CW_MEDIAN_MAX; k++) {
+            s.hist[k] = _hist[k];
+        }
+        s.acc = _acc;
+        s.primed = _primed;
+        s.out = _out;
+        return s;
+    }
+
+    int16_t _offset[CHANNELS];                      ///< Offsets in millimeters
+    int16_t _gain[CHANNELS];                        ///< Gains (Q12)
+    int16_t _hist[DYP_R01CW_MEDIAN_MAX][CHANNELS];  ///< Median histories, oldest first
+    int32_t _acc[CHANNELS];                         ///< EMA accumulators (value scaled by 2^shift)
+    int16_t _primed[CHANNELS];                      ///< -1 if the channel had a valid value, 0 otherwise
+    int16_t _out[CHANNELS];                         ///< Last distances
+    uint8_t _channels;                              ///< Number of channels
+    uint8_t _window;                                ///< Median window size (odd)
+    uint8_t _shift;                                 ///< EMA smoothing shift
+};
+
+#endif // DYP_R01CW_FILTERBANK_H
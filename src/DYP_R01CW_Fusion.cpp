@@ -0,0 +1,157 @@
+/*!
+ * @file DYP_R01CW_Fusion.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - redundant sensor fusion
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Fusion.h"
+
+/*!
+ * @brief Get the median of a small array
+ * @param v Values (sorted in place)
+ * @param n Number of values (at least 1)
+ * @return Median (mean of the middle values if n is even)
+ */
+static int16_t median(int16_t *v, uint8_t n) {
+    // Insertion sort, at most DYP_R01CW_FUSION_MAX values
+    for (uint8_t i = 1; i < n; i++) {
+        int16_t x = v[i];
+        uint8_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+    if (n & 1) {
+        return v[n / 2];
+    }
+    return (int16_t)(((int32_t)v[n / 2 - 1] + v[n / 2]) / 2);
+}
+
+/*!
+ * @brief Constructor (one sensor, median mode)
+ */
+DYP_R01CW_Fusion::DYP_R01CW_Fusion() {
+    _mode = DYP_R01CW_FUSION_MEDIAN;
+    _tolerance = 50;
+    begin(1);
+}
+
+/*!
+ * @brief Set the number of sensors and clear the state
+ * @param sensors Number of sensors
+ * @return true if successful, false if sensors is out of range
+ */
+bool DYP_R01CW_Fusion::begin(uint8_t sensors) {
+    if (sensors < 1 || sensors > DYP_R01CW_FUSION_MAX) {
+        return false;
+    }
+    _sensors = sensors;
+    _quorum = 1;
+    for (uint8_t i = 0; i < DYP_R01CW_FUSION_MAX; i++) {
+        _weight[i] = DYP_R01CW_FUSION_WEIGHT_ONE / 25;
+    }
+    reset();
+    return true;
+}
+
+/*!
+ * @brief Set the quorum
+ * @param quorum Minimum number of agreeing sensors
+ */
+void DYP_R01CW_Fusion::setQuorum(uint8_t quorum) {
+    if (quorum < 1) {
+        quorum = 1;
+    }
+    _quorum = (quorum > _sensors) ? _sensors : quorum;
+}
+
+/*!
+ * @brief Set a sensor's distance variance
+ * @param sensor Sensor index
+ * @param variance Variance in mm^2
+ */
+void DYP_R01CW_Fusion::setVariance(uint8_t sensor, uint16_t variance) {
+    if (sensor >= DYP_R01CW_FUSION_MAX) {
+        return;
+    }
+    _weight[sensor] = DYP_R01CW_FUSION_WEIGHT_ONE / ((variance < 1) ? 1 : variance);
+}
+
+/*!
+ * @brief Clear the output
+ */
+void DYP_R01CW_Fusion::reset() {
+    _distance = 0;
+    _used = 0;
+    _disagreeing = 0;
+}
+
+/*!
+ * @brief Fuse a frame
+ * @param distance Distances in millimeters
+ * @param valid Bit mask of valid distances
+ * @return true if the quorum of sensors agreed
+ */
+bool DYP_R01CW_Fusion::process(const int16_t *distance, uint8_t valid) {
+    int16_t v[DYP_R01CW_FUSION_MAX];
+    uint8_t n = 0;
+
+    _used = 0;
+    _disagreeing = 0;
+    for (uint8_t i = 0; i < _sensors; i++) {
+        if (valid & (1 << i)) {
+            v[n++] = distance[i];
+        }
+    }
+    if (n < _quorum || n == 0) {
+        return false;
+    }
+
+    // Agreement with the median of all valid sensors
+    int16_t med = median(v, n);
+    uint8_t agree = 0;
+    for (uint8_t i = 0; i < _sensors; i++) {
+        if (!(valid & (1 << i))) {
+            continue;
+        }
+        int32_t d = (int32_t)distance[i] - med;
+        if (d > (int32_t)_tolerance || d < -(int32_t)_tolerance) {
+            _disagreeing |= 1 << i;
+        } else {
+            _used |= 1 << i;
+            v[agree++] = distance[i];
+        }
+    }
+    if (agree < _quorum || agree == 0) {
+        _used = 0;
+        return false;
+    }
+
+    if (_mode == DYP_R01CW_FUSION_WEIGHTED) {
+        // At most 8 * 2^24 * 2^15: fits int64_t
+        int64_t sum = 0;
+        int64_t weights = 0;
+        for (uint8_t i = 0; i < _sensors; i++) {
+            if (_used & (1 << i)) {
+                sum += (int64_t)_weight[i] * distance[i];
+                weights += _weight[i];
+            }
+        }
+        // Rounded to the nearest millimeter
+        sum += (sum < 0) ? -(weights / 2) : weights / 2;
+        _distance = (int16_t)(sum / weights);
+    } else {
+        _distance = median(v, agree);
+    }
+    return true;
+}
@@ -0,0 +1,136 @@
+/*!
+ * @file DYP_R01CW_Fusion.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - redundant sensor fusion
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Fusion combines the time-aligned distances of a group of
+ * redundant sensors aimed at the same target into one distance. Each frame:
+ *
+ * - invalid sensors are ignored
+ * - sensors deviating from the median of the valid sensors by more than the
+ *   tolerance are marked as disagreeing and ignored as well
+ * - if at least the quorum of sensors agrees, the output is the median or
+ *   the inverse-variance weighted mean of the agreeing sensors
+ *
+ * Otherwise the previous output is kept and process() returns false. Each
+ * frame takes a fixed, small amount of work (at most
+ * DYP_R01CW_FUSION_MAX sensors). The fusion stage is available in every
+ * tier.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_FUSION_H
+#define DYP_R01CW_FUSION_H
+
+#include <stdint.h>
+
+// Maximum number of sensors in a group (bits of a uint8_t mask)
+#define DYP_R01CW_FUSION_MAX 8
+
+// Weight of variance 1 mm^2 (inverse variances in fixed-point)
+#define DYP_R01CW_FUSION_WEIGHT_ONE (1UL << 24)
+
+// Fusion modes
+#define DYP_R01CW_FUSION_MEDIAN 0    ///< Median of the agreeing sensors
+#define DYP_R01CW_FUSION_WEIGHTED 1  ///< Inverse-variance weighted mean of the agreeing sensors
+
+/*!
+ * @brief Redundant sensor fusion
+ */
+class DYP_R01CW_Fusion {
+public:
+    DYP_R01CW_Fusion();
+
+    /*!
+     * @brief Set the number of sensors and clear the state
+     * @param sensors Number of sensors (1...DYP_R01CW_FUSION_MAX)
+     * @return true if successful, false if sensors is out of range
+     * @note Variances are reset to 25 mm^2 (5 mm standard deviation)
+     */
+    bool begin(uint8_t sensors);
+
+    /*!
+     * @brief Set the fusion mode
+     * @param mode DYP_R01CW_FUSION_MEDIAN (default) or DYP_R01CW_FUSION_WEIGHTED
+     */
+    void setMode(uint8_t mode) { _mode = mode; }
+
+    /*!
+     * @brief Set the agreement tolerance
+     * @param tolerance Maximum deviation from the median in millimeters (default 50)
+     */
+    void setTolerance(uint16_t tolerance) { _tolerance = tolerance; }
+
+    /*!
+     * @brief Set the quorum
+     * @param quorum Minimum number of agreeing sensors for an output (1...sensors, default 1)
+     */
+    void setQuorum(uint8_t quorum);
+
+    /*!
+     * @brief Set a sensor's distance variance for DYP_R01CW_FUSION_WEIGHTED
+     * @param sensor Sensor index
+     * @param variance Variance in mm^2 (1...65535, default 25)
+     * @note The weight DYP_R01CW_FUSION_WEIGHT_ONE / variance has at least 8
+     *       significant bits over the whole range
+     */
+    void setVariance(uint8_t sensor, uint16_t variance);
+
+    /*!
+     * @brief Clear the output
+     */
+    void reset();
+
+    /*!
+     * @brief Fuse a frame
+     * @param distance Distances in millimeters, one per sensor
+     * @param valid Bit mask of valid distances (bit i: sensor i)
+     * @return true if the quorum of sensors agreed and distance() was updated
+     */
+    bool process(const int16_t *distance, uint8_t valid);
+
+    /*!
+     * @brief Get the fused distance
+     * @return Distance in millimeters (last successful frame, initially 0)
+     */
+    int16_t distance() const { return _distance; }
+
+    /*!
+     * @brief Get the sensors used in the last frame
+     * @return Bit mask of the valid, agreeing sensors
+     */
+    uint8_t used() const { return _used; }
+
+    /*!
+     * @brief Get the disagreeing sensors of the last frame
+     * @return Bit mask of the valid sensors outside the tolerance
+     */
+    uint8_t disagreeing() const { return _disagreeing; }
+
+    /*!
+     * @brief Get the number of sensors
+     * @return Number of sensors
+     */
+    uint8_t sensors() const { return _sensors; }
+
+private:
+    uint32_t _weight[DYP_R01CW_FUSION_MAX]; ///< Inverse variances (DYP_R01CW_FUSION_WEIGHT_ONE / variance)
+    int16_t _distance;                      ///< Fused distance
+    uint16_t _tolerance;                    ///< Agreement tolerance in millimeters
+    uint8_t _sensors;                       ///< Number of sensors
+    uint8_t _quorum;                        ///< Minimum number of agreeing sensors
+    uint8_t _mode;                          ///< Fusion mode
+    uint8_t _used;                          ///< Sensors used in the last frame
+    uint8_t _disagreeing;                   ///< Disagreeing sensors of the last frame
+};
+
+#endif // DYP_R01CW_FUSION_H
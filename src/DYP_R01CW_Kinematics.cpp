@@ -0,0 +1,124 @@
+/*!
+ * @file DYP_R01CW_Kinematics.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - velocity and acceleration
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Kinematics.h"
+
+// Milliseconds per second, scaled by 2^DYP_R01CW_KINEMATICS_FRAC_BITS
+#define DYP_R01CW_KINEMATICS_SCALE (1000L << DYP_R01CW_KINEMATICS_FRAC_BITS)
+
+/*!
+ * @brief Saturate a 64-bit value to the int32_t range
+ */
+static int32_t saturate(int64_t x) {
+    if (x > 2147483647L) {
+        return 2147483647L;
+    }
+    if (x < -2147483647L - 1) {
+        return -2147483647L - 1;
+    }
+    return (int32_t)x;
+}
+
+/*!
+ * @brief Constructor (window 1)
+ */
+DYP_R01CW_Kinematics::DYP_R01CW_Kinematics() {
+    _window = 1;
+    reset();
+}
+
+/*!
+ * @brief Set the smoothing window
+ * @param window Number of samples between the differenced values
+ */
+void DYP_R01CW_Kinematics::setWindow(uint8_t window) {
+    if (window < 1) {
+        window = 1;
+    }
+    if (window > DYP_R01CW_KINEMATICS_WINDOW_MAX) {
+        window = DYP_R01CW_KINEMATICS_WINDOW_MAX;
+    }
+    _window = window;
+    reset();
+}
+
+/*!
+ * @brief Clear the sample history
+ */
+void DYP_R01CW_Kinematics::reset() {
+    _velocity = 0;
+    _acceleration = 0;
+    _dCount = 0;
+    _dPos = 0;
+    _vCount = 0;
+    _vPos = 0;
+}
+
+/*!
+ * @brief Add a distance dated to the middle of its conversion
+ * @param distance Distance in millimeters
+ * @param triggerTime Time of the measurement trigger in milliseconds
+ * @param readTime Time of the result read in milliseconds
+ * @return true if a velocity estimate is available
+ */
+bool DYP_R01CW_Kinematics::update(int16_t distance, uint32_t triggerTime, uint32_t readTime) {
+    return update(distance, triggerTime + (uint32_t)(readTime - triggerTime) / 2);
+}
+
+/*!
+ * @brief Add a distance
+ * @param distance Distance in millimeters
+ * @param time Time of the distance in milliseconds
+ * @return true if a velocity estimate is available
+ */
+bool DYP_R01CW_Kinematics::update(int16_t distance, uint32_t time) {
+    // Ring buffers hold window + 1 entries: the oldest one is window samples back
+    const uint8_t size = _window + 1;
+
+    if (_dCount < _window) {
+        _d[_dPos] = distance;
+        _t[_dPos] = time;
+        _dPos = (_dPos + 1 == size) ? 0 : _dPos + 1;
+        _dCount++;
+        return false;
+    }
+
+    uint8_t old = (_dPos + 1 == size) ? 0 : _dPos + 1;
+    uint32_t dt = time - _t[old];
+    if (dt == 0) {
+        return hasVelocity();
+    }
+    int32_t v = saturate((int64_t)(distance - _d[old]) * DYP_R01CW_KINEMATICS_SCALE / (int64_t)dt);
+    uint32_t tv = _t[old] + dt / 2;
+    _d[_dPos] = distance;
+    _t[_dPos] = time;
+    _dPos = old;
+    _velocity = v;
+
+    if (_vCount >= _window) {
+        uint8_t vOld = (_vPos + 1 == size) ? 0 : _vPos + 1;
+        uint32_t dtv = tv - _tv[vOld];
+        if (dtv != 0) {
+            _acceleration = saturate(((int64_t)v - _v[vOld]) * 1000 / (int64_t)dtv);
+        }
+    }
+    _v[_vPos] = v;
+    _tv[_vPos] = tv;
+    _vPos = (_vPos + 1 == size) ? 0 : _vPos + 1;
+    if (_vCount < size) {
+        _vCount++;
+    }
+
+    return true;
+}
@@ -0,0 +1,122 @@
+/*!
+ * @file DYP_R01CW_Kinematics.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - velocity and acceleration
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Kinematics estimates the velocity and acceleration of the
+ * target of one sensor from timestamped distances. Each distance is dated
+ * to the middle of its conversion (between the trigger and the read), and
+ * the estimates are finite differences over a configurable window of
+ * samples, using the actual time between the samples:
+ *
+ *   velocity     = (d[n] - d[n - window]) / (t[n] - t[n - window])
+ *   acceleration = (v[n] - v[n - window]) / (tv[n] - tv[n - window])
+ *
+ * where tv is the middle of the velocity interval. Larger windows reduce
+ * the noise at the expense of latency. Results are fixed-point with
+ * DYP_R01CW_KINEMATICS_FRAC_BITS fraction bits; each update takes constant
+ * time and uses integer arithmetic only (64-bit intermediates).
+ * The kinematics stage is available in every tier.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_KINEMATICS_H
+#define DYP_R01CW_KINEMATICS_H
+
+#include <stdint.h>
+
+// Maximum smoothing window (samples)
+#define DYP_R01CW_KINEMATICS_WINDOW_MAX 8
+
+// Fraction bits of velocity (mm/s) and acceleration (mm/s^2)
+#define DYP_R01CW_KINEMATICS_FRAC_BITS 8
+
+/*!
+ * @brief Velocity and acceleration estimator for one sensor
+ */
+class DYP_R01CW_Kinematics {
+public:
+    DYP_R01CW_Kinematics();
+
+    /*!
+     * @brief Set the smoothing window
+     * @param window Number of samples between the differenced values (1...DYP_R01CW_KINEMATICS_WINDOW_MAX)
+     */
+    void setWindow(uint8_t window);
+
+    /*!
+     * @brief Clear the sample history
+     */
+    void reset();
+
+    /*!
+     * @brief Add a distance
+     * @param distance Distance in millimeters
+     * @param triggerTime Time of the measurement trigger in milliseconds (e.g. DYP_R01CW::getTriggerTime())
+     * @param readTime Time of the result read in milliseconds (e.g. DYP_R01CW_Sample::timestamp)
+     * @return true if a velocity estimate is available
+     * @note The distance is dated to the middle between triggerTime and readTime
+     */
+    bool update(int16_t distance, uint32_t triggerTime, uint32_t readTime);
+
+    /*!
+     * @brief Add a distance
+     * @param distance Distance in millimeters
+     * @param time Time of the distance in milliseconds
+     * @return true if a velocity estimate is available
+     * @note Only valid samples should be added; samples with the same time as
+     *       the sample window samples before are ignored
+     */
+    bool update(int16_t distance, uint32_t time);
+
+    /*!
+     * @brief Get the velocity
+     * @return Velocity in mm/s, scaled by 2^DYP_R01CW_KINEMATICS_FRAC_BITS
+     *         (positive: moving away from the sensor), 0 if not available
+     */
+    int32_t velocity() const { return _velocity; }
+
+    /*!
+     * @brief Get the acceleration
+     * @return Acceleration in mm/s^2, scaled by 2^DYP_R01CW_KINEMATICS_FRAC_BITS, 0 if not available
+     */
+    int32_t acceleration() const { return _acceleration; }
+
+    /*!
+     * @brief Check if a velocity estimate is available (window + 1 samples)
+     * @return true if available
+     */
+    bool hasVelocity() const { return _vCount > 0; }
+
+    /*!
+     * @brief Check if an acceleration estimate is available (2 * window + 1 samples)
+     * @return true if available
+     */
+    bool hasAcceleration() const { return _vCount > _window; }
+
+private:
+    static const uint8_t _size = DYP_R01CW_KINEMATICS_WINDOW_MAX + 1;  ///< Ring buffer size
+
+    int16_t _d[_size];       ///< Distances
+    uint32_t _t[_size];      ///< Distance times
+    int32_t _v[_size];       ///< Velocities
+    uint32_t _tv[_size];     ///< Velocity times
+    int32_t _velocity;       ///< Current velocity
+    int32_t _acceleration;   ///< Current acceleration
+    uint8_t _window;         ///< Smoothing window
+    uint8_t _dCount;         ///< Number of distances
+    uint8_t _dPos;           ///< Next distance position
+    uint8_t _vCount;         ///< Number of velocities
+    uint8_t _vPos;           ///< Next velocity position
+};
+
+#endif // DYP_R01CW_KINEMATICS_H
@@ -0,0 +1,81 @@
+/*!
+ * @file DYP_R01CW_Log.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library for Arduino
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Log.h"
+
+static const uint8_t logMagic[8] = {'D', 'Y', 'P', 'R', '0', '1', 'C', 'W'};
+
+/*!
+ * @brief Write the log file header
+ * @param buf Destination buffer (DYP_R01CW_LOG_HEADER_SIZE bytes)
+ */
+void DYP_R01CW_Log::encodeHeader(uint8_t *buf) {
+    for (uint8_t i = 0; i < 8; i++) {
+        buf[i] = logMagic[i];
+    }
+    buf[8] = DYP_R01CW_LOG_VERSION & 0xFF;
+    buf[9] = DYP_R01CW_LOG_VERSION >> 8;
+    buf[10] = DYP_R01CW_LOG_RECORD_SIZE & 0xFF;
+    buf[11] = DYP_R01CW_LOG_RECORD_SIZE >> 8;
+    buf[12] = 0;
+    buf[13] = 0;
+    buf[14] = 0;
+    buf[15] = 0;
+}
+
+/*!
+ * @brief Check a log file header
+ * @param buf Header bytes (DYP_R01CW_LOG_HEADER_SIZE bytes)
+ * @return true if magic, version and record size match, false otherwise
+ */
+bool DYP_R01CW_Log::checkHeader(const uint8_t *buf) {
+    for (uint8_t i = 0; i < 8; i++) {
+        if (buf[i] != logMagic[i]) {
+            return false;
+        }
+    }
+    uint16_t version = buf[8] | (buf[9] << 8);
+    uint16_t recordSize = buf[10] | (buf[11] << 8);
+
+    return (version == DYP_R01CW_LOG_VERSION) && (recordSize == DYP_R01CW_LOG_RECORD_SIZE);
+}
+
+/*!
+ * @brief Encode a sample into a log record
+ * @param sample Sample to encode
+ * @param buf Destination buffer (DYP_R01CW_LOG_RECORD_SIZE bytes)
+ */
+void DYP_R01CW_Log::encode(const DYP_R01CW_Sample &sample, uint8_t *buf) {
+    buf[0] = sample.timestamp & 0xFF;
+    buf[1] = (sample.timestamp >> 8) & 0xFF;
+    buf[2] = (sample.timestamp >> 16) & 0xFF;
+    buf[3] = (sample.timestamp >> 24) & 0xFF;
+    buf[4] = sample.raw & 0xFF;
+    buf[5] = sample.raw >> 8;
+    buf[6] = sample.addr;
+    buf[7] = sample.status;
+}
+
+/*!
+ * @brief Decode a log record into a sample
+ * @param buf Record bytes (DYP_R01CW_LOG_RECORD_SIZE bytes)
+ * @param sample Decoded sample
+ */
+void DYP_R01CW_Log::decode(const uint8_t *buf, DYP_R01CW_Sample &sample) {
+    sample.timestamp = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+                       ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+    sample.raw = buf[4] | (buf[5] << 8);
+    sample.addr = buf[6];
+    sample.status = buf[7];
+}
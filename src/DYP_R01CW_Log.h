@@ -0,0 +1,82 @@
+/*!
+ * @file DYP_R01CW_Log.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library for Arduino
+ *
+ * @section intro_sec Introduction
+ *
+ * Binary sample log format. A log consists of a 16-byte file header followed
+ * by fixed-size 8-byte sample records. All multi-byte fields are little-endian,
+ * so logs written on any target can be decoded on any host. The fixed record
+ * size allows a log to be split at arbitrary record boundaries and decoded in
+ * parallel.
+ *
+ * File header:
+ * | Offset | Size | Content                        |
+ * |--------|------|--------------------------------|
+ * | 0      | 8    | Magic "DYPR01CW"               |
+ * | 8      | 2    | Format version (1)             |
+ * | 10     | 2    | Record size in bytes (8)       |
+ * | 12     | 4    | Reserved (0)                   |
+ *
+ * Sample record:
+ * | Offset | Size | Content                        |
+ * |--------|------|--------------------------------|
+ * | 0      | 4    | Timestamp in milliseconds      |
+ * | 4      | 2    | Raw DATA_REG value             |
+ * | 6      | 1    | I2C address (8-bit format)     |
+ * | 7      | 1    | Status (DYP_R01CW_STATUS_*)    |
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_LOG_H
+#define DYP_R01CW_LOG_H
+
+#include <stdint.h>
+#include "DYP_R01CW_Sample.h"
+
+#define DYP_R01CW_LOG_VERSION 1
+#define DYP_R01CW_LOG_HEADER_SIZE 16
+#define DYP_R01CW_LOG_RECORD_SIZE 8
+
+/*!
+ * @brief Encoder/decoder for the binary sample log format
+ */
+class DYP_R01CW_Log {
+public:
+    /*!
+     * @brief Write the log file header
+     * @param buf Destination buffer (DYP_R01CW_LOG_HEADER_SIZE bytes)
+     */
+    static void encodeHeader(uint8_t *buf);
+
+    /*!
+     * @brief Check a log file header
+     * @param buf Header bytes (DYP_R01CW_LOG_HEADER_SIZE bytes)
+     * @return true if magic, version and record size match, false otherwise
+     */
+    static bool checkHeader(const uint8_t *buf);
+
+    /*!
+     * @brief Encode a sample into a log record
+     * @param sample Sample to encode
+     * @param buf Destination buffer (DYP_R01CW_LOG_RECORD_SIZE bytes)
+     */
+    static void encode(const DYP_R01CW_Sample &sample, uint8_t *buf);
+
+    /*!
+     * @brief Decode a log record into a sample
+     * @param buf Record bytes (DYP_R01CW_LOG_RECORD_SIZE bytes)
+     * @param sample Decoded sample
+     */
+    static void decode(const uint8_t *buf, DYP_R01CW_Sample &sample);
+};
+
+#endif // DYP_R01CW_LOG_H
@@ -0,0 +1,131 @@
+/*!
+ * @file DYP_R01CW_Occupancy.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - adaptive occupancy detector
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Occupancy.h"
+
+/*!
+ * @brief Constructor (default parameters)
+ */
+DYP_R01CW_Occupancy::DYP_R01CW_Occupancy() {
+    _margin = 50;
+    _absorb = 0;
+    _enter = 48;
+    _leave = 32;
+    _shift = 8;
+    reset();
+}
+
+/*!
+ * @brief Set the background adaptation rate
+ * @param shift Adaptation shift
+ */
+void DYP_R01CW_Occupancy::setAdaptation(uint8_t shift) {
+    if (shift < 1) {
+        shift = 1;
+    }
+    if (shift > 12) {
+        shift = 12;
+    }
+    _shift = shift;
+    reset();
+}
+
+/*!
+ * @brief Set the detection thresholds
+ * @param enter Enter threshold (Q4)
+ * @param leave Leave threshold (Q4)
+ */
+void DYP_R01CW_Occupancy::setThresholds(uint8_t enter, uint8_t leave) {
+    _enter = enter;
+    _leave = (leave > enter) ? enter : leave;
+}
+
+/*!
+ * @brief Forget the background and restart learning
+ */
+void DYP_R01CW_Occupancy::reset() {
+    _mean = 0;
+    _dev = 0;
+    _count = 0;
+    _run = 0;
+    _occupied = false;
+}
+
+/*!
+ * @brief Get a detection threshold
+ * @param k Multiple of the deviation (Q4)
+ * @return Threshold (Q8)
+ */
+int32_t DYP_R01CW_Occupancy::threshold(uint8_t k) const {
+    int32_t t = (_dev >> 4) * k;
+    int32_t m = (int32_t)_margin << _frac;
+    return (t > m) ? t : m;
+}
+
+/*!
+ * @brief Process a distance value
+ * @param distance Distance in millimeters
+ * @return DYP_R01CW_EVENT_NONE, DYP_R01CW_EVENT_ENTER or DYP_R01CW_EVENT_LEAVE
+ */
+uint8_t DYP_R01CW_Occupancy::update(int16_t distance) {
+    int32_t x = (int32_t)distance << _frac;
+    uint8_t event = DYP_R01CW_EVENT_NONE;
+
+    if (_count == 0) {
+        _mean = x;
+        _dev = 0;
+        _count = 1;
+        return event;
+    }
+
+    // Positive: closer than the background
+    int32_t diff = _mean - x;
+
+    if (!isLearning()) {
+        if (!_occupied) {
+            if (diff > threshold(_enter)) {
+                _occupied = true;
+                _run = 0;
+                return DYP_R01CW_EVENT_ENTER;
+            }
+        } else if (diff >= threshold(_leave)) {
+            if (_absorb != 0 && ++_run >= _absorb) {
+                // Object has become part of the background
+                _mean = x;
+                _occupied = false;
+                return DYP_R01CW_EVENT_LEAVE;
+            }
+            return event;
+        } else {
+            _occupied = false;
+            event = DYP_R01CW_EVENT_LEAVE;
+        }
+    }
+
+    // Background sample: adapt, with alpha = 1 / (count + 1) until 2^shift samples
+    uint8_t s = _shift;
+    if (_count < ((uint16_t)1 << _shift)) {
+        s = 0;
+        while (((uint16_t)2 << s) <= _count + 1) {
+            s++;
+        }
+    }
+    _mean += (x - _mean) >> s;
+    _dev += ((diff < 0 ? -diff : diff) - _dev) >> s;
+    if (_count < 0xFFFF) {
+        _count++;
+    }
+
+    return event;
+}
@@ -0,0 +1,132 @@
+/*!
+ * @file DYP_R01CW_Occupancy.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - adaptive occupancy detector
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Occupancy detects objects in front of a sensor against a
+ * learned background instead of a fixed threshold. It keeps exponential
+ * moving averages of the background distance and of its mean absolute
+ * deviation. A distance closer than the background by more than a multiple
+ * of the deviation (and at least a minimum margin) is reported as
+ * DYP_R01CW_EVENT_ENTER; DYP_R01CW_EVENT_LEAVE is reported when it is back
+ * within a smaller multiple (hysteresis).
+ *
+ * The background adapts slowly to free samples only, so moved furniture or
+ * a remounted sensor is learned without absorbing people. An object which
+ * stays for a configurable number of samples can be absorbed into the
+ * background. Each detector uses a few bytes and constant time per sample.
+ * The occupancy stage is available in every tier.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_OCCUPANCY_H
+#define DYP_R01CW_OCCUPANCY_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Processing.h"
+
+// Number of samples learned before detection starts
+#define DYP_R01CW_OCCUPANCY_LEARN_SAMPLES 16
+
+/*!
+ * @brief Adaptive-baseline occupancy detector for one sensor
+ */
+class DYP_R01CW_Occupancy {
+public:
+    DYP_R01CW_Occupancy();
+
+    /*!
+     * @brief Set the background adaptation rate
+     * @param shift Adaptation shift (alpha = 2^-shift, 1...12, default 8)
+     */
+    void setAdaptation(uint8_t shift);
+
+    /*!
+     * @brief Set the detection thresholds
+     * @param enter Multiple of the background deviation for DYP_R01CW_EVENT_ENTER (Q4, default 48: 3.0)
+     * @param leave Multiple of the background deviation for DYP_R01CW_EVENT_LEAVE (Q4, default 32: 2.0)
+     * @note leave is limited to enter
+     */
+    void setThresholds(uint8_t enter, uint8_t leave);
+
+    /*!
+     * @brief Set the minimum distance between object and background
+     * @param margin Margin in millimeters (default 50)
+     */
+    void setMargin(uint16_t margin) { _margin = margin; }
+
+    /*!
+     * @brief Set the time after which an object becomes background
+     * @param samples Number of consecutive occupied samples (0: never, default)
+     */
+    void setAbsorb(uint16_t samples) { _absorb = samples; }
+
+    /*!
+     * @brief Forget the background and restart learning
+     */
+    void reset();
+
+    /*!
+     * @brief Process a distance value
+     * @param distance Distance in millimeters (valid samples only)
+     * @return DYP_R01CW_EVENT_NONE, DYP_R01CW_EVENT_ENTER or DYP_R01CW_EVENT_LEAVE
+     */
+    uint8_t update(int16_t distance);
+
+    /*!
+     * @brief Get detector state
+     * @return true if an object is present
+     */
+    bool isOccupied() const { return _occupied; }
+
+    /*!
+     * @brief Check if the detector is still learning the background
+     * @return true during the first DYP_R01CW_OCCUPANCY_LEARN_SAMPLES samples
+     */
+    bool isLearning() const { return _count < DYP_R01CW_OCCUPANCY_LEARN_SAMPLES; }
+
+    /*!
+     * @brief Get the background distance
+     * @return Background distance in millimeters
+     */
+    int16_t background() const { return (int16_t)(_mean >> _frac); }
+
+    /*!
+     * @brief Get the background deviation
+     * @return Mean absolute deviation of the background in millimeters
+     */
+    uint16_t deviation() const { return (uint16_t)(_dev >> _frac); }
+
+private:
+    static const uint8_t _frac = 8;  ///< Fraction bits of _mean and _dev
+
+    /*!
+     * @brief Get a detection threshold
+     * @param k Multiple of the deviation (Q4)
+     * @return Threshold (Q8)
+     */
+    int32_t threshold(uint8_t k) const;
+
+    int32_t _mean;       ///< Background distance (Q8)
+    int32_t _dev;        ///< Background mean absolute deviation (Q8)
+    uint16_t _count;     ///< Learned samples (saturating)
+    uint16_t _run;       ///< Consecutive occupied samples
+    uint16_t _margin;    ///< Minimum margin in millimeters
+    uint16_t _absorb;    ///< Absorb after this many occupied samples (0: never)
+    uint8_t _shift;      ///< Adaptation shift
+    uint8_t _enter;      ///< Enter threshold (Q4)
+    uint8_t _leave;      ///< Leave threshold (Q4)
+    bool _occupied;      ///< Current state
+};
+
+#endif // DYP_R01CW_OCCUPANCY_H
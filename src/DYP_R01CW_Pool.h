@@ -0,0 +1,155 @@
+/*!
+ * @file DYP_R01CW_Pool.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - static object pools
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Pool<T, CAPACITY> hands out objects from a fixed array instead
+ * of the heap: allocation and release are O(1), cannot fragment memory and
+ * fail (nullptr) instead of growing when the pool is exhausted. Each pool
+ * records its current use, its high-water mark and failed allocations, so
+ * the capacities can be sized from field data.
+ *
+ * Pools are provided for sample records (DYP_R01CW_SamplePool) and event
+ * notifications (DYP_R01CW_EventPool); the capacities can be overridden with
+ * the DYP_R01CW_*_POOL_SIZE macros. Other record types can be pooled with
+ * DYP_R01CW_Pool<T, CAPACITY> directly.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_POOL_H
+#define DYP_R01CW_POOL_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_Sample.h"
+
+// Pool capacities
+#ifndef DYP_R01CW_SAMPLE_POOL_SIZE
+#define DYP_R01CW_SAMPLE_POOL_SIZE 8
+#endif
+#ifndef DYP_R01CW_EVENT_POOL_SIZE
+#define DYP_R01CW_EVENT_POOL_SIZE 4
+#endif
+
+/*!
+ * @brief Event notification
+ */
+struct DYP_R01CW_Event {
+    uint32_t timestamp;  ///< Time of the sample causing the event in milliseconds
+    int16_t distance;    ///< Distance in millimeters
+    uint8_t addr;        ///< I2C address of the sensor in 8-bit format
+    uint8_t type;        ///< Event type (DYP_R01CW_EVENT_*)
+};
+
+/*!
+ * @brief Fixed-capacity object pool
+ * @tparam T Object type (default constructible)
+ * @tparam CAPACITY Number of objects (1...255)
+ */
+template <class T, uint8_t CAPACITY> class DYP_R01CW_Pool {
+    static_assert(CAPACITY > 0, "DYP_R01CW_Pool: capacity must not be 0");
+
+public:
+    static const uint8_t capacity = CAPACITY;  ///< Number of objects
+
+    DYP_R01CW_Pool() {
+        for (uint8_t i = 0; i < CAPACITY; i++) {
+            _free[i] = CAPACITY - 1 - i;
+            _inUse[i] = false;
+        }
+        _freeCount = CAPACITY;
+        resetStats();
+    }
+
+    /*!
+     * @brief Take an object from the pool
+     * @return Object (contents as left by its previous user), or nullptr if the pool is exhausted
+     */
+    T *allocate() {
+        if (_freeCount == 0) {
+            if (_failures < 0xFFFF) {
+                _failures++;
+            }
+            return nullptr;
+        }
+        uint8_t i = _free[--_freeCount];
+        _inUse[i] = true;
+        if (used() > _highWater) {
+            _highWater = used();
+        }
+        return &_items[i];
+    }
+
+    /*!
+     * @brief Return an object to the pool
+     * @param item Object obtained from allocate()
+     * @return true if released, false if the object is not from this pool or not allocated
+     */
+    bool release(T *item) {
+        if (item < _items || item >= _items + CAPACITY) {
+            return false;
+        }
+        uint8_t i = (uint8_t)(item - _items);
+        if (!_inUse[i]) {
+            return false;
+        }
+        _inUse[i] = false;
+        _free[_freeCount++] = i;
+        return true;
+    }
+
+    /*!
+     * @brief Get the number of allocated objects
+     * @return Allocated objects
+     */
+    uint8_t used() const { return CAPACITY - _freeCount; }
+
+    /*!
+     * @brief Get the number of free objects
+     * @return Free objects
+     */
+    uint8_t available() const { return _freeCount; }
+
+    /*!
+     * @brief Get the high-water mark
+     * @return Maximum number of simultaneously allocated objects since construction or resetStats()
+     */
+    uint8_t highWater() const { return _highWater; }
+
+    /*!
+     * @brief Get the number of failed allocations
+     * @return Allocations failed because the pool was exhausted (saturates at 65535)
+     */
+    uint16_t failures() const { return _failures; }
+
+    /*!
+     * @brief Reset the statistics (high-water mark to the current use)
+     */
+    void resetStats() {
+        _highWater = used();
+        _failures = 0;
+    }
+
+private:
+    T _items[CAPACITY];      ///< Objects
+    uint8_t _free[CAPACITY]; ///< Stack of free object indices
+    bool _inUse[CAPACITY];   ///< Object is allocated
+    uint8_t _freeCount;      ///< Number of free objects
+    uint8_t _highWater;      ///< Maximum number of allocated objects
+    uint16_t _failures;      ///< Failed allocations
+};
+
+typedef DYP_R01CW_Pool<DYP_R01CW_Sample, DYP_R01CW_SAMPLE_POOL_SIZE> DYP_R01CW_SamplePool; ///< Sample records
+typedef DYP_R01CW_Pool<DYP_R01CW_Event, DYP_R01CW_EVENT_POOL_SIZE> DYP_R01CW_EventPool;    ///< Event notifications
+
+#endif // DYP_R01CW_POOL_H
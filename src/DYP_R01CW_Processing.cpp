@@ -0,0 +1,190 @@
+/*!
+ * @file DYP_R01CW_Processing.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library for Arduino
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Processing.h"
+
+#if DYP_R01CW_HAS_FILTERS
+
+/*!
+ * @brief Constructor (filter disabled)
+ */
+DYP_R01CW_MedianFilter::DYP_R01CW_MedianFilter() {
+    _window = 1;
+    reset();
+}
+
+/*!
+ * @brief Set the window size
+ * @param window Window size (1 disables the filter; even sizes are rounded up)
+ */
+void DYP_R01CW_MedianFilter::setWindow(uint8_t window) {
+    if (window < 1) {
+        window = 1;
+    }
+    if (window > DYP_R01CW_MEDIAN_MAX) {
+        window = DYP_R01CW_MEDIAN_MAX;
+    }
+    // Use odd window sizes only
+    _window = window | 0x01;
+    reset();
+}
+
+/*!
+ * @brief Clear the filter history
+ */
+void DYP_R01CW_MedianFilter::reset() {
+    _count = 0;
+    _pos = 0;
+}
+
+/*!
+ * @brief Add a value and return the median of the current window
+ * @param value Input value
+ * @return Median of the last min(n, window) values
+ */
+int16_t DYP_R01CW_MedianFilter::update(int16_t value) {
+    if (_window == 1) {
+        return value;
+    }
+
+    _buf[_pos] = value;
+    _pos = (_pos + 1 == _window) ? 0 : _pos + 1;
+    if (_count < _window) {
+        _count++;
+    }
+
+    return DYP_R01CW_median<int16_t, DYP_R01CW_min<int16_t>, DYP_R01CW_max<int16_t> >(_buf, _count);
+}
+
+/*!
+ * @brief Constructor (filter disabled)
+ */
+DYP_R01CW_EmaFilter::DYP_R01CW_EmaFilter() {
+    _shift = 0;
+    reset();
+}
+
+/*!
+ * @brief Set the smoothing factor
+ * @param shift Smoothing shift (0 disables the filter, max. 15)
+ */
+void DYP_R01CW_EmaFilter::setShift(uint8_t shift) {
+    _shift = (shift > 15) ? 15 : shift;
+    reset();
+}
+
+/*!
+ * @brief Clear the filter state
+ */
+void DYP_R01CW_EmaFilter::reset() {
+    _acc = 0;
+    _primed = false;
+}
+
+/*!
+ * @brief Add a value and return the filtered value
+ * @param value Input value
+ * @return Filtered value
+ */
+int16_t DYP_R01CW_EmaFilter::update(int16_t value) {
+    // Start from the first value instead of zero
+    _acc = DYP_R01CW_emaStep(_acc, value, _shift, _primed);
+    _primed = true;
+
+    return (int16_t)(_acc >> _shift);
+}
+
+/*!
+ * @brief Constructor (detector disabled)
+ */
+DYP_R01CW_Threshold::DYP_R01CW_Threshold() {
+    begin(0, 0);
+}
+
+/*!
+ * @brief Configure the detector
+ * @param threshold Distance in millimeters below which DYP_R01CW_EVENT_ENTER is reported
+ * @param hysteresis Distance above threshold required for DYP_R01CW_EVENT_LEAVE
+ */
+void DYP_R01CW_Threshold::begin(int16_t threshold, uint16_t hysteresis) {
+    _threshold = threshold;
+    _hysteresis = hysteresis;
+    reset();
+}
+
+/*!
+ * @brief Reset detector state to "not below threshold"
+ */
+void DYP_R01CW_Threshold::reset() {
+    _below = false;
+}
+
+/*!
+ * @brief Process a distance value
+ * @param distance Distance in millimeters
+ * @return DYP_R01CW_EVENT_NONE, DYP_R01CW_EVENT_ENTER or DYP_R01CW_EVENT_LEAVE
+ */
+uint8_t DYP_R01CW_Threshold::update(int16_t distance) {
+    if (_threshold == 0) {
+        return DYP_R01CW_EVENT_NONE;
+    }
+
+    if (!_below && distance < _threshold) {
+        _below = true;
+        return DYP_R01CW_EVENT_ENTER;
+    }
+    if (_below && (int32_t)distance > (int32_t)_threshold + _hysteresis) {
+        _below = false;
+        return DYP_R01CW_EVENT_LEAVE;
+    }
+
+    return DYP_R01CW_EVENT_NONE;
+}
+
+/*!
+ * @brief Constructor (offset 0, all stages disabled)
+ */
+DYP_R01CW_Pipeline::DYP_R01CW_Pipeline() {
+    _offset = 0;
+}
+
+/*!
+ * @brief Clear all filter and detector state
+ */
+void DYP_R01CW_Pipeline::reset() {
+    _median.reset();
+    _ema.reset();
+    _threshold.reset();
+}
+
+/*!
+ * @brief Process a sample
+ * @param sample Raw sample
+ * @param distance Filtered distance in millimeters (unchanged if sample is invalid)
+ * @return Threshold event (DYP_R01CW_EVENT_*)
+ */
+uint8_t DYP_R01CW_Pipeline::process(const DYP_R01CW_Sample &sample, int16_t &distance) {
+    if (sample.status != DYP_R01CW_STATUS_OK) {
+        return DYP_R01CW_EVENT_NONE;
+    }
+
+    int16_t value = DYP_R01CW_applyOffset(sample.raw, _offset);
+    value = _median.update(value);
+    value = _ema.update(value);
+    distance = value;
+
+    return _threshold.update(value);
+}
+
+#endif // DYP_R01CW_HAS_FILTERS
@@ -0,0 +1,263 @@
+/*!
+ * @file DYP_R01CW_Processing.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library for Arduino
+ *
+ * @section intro_sec Introduction
+ *
+ * Platform-independent sample processing: distance offset, median filter,
+ * exponential moving average (EMA) filter and threshold event detection.
+ * The same code runs on the sensor node and in the host-side replay tool
+ * (extras/Replay), so offline results match the device exactly.
+ * All arithmetic is integer-only. The filter stages require
+ * DYP_R01CW_TIER_STANDARD or higher (see DYP_R01CW_Config.h).
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_PROCESSING_H
+#define DYP_R01CW_PROCESSING_H
+
+#include <stdint.h>
+#include "DYP_R01CW_Config.h"
+#include "DYP_R01CW_Sample.h"
+
+// Maximum median filter window size
+#define DYP_R01CW_MEDIAN_MAX 7
+
+// Threshold events
+#define DYP_R01CW_EVENT_NONE 0   ///< No event
+#define DYP_R01CW_EVENT_ENTER 1  ///< Distance fell below threshold
+#define DYP_R01CW_EVENT_LEAVE 2  ///< Distance rose above threshold + hysteresis
+
+/*!
+ * @brief Apply distance offset to a raw DATA_REG value
+ * @param raw Raw DATA_REG value in millimeters
+ * @param offset Offset in millimeters
+ * @return Distance in millimeters
+ */
+inline int16_t DYP_R01CW_applyOffset(uint16_t raw, int16_t offset) {
+    return (int16_t)(raw + offset);
+}
+
+#if DYP_R01CW_HAS_FILTERS
+/*!
+ * @brief Minimum of two values
+ */
+template <class T> inline T DYP_R01CW_min(T a, T b) {
+    return (a < b) ? a : b;
+}
+
+/*!
+ * @brief Maximum of two values
+ */
+template <class T> inline T DYP_R01CW_max(T a, T b) {
+    return (a > b) ? a : b;
+}
+
+/*!
+ * @brief Median of a small number of values
+ *
+ * Sorts a copy with an odd-even transposition network built from minimum
+ * and maximum only, so the same code runs on scalars (DYP_R01CW_MedianFilter)
+ * and on SIMD vectors holding many channels (DYP_R01CW_FilterBank).
+ * @tparam T Value or vector type
+ * @tparam MIN Minimum of two values
+ * @tparam MAX Maximum of two values
+ * @param values Values
+ * @param count Number of values (1...DYP_R01CW_MEDIAN_MAX)
+ * @return Median (the upper of the two middle values if count is even)
+ */
+template <class T, T (*MIN)(T, T), T (*MAX)(T, T)> inline T DYP_R01CW_median(const T *values, uint8_t count) {
+    T s[DYP_R01CW_MEDIAN_MAX];
+    for (uint8_t k = 0; k < count; k++) {
+        s[k] = values[k];
+    }
+    for (uint8_t r = 0; r < count; r++) {
+        for (uint8_t k = r & 1; k + 1 < count; k += 2) {
+            T lo = MIN(s[k], s[k + 1]);
+            s[k + 1] = MAX(s[k], s[k + 1]);
+            s[k] = lo;
+        }
+    }
+    return s[count / 2];
+}
+
+/*!
+ * @brief Exponential moving average step with alpha = 2^-shift
+ * @param acc Accumulator (value scaled by 2^shift)
+ * @param value Input value
+ * @param shift Smoothing shift
+ * @param primed true if the accumulator holds a value, false to start from value
+ * @return New accumulator (the filtered value is acc >> shift)
+ */
+inline int32_t DYP_R01CW_emaStep(int32_t acc, int32_t value, uint8_t shift, bool primed) {
+    return primed ? acc + value - (acc >> shift) : value << shift;
+}
+
+/*!
+ * @brief Running median filter with odd window size up to DYP_R01CW_MEDIAN_MAX
+ */
+class DYP_R01CW_MedianFilter {
+public:
+    DYP_R01CW_MedianFilter();
+
+    /*!
+     * @brief Set the window size
+     * @param window Window size (1 disables the filter; even sizes are rounded up)
+     */
+    void setWindow(uint8_t window);
+
+    /*!
+     * @brief Clear the filter history
+     */
+    void reset();
+
+    /*!
+     * @brief Add a value and return the median of the current window
+     * @param value Input value
+     * @return Median of the last min(n, window) values
+     */
+    int16_t update(int16_t value);
+
+private:
+    int16_t _buf[DYP_R01CW_MEDIAN_MAX]; ///< Ring buffer of recent values
+    uint8_t _window;                    ///< Window size
+    uint8_t _count;                     ///< Number of valid entries
+    uint8_t _pos;                       ///< Next write position
+};
+
+/*!
+ * @brief Integer exponential moving average with alpha = 2^-shift
+ */
+class DYP_R01CW_EmaFilter {
+public:
+    DYP_R01CW_EmaFilter();
+
+    /*!
+     * @brief Set the smoothing factor
+     * @param shift Smoothing shift (0 disables the filter, max. 15)
+     */
+    void setShift(uint8_t shift);
+
+    /*!
+     * @brief Clear the filter state
+     */
+    void reset();
+
+    /*!
+     * @brief Add a value and return the filtered value
+     * @param value Input value
+     * @return Filtered value
+     */
+    int16_t update(int16_t value);
+
+private:
+    int32_t _acc;    ///< Accumulator (value scaled by 2^shift)
+    uint8_t _shift;  ///< Smoothing shift
+    bool _primed;    ///< Accumulator holds a value
+};
+
+/*!
+ * @brief Threshold detector with hysteresis
+ */
+class DYP_R01CW_Threshold {
+public:
+    DYP_R01CW_Threshold();
+
+    /*!
+     * @brief Configure the detector
+     * @param threshold Distance in millimeters below which DYP_R01CW_EVENT_ENTER is reported
+     * @param hysteresis Distance above threshold required for DYP_R01CW_EVENT_LEAVE
+     * @note A threshold of 0 disables the detector
+     */
+    void begin(int16_t threshold, uint16_t hysteresis);
+
+    /*!
+     * @brief Reset detector state to "not below threshold"
+     */
+    void reset();
+
+    /*!
+     * @brief Process a distance value
+     * @param distance Distance in millimeters
+     * @return DYP_R01CW_EVENT_NONE, DYP_R01CW_EVENT_ENTER or DYP_R01CW_EVENT_LEAVE
+     */
+    uint8_t update(int16_t distance);
+
+    /*!
+     * @brief Get detector state
+     * @return true if the distance is currently below the threshold
+     */
+    bool isBelow() const { return _below; }
+
+private:
+    int16_t _threshold;    ///< Enter threshold in millimeters
+    uint16_t _hysteresis;  ///< Hysteresis in millimeters
+    bool _below;           ///< Current state
+};
+
+/*!
+ * @brief Processing chain: offset -> median -> EMA -> threshold events
+ *
+ * Invalid samples (status != DYP_R01CW_STATUS_OK) are skipped and leave the
+ * filter state unchanged.
+ */
+class DYP_R01CW_Pipeline {
+public:
+    DYP_R01CW_Pipeline();
+
+    /*!
+     * @brief Set the distance offset
+     * @param offset Offset in millimeters
+     */
+    void setDistanceOffset(int16_t offset) { _offset = offset; }
+
+    /*!
+     * @brief Set the median filter window size (1: disabled)
+     * @param window Window size
+     */
+    void setMedianWindow(uint8_t window) { _median.setWindow(window); }
+
+    /*!
+     * @brief Set the EMA smoothing shift (0: disabled)
+     * @param shift Smoothing shift
+     */
+    void setEmaShift(uint8_t shift) { _ema.setShift(shift); }
+
+    /*!
+     * @brief Configure threshold events (threshold 0: disabled)
+     * @param threshold Threshold in millimeters
+     * @param hysteresis Hysteresis in millimeters
+     */
+    void setThreshold(int16_t threshold, uint16_t hysteresis) { _threshold.begin(threshold, hysteresis); }
+
+    /*!
+     * @brief Clear all filter and detector state
+     */
+    void reset();
+
+    /*!
+     * @brief Process a sample
+     * @param sample Raw sample
+     * @param distance Filtered distance in millimeters (unchanged if sample is invalid)
+     * @return Threshold event (DYP_R01CW_EVENT_*)
+     */
+    uint8_t process(const DYP_R01CW_Sample &sample, int16_t &distance);
+
+private:
+    int16_t _offset;                  ///< Distance offset in millimeters
+    DYP_R01CW_MedianFilter _median;   ///< Median filter stage
+    DYP_R01CW_EmaFilter _ema;         ///< EMA filter stage
+    DYP_R01CW_Threshold _threshold;   ///< Event stage
+};
+
+#endif // DYP_R01CW_HAS_FILTERS
+
+#endif // DYP_R01CW_PROCESSING_H
@@ -0,0 +1,244 @@
+/*!
+ * @file DYP_R01CW_Protocol.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - protocol core
+ *
+ * @section intro_sec Introduction
+ *
+ * Platform-independent, header-only description of the sensor's register
+ * interface and the bus transactions to access it:
+ *
+ * - DYP_R01CW_Register describes a register (address, width, byte order,
+ *   access mode) and encodes / decodes its bus frames
+ * - DYP_R01CW_Command describes a command written to a register
+ * - DYP_R01CW_Protocol<BUS> generates the transactions for a bus transport
+ *
+ * A bus transport (BUS) provides:
+ *
+ *   static constexpr bool combined;  // writeRead() is available
+ *   uint8_t write(uint8_t addr, const uint8_t *data, uint8_t len);
+ *   uint8_t read(uint8_t addr, uint8_t *buf, uint8_t len);
+ *   uint8_t writeRead(uint8_t addr, const uint8_t *data, uint8_t len, uint8_t *buf, uint8_t rlen);
+ *
+ * with 7-bit addresses; write() returns 0 on success (or a Wire error code),
+ * read() the number of bytes received and writeRead() (register pointer
+ * write and read with repeated start, only if combined is true) a
+ * DYP_R01CW_STATUS_* code. Register reads use writeRead() if available,
+ * otherwise a pointer write followed by a read.
+ *
+ * All functions are inline and the register layout is known at compile
+ * time, so each access compiles to the bare transport calls.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_PROTOCOL_H
+#define DYP_R01CW_PROTOCOL_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Registers.h"
+#include "DYP_R01CW_Sample.h"
+
+// Register access modes
+#define DYP_R01CW_ACCESS_READ 0x01        ///< Register can be read
+#define DYP_R01CW_ACCESS_WRITE 0x02       ///< Register can be written
+#define DYP_R01CW_ACCESS_READ_WRITE 0x03  ///< Register can be read and written
+
+// Register byte order
+#define DYP_R01CW_BIG_ENDIAN 0     ///< Most significant byte first
+#define DYP_R01CW_LITTLE_ENDIAN 1  ///< Least significant byte first
+
+/*!
+ * @brief Register description
+ * @tparam ADDRESS Register address
+ * @tparam WIDTH Value width in bytes (1 or 2)
+ * @tparam ACCESS Access mode (DYP_R01CW_ACCESS_*)
+ * @tparam ORDER Byte order of 2-byte values (DYP_R01CW_BIG_ENDIAN or DYP_R01CW_LITTLE_ENDIAN)
+ */
+template <uint8_t ADDRESS, uint8_t WIDTH, uint8_t ACCESS, uint8_t ORDER = DYP_R01CW_BIG_ENDIAN>
+struct DYP_R01CW_Register {
+    static_assert(WIDTH == 1 || WIDTH == 2, "DYP_R01CW_Register: width must be 1 or 2 bytes");
+
+    static constexpr uint8_t address = ADDRESS;                              ///< Register address
+    static constexpr uint8_t width = WIDTH;                                  ///< Value width in bytes
+    static constexpr uint8_t order = ORDER;                                  ///< Byte order
+    static constexpr bool readable = (ACCESS & DYP_R01CW_ACCESS_READ) != 0;  ///< Register can be read
+    static constexpr bool writable = (ACCESS & DYP_R01CW_ACCESS_WRITE) != 0; ///< Register can be written
+    static constexpr uint8_t writeSize = 1 + WIDTH;                          ///< Size of a write frame
+
+    /*!
+     * @brief Encode a write frame (register address and value)
+     * @param buf Destination, at least writeSize bytes
+     * @param value Value
+     * @return Frame size
+     */
+    static uint8_t encode(uint8_t *buf, uint16_t value) {
+        buf[0] = ADDRESS;
+        if (WIDTH == 1) {
+            buf[1] = (uint8_t)value;
+        } else if (ORDER == DYP_R01CW_BIG_ENDIAN) {
+            buf[1] = (uint8_t)(value >> 8);
+            buf[2] = (uint8_t)value;
+        } else {
+            buf[1] = (uint8_t)value;
+            buf[2] = (uint8_t)(value >> 8);
+        }
+        return writeSize;
+    }
+
+    /*!
+     * @brief Decode a value read from the register
+     * @param buf Received bytes (width bytes)
+     * @return Value
+     */
+    static uint16_t decode(const uint8_t *buf) {
+        if (WIDTH == 1) {
+            return buf[0];
+        }
+        return (ORDER == DYP_R01CW_BIG_ENDIAN) ? (uint16_t)((buf[0] << 8) | buf[1])
+                                               : (uint16_t)((buf[1] << 8) | buf[0]);
+    }
+};
+
+/*!
+ * @brief Command description (fixed value written to a register)
+ * @tparam REG Register
+ * @tparam VALUE Command value
+ */
+template <class REG, uint16_t VALUE> struct DYP_R01CW_Command {
+    static_assert(REG::writable, "DYP_R01CW_Command: register is not writable");
+
+    typedef REG reg;                          ///< Register
+    static constexpr uint16_t value = VALUE;  ///< Command value
+};
+
+// Register map
+typedef DYP_R01CW_Register<DYP_R01CW_VERSION_REG, 2, DYP_R01CW_ACCESS_READ> DYP_R01CW_VersionRegister;
+typedef DYP_R01CW_Register<DYP_R01CW_DATA_REG, 2, DYP_R01CW_ACCESS_READ> DYP_R01CW_DataRegister;
+typedef DYP_R01CW_Register<DYP_R01CW_SLAVE_ADDR_REG, 1, DYP_R01CW_ACCESS_WRITE> DYP_R01CW_SlaveAddrRegister;
+typedef DYP_R01CW_Register<DYP_R01CW_COMMAND_REG, 1, DYP_R01CW_ACCESS_WRITE> DYP_R01CW_CommandRegister;
+typedef DYP_R01CW_Register<DYP_R01CW_COMMAND_REG, 2, DYP_R01CW_ACCESS_WRITE> DYP_R01CW_CommandRegister16;
+
+// Commands
+typedef DYP_R01CW_Command<DYP_R01CW_CommandRegister, DYP_R01CW_MEASURE_COMMAND> DYP_R01CW_MeasureCommand;
+typedef DYP_R01CW_Command<DYP_R01CW_CommandRegister16,
+                          (DYP_R01CW_RESTART_COMMAND_1 << 8) | DYP_R01CW_RESTART_COMMAND_2>
+    DYP_R01CW_RestartCommand;
+
+/*!
+ * @brief Bus transactions for a bus transport
+ * @tparam BUS Bus transport (see file description)
+ */
+template <class BUS> class DYP_R01CW_Protocol {
+public:
+    /*!
+     * @brief Address-only write (check if the device acknowledges)
+     * @param bus Bus transport
+     * @param addr 7-bit I2C address
+     * @return 0 on success, error code otherwise
+     */
+    static uint8_t probe(BUS &bus, uint8_t addr) {
+        return bus.write(addr, nullptr, 0);
+    }
+
+    /*!
+     * @brief Write a register
+     * @tparam REG Register
+     * @param bus Bus transport
+     * @param addr 7-bit I2C address
+     * @param value Value
+     * @return 0 on success, error code otherwise
+     */
+    template <class REG> static uint8_t write(BUS &bus, uint8_t addr, uint16_t value) {
+        static_assert(REG::writable, "DYP_R01CW_Protocol: register is not writable");
+        uint8_t buf[REG::writeSize];
+        return bus.write(addr, buf, REG::encode(buf, value));
+    }
+
+    /*!
+     * @brief Send a command
+     * @tparam CMD Command
+     * @param bus Bus transport
+     * @param addr 7-bit I2C address
+     * @return 0 on success, error code otherwise
+     */
+    template <class CMD> static uint8_t command(BUS &bus, uint8_t addr) {
+        return write<typename CMD::reg>(bus, addr, CMD::value);
+    }
+
+    /*!
+     * @brief Set the register pointer (first half of a split register read)
+     * @tparam REG Register
+     * @param bus Bus transport
+     * @param addr 7-bit I2C address
+     * @return 0 on success, error code otherwise
+     */
+    template <class REG> static uint8_t select(BUS &bus, uint8_t addr) {
+        static_assert(REG::readable, "DYP_R01CW_Protocol: register is not readable");
+        const uint8_t ptr = REG::address;
+        return bus.write(addr, &ptr, 1);
+    }
+
+    /*!
+     * @brief Read the selected register (second half of a split register read)
+     * @tparam REG Register
+     * @param bus Bus transport
+     * @param addr 7-bit I2C address
+     * @param value Value read
+     * @return DYP_R01CW_STATUS_OK or DYP_R01CW_STATUS_SHORT_READ
+     */
+    template <class REG> static uint8_t fetch(BUS &bus, uint8_t addr, uint16_t &value) {
+        static_assert(REG::readable, "DYP_R01CW_Protocol: register is not readable");
+        uint8_t buf[REG::width];
+        if (bus.read(addr, buf, REG::width) != REG::width) {
+            return DYP_R01CW_STATUS_SHORT_READ;
+        }
+        value = REG::decode(buf);
+        return DYP_R01CW_STATUS_OK;
+    }
+
+    /*!
+     * @brief Read a register with the shortest transaction of the transport
+     * @tparam REG Register
+     * @param bus Bus transport
+     * @param addr 7-bit I2C address
+     * @param value Value read
+     * @return DYP_R01CW_STATUS_OK, DYP_R01CW_STATUS_BUS_ERROR or DYP_R01CW_STATUS_SHORT_READ
+     */
+    template <class REG> static uint8_t read(BUS &bus, uint8_t addr, uint16_t &value) {
+        static_assert(REG::readable, "DYP_R01CW_Protocol: register is not readable");
+        return Read<REG, BUS::combined>::run(bus, addr, value);
+    }
+
+private:
+    // Register read, dispatched on BUS::combined
+    template <class REG, bool COMBINED> struct Read {
+        static uint8_t run(BUS &bus, uint8_t addr, uint16_t &value) {
+            if (select<REG>(bus, addr) != 0) {
+                return DYP_R01CW_STATUS_BUS_ERROR;
+            }
+            return fetch<REG>(bus, addr, value);
+        }
+    };
+
+    template <class REG> struct Read<REG, true> {
+        static uint8_t run(BUS &bus, uint8_t addr, uint16_t &value) {
+            const uint8_t ptr = REG::address;
+            uint8_t buf[REG::width];
+            uint8_t status = bus.writeRead(addr, &ptr, 1, buf, REG::width);
+            if (status == DYP_R01CW_STATUS_OK) {
+                value = REG::decode(buf);
+            }
+            return status;
+        }
+    };
+};
+
+#endif // DYP_R01CW_PROTOCOL_H
@@ -0,0 +1,148 @@
+/*!
+ * @file DYP_R01CW_Rate.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - adaptive sample rate
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include "DYP_R01CW_Rate.h"
+
+#include "DYP_R01CW_Registers.h"
+
+// Smoothing shift of the effective sample interval
+#define DYP_R01CW_RATE_AVG_SHIFT 3
+
+/*!
+ * @brief Constructor (conversion time to 1 s, activity 20 mm, no event band)
+ */
+DYP_R01CW_Rate::DYP_R01CW_Rate() {
+    _change = 20;
+    _threshold = 0;
+    _margin = 0;
+    _decay = 3;
+    _min = DYP_R01CW_CONVERSION_TIME_MS;
+    _max = 1000;
+    reset();
+}
+
+/*!
+ * @brief Set the period bounds
+ * @param minPeriod Minimum period in milliseconds
+ * @param maxPeriod Maximum period in milliseconds
+ */
+void DYP_R01CW_Rate::setBounds(uint16_t minPeriod, uint16_t maxPeriod) {
+    _min = (minPeriod < 1) ? 1 : minPeriod;
+    _max = (maxPeriod < _min) ? _min : maxPeriod;
+    reset();
+}
+
+/*!
+ * @brief Set the event band
+ * @param threshold Event threshold in millimeters
+ * @param margin Band half width in millimeters
+ */
+void DYP_R01CW_Rate::setNear(int16_t threshold, uint16_t margin) {
+    _threshold = threshold;
+    _margin = margin;
+}
+
+/*!
+ * @brief Set the decay rate
+ * @param decay Decay shift
+ */
+void DYP_R01CW_Rate::setDecay(uint8_t decay) {
+    if (decay < 1) {
+        decay = 1;
+    }
+    _decay = (decay > 8) ? 8 : decay;
+}
+
+/*!
+ * @brief Restart at the minimum period
+ */
+void DYP_R01CW_Rate::reset() {
+    _period = _min;
+    _next = 0;
+    _last = 0;
+    _interval = 0;
+    _distance = 0;
+    _primed = false;
+    _hasDistance = false;
+}
+
+/*!
+ * @brief Record a sample time
+ * @param time Time of the sample in milliseconds
+ */
+void DYP_R01CW_Rate::stamp(uint32_t time) {
+    if (_primed) {
+        uint32_t dt = time - _last;
+        if (dt > 0xFFFFFF) {
+            dt = 0xFFFFFF;
+        }
+        if (_interval == 0) {
+            _interval = dt << 4;
+        } else {
+            _interval += (int32_t)((dt << 4) - _interval) >> DYP_R01CW_RATE_AVG_SHIFT;
+        }
+    }
+    _last = time;
+    _primed = true;
+}
+
+/*!
+ * @brief Add a valid distance and schedule the next sample
+ * @param distance Distance in millimeters
+ * @param time Time of the sample in milliseconds
+ */
+void DYP_R01CW_Rate::update(int16_t distance, uint32_t time) {
+    bool active = false;
+    if (_hasDistance) {
+        int32_t d = (int32_t)distance - _distance;
+        active = d > (int32_t)_change || d < -(int32_t)_change;
+    }
+    if (_threshold != 0) {
+        int32_t d = (int32_t)distance - _threshold;
+        active = active || (d <= (int32_t)_margin && d >= -(int32_t)_margin);
+    }
+
+    if (active) {
+        _period = _min;
+    } else {
+        // Quiet: grow geometrically (at least 1 ms) up to the maximum
+        uint32_t p = (uint32_t)_period + (_period >> _decay) + 1;
+        _period = (p > _max) ? _max : (uint16_t)p;
+    }
+
+    _distance = distance;
+    _hasDistance = true;
+    stamp(time);
+    _next = time + _period;
+}
+
+/*!
+ * @brief Schedule the next sample after an invalid sample
+ * @param time Time of the sample in milliseconds
+ */
+void DYP_R01CW_Rate::skip(uint32_t time) {
+    stamp(time);
+    _next = time + _period;
+}
+
+/*!
+ * @brief Get the effective sample rate
+ * @return Rate in millihertz
+ */
+uint32_t DYP_R01CW_Rate::rate() const {
+    if (_interval == 0) {
+        return 0;
+    }
+    return (16000000UL + _interval / 2) / _interval;
+}
@@ -0,0 +1,126 @@
+/*!
+ * @file DYP_R01CW_Rate.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - adaptive sample rate
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Rate controls the sample period of one sensor from its own
+ * readings. The period drops to the minimum at once when successive
+ * distances differ by more than the activity threshold or when the distance
+ * is near an event threshold; while the scene is quiet it grows by
+ * 1/2^decay per sample up to the maximum. due() tells when the sensor
+ * should be sampled next, so that bus time, CPU time and power go to the
+ * sensors which see motion. rate() reports the effective sample rate,
+ * measured from the actual sample times.
+ * The rate controller is available in every tier.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_RATE_H
+#define DYP_R01CW_RATE_H
+
+#include <stdint.h>
+
+/*!
+ * @brief Motion-adaptive sample rate controller for one sensor
+ */
+class DYP_R01CW_Rate {
+public:
+    DYP_R01CW_Rate();
+
+    /*!
+     * @brief Set the period bounds
+     * @param minPeriod Period with activity in milliseconds (default DYP_R01CW_CONVERSION_TIME_MS)
+     * @param maxPeriod Period of a quiet scene in milliseconds (default 1000)
+     * @note maxPeriod is limited to at least minPeriod; restarts at minPeriod
+     */
+    void setBounds(uint16_t minPeriod, uint16_t maxPeriod);
+
+    /*!
+     * @brief Set the activity threshold
+     * @param change Distance change between successive samples in millimeters
+     *               which counts as motion (default 20)
+     */
+    void setActivity(uint16_t change) { _change = change; }
+
+    /*!
+     * @brief Set the event band
+     * @param threshold Event threshold in millimeters (0: disabled, default)
+     * @param margin Distances within +/- margin of the threshold are sampled at the minimum period
+     */
+    void setNear(int16_t threshold, uint16_t margin);
+
+    /*!
+     * @brief Set the decay rate
+     * @param decay The period grows by period / 2^decay per quiet sample (1...8, default 3)
+     */
+    void setDecay(uint8_t decay);
+
+    /*!
+     * @brief Restart at the minimum period
+     */
+    void reset();
+
+    /*!
+     * @brief Check if the sensor should be sampled
+     * @param now Current time in milliseconds
+     * @return true if the period since the last sample has elapsed (or no sample yet)
+     */
+    bool due(uint32_t now) const { return !_primed || (int32_t)(now - _next) >= 0; }
+
+    /*!
+     * @brief Add a valid distance and schedule the next sample
+     * @param distance Distance in millimeters
+     * @param time Time of the sample in milliseconds
+     */
+    void update(int16_t distance, uint32_t time);
+
+    /*!
+     * @brief Schedule the next sample after an invalid sample (period unchanged)
+     * @param time Time of the sample in milliseconds
+     */
+    void skip(uint32_t time);
+
+    /*!
+     * @brief Get the current sample period
+     * @return Period in milliseconds
+     */
+    uint16_t period() const { return _period; }
+
+    /*!
+     * @brief Get the effective sample rate
+     * @return Rate in millihertz, averaged over the recent sample intervals (0 before two samples)
+     */
+    uint32_t rate() const;
+
+private:
+    /*!
+     * @brief Record a sample time
+     * @param time Time of the sample in milliseconds
+     */
+    void stamp(uint32_t time);
+
+    uint32_t _next;       ///< Time of the next sample
+    uint32_t _last;       ///< Time of the last sample
+    uint32_t _interval;   ///< Average sample interval (Q4)
+    int16_t _distance;    ///< Last distance
+    int16_t _threshold;   ///< Event threshold
+    uint16_t _margin;     ///< Event band half width
+    uint16_t _change;     ///< Activity threshold
+    uint16_t _min;        ///< Minimum period
+    uint16_t _max;        ///< Maximum period
+    uint16_t _period;     ///< Current period
+    uint8_t _decay;       ///< Decay shift
+    bool _primed;         ///< A sample has been recorded
+    bool _hasDistance;    ///< _distance is valid
+};
+
+#endif // DYP_R01CW_RATE_H
@@ -0,0 +1,52 @@
+/*!
+ * @file DYP_R01CW_Registers.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library for Arduino
+ *
+ * @section intro_sec Introduction
+ *
+ * Register map, commands and address rules of the DYP-R01CW sensor.
+ * This header does not depend on Arduino.h and is shared by all backends.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_REGISTERS_H
+#define DYP_R01CW_REGISTERS_H
+
+#include <stdint.h>
+
+// Default I2C address for DYP-R01CW sensor (8-bit format)
+// Note: This is the library default; adjust if your sensor is configured differently
+#define DYP_R01CW_DEFAULT_ADDR 0xE8
+
+// Sensor registers
+#define DYP_R01CW_VERSION_REG 0x00
+#define DYP_R01CW_COMMAND_REG 0x10
+#define DYP_R01CW_DATA_REG 0x02
+#define DYP_R01CW_SLAVE_ADDR_REG 0x05
+
+// Commands
+#define DYP_R01CW_MEASURE_COMMAND 0xB0
+#define DYP_R01CW_RESTART_COMMAND_1 0x5A
+#define DYP_R01CW_RESTART_COMMAND_2 0xA5
+
+// Measurement conversion time in milliseconds
+#define DYP_R01CW_CONVERSION_TIME_MS 50
+
+/*!
+ * @brief Check if an 8-bit I2C address is supported by the sensor
+ * @param addr 8-bit I2C address
+ * @return true for even addresses from 0xD0 to 0xFE, excluding 0xF0-0xF6
+ */
+constexpr bool DYP_R01CW_isValidAddress(uint8_t addr) {
+    return addr >= 0xD0 && (addr & 0x01) == 0 && !(addr >= 0xF0 && addr <= 0xF6);
+}
+
+#endif // DYP_R01CW_REGISTERS_H
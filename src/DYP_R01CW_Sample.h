@@ -0,0 +1,44 @@
+/*!
+ * @file DYP_R01CW_Sample.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library for Arduino
+ *
+ * @section intro_sec Introduction
+ *
+ * Platform-independent sample record shared by the Arduino library and the
+ * host-side tools. This header does not depend on Arduino.h.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_SAMPLE_H
+#define DYP_R01CW_SAMPLE_H
+
+#include <stdint.h>
+
+// Sample status codes
+#define DYP_R01CW_STATUS_OK 0          ///< Valid measurement
+#define DYP_R01CW_STATUS_BUS_ERROR 1   ///< Command or register pointer write failed
+#define DYP_R01CW_STATUS_SHORT_READ 2  ///< Sensor returned fewer than 2 bytes
+#define DYP_R01CW_STATUS_INVALID 3     ///< Sensor returned 0xFFFF (no valid target)
+
+// Raw DATA_REG value reported by the sensor if no valid measurement is available
+#define DYP_R01CW_RAW_INVALID 0xFFFF
+
+/*!
+ * @brief Single distance sample as read from the sensor
+ */
+struct DYP_R01CW_Sample {
+    uint32_t timestamp;  ///< Time of the read in milliseconds (millis())
+    uint16_t raw;        ///< Raw DATA_REG value in millimeters (offset not applied)
+    uint8_t addr;        ///< I2C address of the sensor in 8-bit format
+    uint8_t status;      ///< Sample status (DYP_R01CW_STATUS_*)
+};
+
+#endif // DYP_R01CW_SAMPLE_H
@@ -0,0 +1,284 @@
+/*!
+ * @file DYP_R01CW_SensorSet.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - sensor set
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_SensorSet keeps the state of many sensors as a structure of
+ * arrays: addresses, offsets, last raw values, timestamps, status, health
+ * and filter state are stored in separate arrays indexed by channel.
+ * A sweep (trigger all, read all), the filter pass and reporting each walk
+ * over contiguous memory, and the arrays can be handed to multi-channel
+ * processing directly (see raws(), distances()).
+ *
+ * The set is platform-independent: bus access goes through the protocol
+ * core (DYP_R01CW_Protocol.h), e.g. with DYP_R01CW_WireBus on Arduino or
+ * DYP_R01CW_LinuxBus on Linux. The caller waits DYP_R01CW_CONVERSION_TIME_MS
+ * between trigger() and read() and provides the timestamp.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_SENSORSET_H
+#define DYP_R01CW_SENSORSET_H
+
+#include <stdint.h>
+
+#include "DYP_R01CW_Config.h"
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_Protocol.h"
+#include "DYP_R01CW_Registers.h"
+#include "DYP_R01CW_Sample.h"
+
+// Consecutive failed samples after which a channel is reported unhealthy
+#define DYP_R01CW_SENSORSET_FAIL_LIMIT 3
+
+/*!
+ * @brief Set of sensors with structure-of-arrays state
+ * @tparam CAPACITY Maximum number of sensors (channels)
+ */
+template <uint8_t CAPACITY> class DYP_R01CW_SensorSet {
+    static_assert(CAPACITY > 0 && CAPACITY <= 127, "DYP_R01CW_SensorSet: capacity must be 1...127");
+
+public:
+    static const uint8_t capacity = CAPACITY;  ///< Maximum number of channels
+
+    DYP_R01CW_SensorSet() {
+        _count = 0;
+#if DYP_R01CW_HAS_FILTERS
+        _emaShift = 0;
+#endif
+    }
+
+    /*!
+     * @brief Add a sensor
+     * @param addr I2C address of the sensor in 8-bit format
+     * @param offset Offset in millimeters added to distance readings
+     * @return Channel index, or -1 if the set is full or the address is not supported
+     */
+    int8_t add(uint8_t addr, int16_t offset = 0) {
+        if (_count >= CAPACITY || !DYP_R01CW_isValidAddress(addr)) {
+            return -1;
+        }
+        uint8_t i = _count++;
+        _addr[i] = addr >> 1;
+        _offset[i] = offset;
+        clear(i);
+        return (int8_t)i;
+    }
+
+    /*!
+     * @brief Clear samples, health and filter state of all channels
+     */
+    void reset() {
+        for (uint8_t i = 0; i < _count; i++) {
+            clear(i);
+        }
+    }
+
+    /*!
+     * @brief Trigger measurements of all sensors
+     * @tparam BUS Bus transport (see DYP_R01CW_Protocol.h)
+     * @param bus Bus transport
+     * @return Number of acknowledged triggers
+     */
+    template <class BUS> uint8_t trigger(BUS &bus) {
+        uint8_t acked = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            acked += (DYP_R01CW_Protocol<BUS>::template command<DYP_R01CW_MeasureCommand>(bus, _addr[i]) == 0);
+        }
+        return acked;
+    }
+
+    /*!
+     * @brief Read the results of all sensors
+     * @tparam BUS Bus transport (see DYP_R01CW_Protocol.h)
+     * @param bus Bus transport
+     * @param timestamp Timestamp stored with the samples (e.g. millis())
+     * @return Number of valid samples
+     */
+    template <class BUS> uint8_t read(BUS &bus, uint32_t timestamp) {
+        uint8_t valid = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            uint16_t raw = DYP_R01CW_RAW_INVALID;
+            uint8_t status = DYP_R01CW_Protocol<BUS>::template read<DYP_R01CW_DataRegister>(bus, _addr[i], raw);
+            if (status == DYP_R01CW_STATUS_OK && raw == DYP_R01CW_RAW_INVALID) {
+                status = DYP_R01CW_STATUS_INVALID;
+            }
+            valid += update(i, raw, status, timestamp);
+        }
+        return valid;
+    }
+
+    /*!
+     * @brief Store a sample read elsewhere (e.g. DYP_R01CW_LinuxBus::readAll())
+     * @param index Channel index
+     * @param sample Sample
+     * @return true if the sample is valid, false otherwise
+     */
+    bool store(uint8_t index, const DYP_R01CW_Sample &sample) {
+        return update(index, sample.raw, sample.status, sample.timestamp);
+    }
+
+#if DYP_R01CW_HAS_FILTERS
+    /*!
+     * @brief Set the EMA smoothing shift of all channels (0: disabled)
+     * @param shift Smoothing shift (max. 15)
+     */
+    void setEmaShift(uint8_t shift) {
+        _emaShift = (shift > 15) ? 15 : shift;
+        for (uint8_t i = 0; i < _count; i++) {
+            _primed[i] = false;
+        }
+    }
+
+    /*!
+     * @brief Filter pass: offset and EMA for all channels with a valid sample
+     * @note Channels with an invalid sample keep their distance and filter state
+     *       (as DYP_R01CW_Pipeline); same arithmetic as DYP_R01CW_EmaFilter (DYP_R01CW_emaStep())
+     */
+    void filter() {
+        const uint8_t shift = _emaShift;
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_status[i] != DYP_R01CW_STATUS_OK) {
+                continue;
+            }
+            int16_t value = DYP_R01CW_applyOffset(_raw[i], _offset[i]);
+            _acc[i] = DYP_R01CW_emaStep(_acc[i], value, shift, _primed[i]);
+            _primed[i] = true;
+            _distance[i] = (int16_t)(_acc[i] >> shift);
+        }
+    }
+#endif
+
+    /*!
+     * @brief Get the number of channels
+     * @return Number of channels
+     */
+    uint8_t size() const { return _count; }
+
+    /*!
+     * @brief Get a channel's sample
+     * @param index Channel index
+     * @param sample Sample to fill
+     */
+    void sample(uint8_t index, DYP_R01CW_Sample &sample) const {
+        sample.timestamp = _timestamp[index];
+        sample.raw = _raw[index];
+        sample.addr = _addr[index] << 1;
+        sample.status = _status[index];
+    }
+
+    /*!
+     * @brief Get a channel's I2C address
+     * @param index Channel index
+     * @return I2C address in 8-bit format
+     */
+    uint8_t address(uint8_t index) const { return _addr[index] << 1; }
+
+    /*!
+     * @brief Get a channel's distance offset
+     * @param index Channel index
+     * @return Offset in millimeters
+     */
+    int16_t offset(uint8_t index) const { return _offset[index]; }
+
+    /*!
+     * @brief Set a channel's distance offset
+     * @param index Channel index
+     * @param offset Offset in millimeters
+     */
+    void setOffset(uint8_t index, int16_t offset) { _offset[index] = offset; }
+
+    /*!
+     * @brief Get a channel's sample status
+     * @param index Channel index
+     * @return DYP_R01CW_STATUS_*
+     */
+    uint8_t status(uint8_t index) const { return _status[index]; }
+
+    /*!
+     * @brief Get a channel's number of consecutive failed samples
+     * @param index Channel index
+     * @return Failed samples since the last valid one (saturates at 255)
+     */
+    uint8_t failures(uint8_t index) const { return _failures[index]; }
+
+    /*!
+     * @brief Check a channel's health
+     * @param index Channel index
+     * @return true if fewer than DYP_R01CW_SENSORSET_FAIL_LIMIT consecutive samples failed
+     */
+    bool healthy(uint8_t index) const { return _failures[index] < DYP_R01CW_SENSORSET_FAIL_LIMIT; }
+
+    /*!
+     * @brief Get the raw DATA_REG values of all channels
+     * @return Array of size() values (DYP_R01CW_RAW_INVALID if not valid)
+     */
+    const uint16_t *raws() const { return _raw; }
+
+    /*!
+     * @brief Get the sample timestamps of all channels
+     * @return Array of size() timestamps
+     */
+    const uint32_t *timestamps() const { return _timestamp; }
+
+#if DYP_R01CW_HAS_FILTERS
+    /*!
+     * @brief Get the filtered distances of all channels (updated by filter())
+     * @return Array of size() distances in millimeters
+     */
+    const int16_t *distances() const { return _distance; }
+#endif
+
+private:
+    // Clear sample, health and filter state of a channel
+    void clear(uint8_t i) {
+        _raw[i] = DYP_R01CW_RAW_INVALID;
+        _timestamp[i] = 0;
+        _status[i] = DYP_R01CW_STATUS_BUS_ERROR;
+        _failures[i] = 0;
+#if DYP_R01CW_HAS_FILTERS
+        _distance[i] = 0;
+        _acc[i] = 0;
+        _primed[i] = false;
+#endif
+    }
+
+    // Store a sample and update health
+    bool update(uint8_t i, uint16_t raw, uint8_t status, uint32_t timestamp) {
+        bool valid = (status == DYP_R01CW_STATUS_OK);
+        _raw[i] = valid ? raw : DYP_R01CW_RAW_INVALID;
+        _status[i] = status;
+        _timestamp[i] = timestamp;
+        if (valid) {
+            _failures[i] = 0;
+        } else if (_failures[i] < 255) {
+            _failures[i]++;
+        }
+        return valid;
+    }
+
+    uint8_t _addr[CAPACITY];        ///< I2C addresses (7-bit)
+    int16_t _offset[CAPACITY];      ///< Distance offsets in millimeters
+    uint16_t _raw[CAPACITY];        ///< Last raw DATA_REG values
+    uint32_t _timestamp[CAPACITY];  ///< Last sample timestamps
+    uint8_t _status[CAPACITY];      ///< Last sample status
+    uint8_t _failures[CAPACITY];    ///< Consecutive failed samples
+#if DYP_R01CW_HAS_FILTERS
+    int16_t _distance[CAPACITY];    ///< Filtered distances in millimeters
+    int32_t _acc[CAPACITY];         ///< EMA accumulators (value scaled by 2^shift)
+    bool _primed[CAPACITY];         ///< EMA accumulator holds a value
+    uint8_t _emaShift;              ///< EMA smoothing shift
+#endif
+    uint8_t _count;                 ///< Number of channels
+};
+
+#endif // DYP_R01CW_SENSORSET_H
@@ -0,0 +1,162 @@
+/*!
+ * @file DYP_R01CW_Static.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - compile-time addressed variant
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Static takes the I2C address, the bus and the distance offset
+ * as template parameters. All methods are static: objects of the class
+ * carry no state (no RAM per sensor), the address and the offset are
+ * compile-time constants, and there is no runtime check for a missing bus.
+ * Invalid addresses are rejected at compile time.
+ *
+ * The bus transactions are identical to those of DYP_R01CW (both use
+ * DYP_R01CW_WireProtocol).
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_STATIC_H
+#define DYP_R01CW_STATIC_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "DYP_R01CW_Processing.h"
+#include "DYP_R01CW_Registers.h"
+#include "DYP_R01CW_Sample.h"
+#include "DYP_R01CW_WireBus.h"
+
+/*!
+ * @brief Compile-time addressed DYP-R01CW sensor
+ * @tparam ADDR I2C address of the sensor in 8-bit format
+ * @tparam WIRE TwoWire object the sensor is connected to
+ * @tparam OFFSET Offset in millimeters added to distance readings
+ */
+template <uint8_t ADDR = DYP_R01CW_DEFAULT_ADDR, TwoWire &WIRE = Wire, int16_t OFFSET = 0>
+class DYP_R01CW_Static {
+    static_assert(DYP_R01CW_isValidAddress(ADDR), "DYP_R01CW_Static: unsupported I2C address");
+
+public:
+    static const uint8_t address = ADDR;   ///< I2C address in 8-bit format
+    static const int16_t offset = OFFSET;  ///< Distance offset in millimeters
+
+    /*!
+     * @brief Initialize the sensor
+     * @return true if initialization was successful, false otherwise
+     * @note Calls WIRE.begin() only for the default Wire object (as DYP_R01CW::begin())
+     */
+    static bool begin() {
+        if (&WIRE == &Wire) {
+            WIRE.begin();
+        }
+        return readSoftwareVersion() != 0;
+    }
+
+    /*!
+     * @brief Read distance measurement from sensor
+     * @return Distance in millimeters including OFFSET, or -1 if read failed
+     */
+    static int16_t readDistance() {
+        DYP_R01CW_Sample sample;
+        if (!readSample(sample)) {
+            return -1;
+        }
+        return DYP_R01CW_applyOffset(sample.raw, OFFSET);
+    }
+
+    /*!
+     * @brief Read a raw distance sample from the sensor
+     * @param sample Sample to fill with timestamp, raw value, address and status
+     * @return true if the sample is valid, false otherwise (see sample.status)
+     */
+    static bool readSample(DYP_R01CW_Sample &sample) {
+        sample.addr = ADDR;
+        sample.raw = DYP_R01CW_RAW_INVALID;
+        sample.status = DYP_R01CW_STATUS_BUS_ERROR;
+        sample.timestamp = millis();
+
+        DYP_R01CW_WireBus bus(WIRE);
+        if (DYP_R01CW_WireProtocol::command<DYP_R01CW_MeasureCommand>(bus, ADDR >> 1) != 0) {
+            return false;
+        }
+
+        delay(DYP_R01CW_CONVERSION_TIME_MS);
+
+        uint8_t error = DYP_R01CW_WireProtocol::select<DYP_R01CW_DataRegister>(bus, ADDR >> 1);
+        sample.timestamp = millis();
+        if (error != 0) {
+            return false;
+        }
+
+        sample.status = DYP_R01CW_WireProtocol::fetch<DYP_R01CW_DataRegister>(bus, ADDR >> 1, sample.raw);
+        if (sample.status != DYP_R01CW_STATUS_OK) {
+            return false;
+        }
+        if (sample.raw == DYP_R01CW_RAW_INVALID) {
+            sample.status = DYP_R01CW_STATUS_INVALID;
+            return false;
+        }
+        sample.status = DYP_R01CW_STATUS_OK;
+        return true;
+    }
+
+    /*!
+     * @brief Check if sensor is connected and responding
+     * @return true if sensor is connected, false otherwise
+     */
+    static bool isConnected() {
+        DYP_R01CW_WireBus bus(WIRE);
+        return DYP_R01CW_WireProtocol::probe(bus, ADDR >> 1) == 0;
+    }
+
+    /*!
+     * @brief Read software version number from the sensor
+     * @return Software version number (16-bit), or 0 if read failed
+     */
+    static uint16_t readSoftwareVersion() {
+        DYP_R01CW_WireBus bus(WIRE);
+        uint16_t version;
+        if (DYP_R01CW_WireProtocol::read<DYP_R01CW_VersionRegister>(bus, ADDR >> 1, version) != DYP_R01CW_STATUS_OK) {
+            return 0;
+        }
+        return version;
+    }
+
+    /*!
+     * @brief Change the I2C address of the sensor
+     * @tparam NEW_ADDR New I2C address in 8-bit format (validated at compile time)
+     * @return true if successful, false otherwise
+     * @note Afterwards, access the sensor with DYP_R01CW_Static<NEW_ADDR, WIRE, OFFSET>
+     *       (see Rebind)
+     */
+    template <uint8_t NEW_ADDR> static bool setAddress() {
+        static_assert(DYP_R01CW_isValidAddress(NEW_ADDR), "DYP_R01CW_Static: unsupported I2C address");
+        DYP_R01CW_WireBus bus(WIRE);
+        return DYP_R01CW_WireProtocol::write<DYP_R01CW_SlaveAddrRegister>(bus, ADDR >> 1, NEW_ADDR) == 0;
+    }
+
+    /*!
+     * @brief Restart the sensor
+     * @return true if the command was sent successfully, false otherwise
+     */
+    static bool restart() {
+        DYP_R01CW_WireBus bus(WIRE);
+        return DYP_R01CW_WireProtocol::command<DYP_R01CW_RestartCommand>(bus, ADDR >> 1) == 0;
+    }
+
+    /*!
+     * @brief Same sensor type with another address
+     * @tparam NEW_ADDR I2C address in 8-bit format
+     */
+    template <uint8_t NEW_ADDR> using Rebind = DYP_R01CW_Static<NEW_ADDR, WIRE, OFFSET>;
+};
+
+#endif // DYP_R01CW_STATIC_H
@@ -0,0 +1,182 @@
+/*!
+ * @file DYP_R01CW_Tank.cpp
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - tank level to volume
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#include <math.h>
+
+#include "DYP_R01CW_Tank.h"
+
+// Largest volume representable in the table (milliliters)
+#define DYP_R01CW_TANK_VOLUME_MAX 4294967295.0
+
+static const double pi = 3.14159265358979323846;
+
+/*!
+ * @brief Store a generated point
+ * @param points Table
+ * @param i Point index
+ * @param level Level in millimeters
+ * @param volume Volume in cubic millimeters
+ * @return true if the volume fits into the table
+ */
+static bool storePoint(DYP_R01CW_TankPoint *points, uint8_t i, uint16_t level, double volume) {
+    double ml = volume / 1000.0 + 0.5;
+    if (ml > DYP_R01CW_TANK_VOLUME_MAX) {
+        return false;
+    }
+    points[i].level = level;
+    points[i].volume = (ml > 0) ? (uint32_t)ml : 0;
+    // Keep the table monotonic despite rounding
+    if (i > 0 && points[i].volume < points[i - 1].volume) {
+        points[i].volume = points[i - 1].volume;
+    }
+    return true;
+}
+
+/*!
+ * @brief Get the level of a generated point
+ * @param i Point index
+ * @param count Number of points
+ * @param height Full level in millimeters
+ * @return Level in millimeters (equally spaced, rounded)
+ */
+static uint16_t pointLevel(uint8_t i, uint8_t count, uint16_t height) {
+    return (uint16_t)(((uint32_t)height * i + (count - 1) / 2) / (count - 1));
+}
+
+/*!
+ * @brief Generate a table for a horizontal cylindrical tank
+ */
+bool DYP_R01CW_tankHorizontalCylinder(DYP_R01CW_TankPoint *points, uint8_t count, uint16_t diameter,
+                                      uint16_t length) {
+    if (points == nullptr || count < 2 || diameter < count - 1) {
+        return false;
+    }
+    double r = diameter / 2.0;
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t level = pointLevel(i, count, diameter);
+        double h = level;
+        double c = r - h;
+        double w = 2.0 * r * h - h * h;
+        // Circular segment area below the level
+        double area = r * r * acos(c / r) - c * sqrt(w > 0 ? w : 0);
+        if (!storePoint(points, i, level, area * length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * @brief Generate a table for a vertical conical tank
+ */
+bool DYP_R01CW_tankCone(DYP_R01CW_TankPoint *points, uint8_t count, uint16_t height, uint16_t bottomDiameter,
+                        uint16_t topDiameter) {
+    if (points == nullptr || count < 2 || height < count - 1) {
+        return false;
+    }
+    double r0 = bottomDiameter / 2.0;
+    double r1 = topDiameter / 2.0;
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t level = pointLevel(i, count, height);
+        double h = level;
+        double r = r0 + (r1 - r0) * h / height;
+        // Frustum between the bottom and the level
+        if (!storePoint(points, i, level, pi * h / 3.0 * (r0 * r0 + r0 * r + r * r))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * @brief Constructor (no table, mount distance 0)
+ */
+DYP_R01CW_Tank::DYP_R01CW_Tank() {
+    _table = nullptr;
+    _count = 0;
+    _mount = 0;
+}
+
+/*!
+ * @brief Set the lookup table
+ * @param table Table (not copied; must stay valid)
+ * @param count Number of points
+ * @return true if the table is valid
+ */
+bool DYP_R01CW_Tank::begin(const DYP_R01CW_TankPoint *table, uint8_t count) {
+    _table = nullptr;
+    _count = 0;
+    if (table == nullptr || count < 2) {
+        return false;
+    }
+    for (uint8_t i = 1; i < count; i++) {
+        if (table[i].level <= table[i - 1].level || table[i].volume < table[i - 1].volume) {
+            return false;
+        }
+    }
+    _table = table;
+    _count = count;
+    return true;
+}
+
+/*!
+ * @brief Get the volume at a level
+ * @param level Liquid level in millimeters
+ * @return Volume in milliliters
+ */
+uint32_t DYP_R01CW_Tank::volume(int32_t level) const {
+    if (_count == 0) {
+        return 0;
+    }
+    if (level <= _table[0].level) {
+        return _table[0].volume;
+    }
+    if (level >= _table[_count - 1].level) {
+        return _table[_count - 1].volume;
+    }
+
+    // Find the segment with table[lo].level <= level < table[hi].level
+    uint8_t lo = 0;
+    uint8_t hi = _count - 1;
+    while (hi - lo > 1) {
+        uint8_t mid = (uint8_t)((lo + hi) / 2);
+        if (_table[mid].level <= level) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const DYP_R01CW_TankPoint &a = _table[lo];
+    const DYP_R01CW_TankPoint &b = _table[hi];
+    uint32_t dv = b.volume - a.volume;
+    uint16_t dh = b.level - a.level;
+    uint16_t x = (uint16_t)(level - a.level);
+    if (x == 0) {
+        return a.volume;
+    }
+    // 32-bit arithmetic unless the product overflows (slow 64-bit division on 8-bit MCUs)
+    if (dv <= (4294967295UL - dh / 2) / x) {
+        return a.volume + (dv * x + dh / 2) / dh;
+    }
+    return a.volume + (uint32_t)(((uint64_t)dv * x + dh / 2) / dh);
+}
+
+/*!
+ * @brief Get the volume of the full tank
+ * @return Volume at the highest table level in milliliters
+ */
+uint32_t DYP_R01CW_Tank::capacity() const {
+    return (_count == 0) ? 0 : _table[_count - 1].volume;
+}
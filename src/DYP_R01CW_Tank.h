@@ -0,0 +1,123 @@
+/*!
+ * @file DYP_R01CW_Tank.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - tank level to volume
+ *
+ * @section intro_sec Introduction
+ *
+ * DYP_R01CW_Tank converts liquid levels into volumes with a lookup table
+ * of (level, volume) points: a binary search finds the table segment and
+ * the volume is interpolated linearly within it. The lookup is integer-only.
+ *
+ * Tables can be written by hand (e.g. from a tank calibration chart) or
+ * generated once at setup time from the tank geometry:
+ *
+ * - DYP_R01CW_tankHorizontalCylinder(): horizontal cylinder (flat ends)
+ * - DYP_R01CW_tankCone(): vertical cone or frustum (cone at the bottom)
+ *
+ * The sensor is mounted above the liquid; with the mount distance (sensor
+ * to tank bottom) set, volumes can be looked up by the measured distance.
+ * The tank stage is available in every tier.
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_TANK_H
+#define DYP_R01CW_TANK_H
+
+#include <stdint.h>
+
+/*!
+ * @brief Lookup table point
+ */
+struct DYP_R01CW_TankPoint {
+    uint16_t level;   ///< Liquid level in millimeters
+    uint32_t volume;  ///< Volume in milliliters
+};
+
+/*!
+ * @brief Generate a table for a horizontal cylindrical tank
+ * @param points Table to fill (count points)
+ * @param count Number of points (2...255), equally spaced from empty to full
+ * @param diameter Inner diameter in millimeters
+ * @param length Inner length in millimeters
+ * @return true if successful, false if a parameter is out of range
+ * @note Uses floating point; intended to be called once at setup time
+ */
+bool DYP_R01CW_tankHorizontalCylinder(DYP_R01CW_TankPoint *points, uint8_t count, uint16_t diameter,
+                                      uint16_t length);
+
+/*!
+ * @brief Generate a table for a vertical conical tank (cone or frustum, narrow end at the bottom)
+ * @param points Table to fill (count points)
+ * @param count Number of points (2...255), equally spaced from empty to full
+ * @param height Inner height in millimeters
+ * @param bottomDiameter Inner diameter at the bottom in millimeters (0: cone)
+ * @param topDiameter Inner diameter at the top in millimeters
+ * @return true if successful, false if a parameter is out of range
+ * @note Uses floating point; intended to be called once at setup time
+ */
+bool DYP_R01CW_tankCone(DYP_R01CW_TankPoint *points, uint8_t count, uint16_t height, uint16_t bottomDiameter,
+                        uint16_t topDiameter);
+
+/*!
+ * @brief Tank level to volume conversion
+ */
+class DYP_R01CW_Tank {
+public:
+    DYP_R01CW_Tank();
+
+    /*!
+     * @brief Set the lookup table
+     * @param table Table (not copied; must stay valid)
+     * @param count Number of points (at least 2)
+     * @return true if the table is valid (levels strictly increasing, volumes not decreasing)
+     */
+    bool begin(const DYP_R01CW_TankPoint *table, uint8_t count);
+
+    /*!
+     * @brief Set the mount distance
+     * @param distance Distance from the sensor to the tank bottom (level 0) in millimeters
+     */
+    void setMountDistance(uint16_t distance) { _mount = distance; }
+
+    /*!
+     * @brief Get the volume at a level
+     * @param level Liquid level in millimeters
+     * @return Volume in milliliters (clamped to the table range), 0 without table
+     */
+    uint32_t volume(int32_t level) const;
+
+    /*!
+     * @brief Get the volume at a measured distance
+     * @param distance Distance from the sensor to the liquid surface in millimeters
+     * @return Volume in milliliters (level = mount distance - distance)
+     */
+    uint32_t volumeFromDistance(int16_t distance) const { return volume((int32_t)_mount - distance); }
+
+    /*!
+     * @brief Get the volume of the full tank
+     * @return Volume at the highest table level in milliliters
+     */
+    uint32_t capacity() const;
+
+    /*!
+     * @brief Convert milliliters to liters
+     * @param ml Volume in milliliters
+     * @return Volume in liters (rounded)
+     */
+    static uint32_t liters(uint32_t ml) { return ml / 1000 + (ml % 1000 >= 500); }
+
+private:
+    const DYP_R01CW_TankPoint *_table;  ///< Lookup table
+    uint8_t _count;                     ///< Number of points
+    uint16_t _mount;                    ///< Mount distance in millimeters
+};
+
+#endif // DYP_R01CW_TANK_H
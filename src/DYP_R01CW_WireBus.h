@@ -0,0 +1,78 @@
+/*!
+ * @file DYP_R01CW_WireBus.h
+ *
+ * DYP-R01CW / DFRobot SEN0590 Laser Ranging Sensor Library - Wire bus transport
+ *
+ * @section intro_sec Introduction
+ *
+ * Bus transport for DYP_R01CW_Protocol on an Arduino TwoWire object.
+ * Register reads are issued as a pointer write with stop condition followed
+ * by a read (not all Wire implementations support a repeated start).
+ *
+ * @section author Author
+ *
+ * Written by Matthias Prinke
+ *
+ * @section license License
+ *
+ * MIT License
+ */
+
+#ifndef DYP_R01CW_WIREBUS_H
+#define DYP_R01CW_WIREBUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "DYP_R01CW_Protocol.h"
+
+/*!
+ * @brief Wire bus transport for DYP_R01CW_Protocol
+ */
+class DYP_R01CW_WireBus {
+public:
+    static constexpr bool combined = false;  ///< No combined write/read transfer
+
+    /*!
+     * @brief Constructor
+     * @param wire TwoWire object
+     */
+    explicit DYP_R01CW_WireBus(TwoWire &wire) : _wire(wire) {}
+
+    /*!
+     * @brief Write transfer
+     * @param addr 7-bit I2C address
+     * @param data Data bytes
+     * @param len Number of data bytes (0: address only)
+     * @return 0 on success, Wire error code otherwise
+     */
+    uint8_t write(uint8_t addr, const uint8_t *data, uint8_t len) {
+        _wire.beginTransmission(addr);
+        for (uint8_t i = 0; i < len; i++) {
+            _wire.write(data[i]);
+        }
+        return _wire.endTransmission();
+    }
+
+    /*!
+     * @brief Read transfer
+     * @param addr 7-bit I2C address
+     * @param buf Destination
+     * @param len Number of bytes requested
+     * @return Number of bytes received
+     */
+    uint8_t read(uint8_t addr, uint8_t *buf, uint8_t len) {
+        uint8_t n = _wire.requestFrom(addr, len);
+        for (uint8_t i = 0; i < n; i++) {
+            buf[i] = _wire.read();
+        }
+        return n;
+    }
+
+private:
+    TwoWire &_wire;  ///< TwoWire object
+};
+
+typedef DYP_R01CW_Protocol<DYP_R01CW_WireBus> DYP_R01CW_WireProtocol;  ///< Transactions on Wire
+
+#endif // DYP_R01CW_WIREBUS_H